@@ -0,0 +1,1333 @@
+/**
+ * DSP benchmark for the native equalizer
+ * Compares the original per-sample BiquadFilter loop with the cascade
+ * kernel, checks that the SIMD kernel is bit-identical to the scalar
+ * kernel, and reports how far both are from the original loop.
+ * Build: node-gyp rebuild (target dsp_bench), run: build/Release/dsp_bench
+ */
+
+#include "biquad_filter.h"
+#include "biquad_cascade.h"
+#include "equalizer.h"
+#include "graphic_equalizer.h"
+#include "parametric_equalizer.h"
+#include "audio_processor.h"
+#include "batch_processor.h"
+#include "coefficient_table.h"
+#include "convolution_engine.h"
+#include "denormals.h"
+#include "fft.h"
+#include "true_peak_limiter.h"
+#include "multiband_compressor.h"
+#include "sample_rate_converter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const double SAMPLE_RATE = 44100.0;
+static const int BLOCK_SIZE = 512;
+static const int NUM_BLOCKS = 2048;
+static const int NUM_RUNS = 5;
+
+typedef GraphicEqualizer<10> Equalizer10;
+
+static BiquadFilter::Design bandDesign(int band, double gainDB) {
+    BiquadFilter::Design d;
+    d.type = band == 0 ? BiquadFilter::LOWSHELF
+           : band == Equalizer10::NUM_BANDS - 1 ? BiquadFilter::HIGHSHELF
+           : BiquadFilter::PEAKING;
+    d.frequency = Equalizer10::Layout::FREQUENCIES[band];
+    d.sampleRate = SAMPLE_RATE;
+    d.Q = 1.0;
+    d.gainDB = gainDB;
+    return d;
+}
+
+// The original Direct Form I BiquadFilter::process, kept as the reference
+struct LegacyBiquad {
+    double a1, a2, b0, b1, b2;
+    double x1, x2, y1, y2;
+
+    LegacyBiquad(const BiquadFilter::Coefficients& c)
+        : a1(c.a1), a2(c.a2), b0(c.b0), b1(c.b1), b2(c.b2),
+          x1(0), x2(0), y1(0), y2(0) {}
+
+#if defined(__GNUC__)
+    __attribute__((noinline))
+#elif defined(_MSC_VER)
+    __declspec(noinline)
+#endif
+    double process(double input) {
+        double output = b0 * input + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        x2 = x1;
+        x1 = input;
+        y2 = y1;
+        y1 = output;
+        return output;
+    }
+};
+
+// The pre-cascade Equalizer::processStereo, kept as the reference
+class LegacyEqualizer {
+public:
+    LegacyEqualizer(const double* gains) {
+        for (int i = 0; i < Equalizer10::NUM_BANDS; i++) {
+            BiquadFilter::Coefficients c = BiquadFilter::calculateCoefficients(bandDesign(i, gains[i]));
+            left.push_back(LegacyBiquad(c));
+            right.push_back(LegacyBiquad(c));
+        }
+    }
+
+    void processStereo(float* l, float* r, int n) {
+        for (int i = 0; i < n; i++) {
+            double ls = l[i];
+            double rs = r[i];
+            for (int band = 0; band < Equalizer10::NUM_BANDS; band++) {
+                ls = left[band].process(ls);
+                rs = right[band].process(rs);
+            }
+            l[i] = std::max(-1.0, std::min(1.0, ls));
+            r[i] = std::max(-1.0, std::min(1.0, rs));
+        }
+    }
+
+private:
+    std::vector<LegacyBiquad> left;
+    std::vector<LegacyBiquad> right;
+};
+
+static void fillNoise(std::vector<float>& buf, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (float& s : buf) s = dist(rng);
+}
+
+// Runs fn over NUM_BLOCKS blocks, returns best ns per stereo frame
+template <typename Fn>
+static double timeStereo(const std::vector<float>& srcL, const std::vector<float>& srcR, Fn fn) {
+    std::vector<float> l(BLOCK_SIZE), r(BLOCK_SIZE);
+    double best = 1e30;
+    for (int run = 0; run < NUM_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < NUM_BLOCKS; b++) {
+            std::memcpy(l.data(), srcL.data(), BLOCK_SIZE * sizeof(float));
+            std::memcpy(r.data(), srcR.data(), BLOCK_SIZE * sizeof(float));
+            fn(l.data(), r.data(), BLOCK_SIZE);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        best = std::min(best, ns / (double(NUM_BLOCKS) * BLOCK_SIZE));
+    }
+    return best;
+}
+
+// Same as timeStereo for one interleaved stereo buffer
+template <typename Fn>
+static double timeInterleaved(const std::vector<float>& src, Fn fn) {
+    std::vector<float> buf(src.size());
+    int frames = (int)src.size() / 2;
+    double best = 1e30;
+    for (int run = 0; run < NUM_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < NUM_BLOCKS; b++) {
+            std::memcpy(buf.data(), src.data(), src.size() * sizeof(float));
+            fn(buf.data(), frames);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        best = std::min(best, ns / (double(NUM_BLOCKS) * frames));
+    }
+    return best;
+}
+
+// Automation events must land on exactly their frame: the same result as
+// splitting the buffer by hand and calling the setter in between
+static bool checkAutomation(const double* gains) {
+    const int FRAMES = 4096;
+    std::vector<float> src(FRAMES * 2), a, b;
+    fillNoise(src, 10);
+    a = src;
+    b = src;
+
+    AudioProcessor timed, manual;
+    timed.initialize(SAMPLE_RATE, 256);
+    manual.initialize(SAMPLE_RATE, 256);
+    const int frames[4] = { 700, 1000, 1000, 3001 };       // Out of order, equal, odd
+    const int bands[4] = { 2, 7, 0, 9 };
+    for (int i = 0; i < 4; i++) {
+        AutomationEvent event = { frames[i], AutomationEvent::BAND_GAIN, bands[i], gains[bands[i]] };
+        timed.scheduleAutomation(event);
+    }
+    timed.processInterleavedStereo(a.data(), 1500 * 2);
+    timed.processInterleavedStereo(a.data() + 1500 * 2, (FRAMES - 1500) * 2);
+
+    const int splits[4] = { 700, 1000, 3001, FRAMES };
+    const int order[3][2] = { { 2, -1 }, { 7, 0 }, { 9, -1 } };
+    int pos = 0;
+    for (int k = 0; k < 4; k++) {
+        manual.processInterleavedStereo(b.data() + pos * 2, (splits[k] - pos) * 2);
+        pos = splits[k];
+        for (int j = 0; k < 3 && j < 2 && order[k][j] >= 0; j++) {
+            manual.setEQBandGain(order[k][j], gains[order[k][j]]);
+        }
+    }
+
+    bool exact = std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0 &&
+                 timed.getFramePosition() == FRAMES;
+    std::printf("  automation vs hand-split setters: %s\n", exact ? "bit-exact" : "MISMATCH");
+    return exact;
+}
+
+// A track ending: one second of noise, a one-second fade, then silence.
+// make() builds a fresh processor per run; returns the best ns per stereo
+// frame of each one-second window.
+static const int TRACK_SECONDS = 12;
+
+template <typename Make>
+static std::vector<double> timeTrackEnd(Make make) {
+    const int rate = (int)SAMPLE_RATE;
+    const int frames = TRACK_SECONDS * rate;
+    std::vector<float> srcL(frames), srcR(frames), l(frames), r(frames);
+    fillNoise(srcL, 11);
+    fillNoise(srcR, 12);
+    for (int i = rate; i < frames; i++) {
+        float fade = i < 2 * rate ? float(2 * rate - i) / rate : 0.0f;
+        srcL[i] *= fade;
+        srcR[i] *= fade;
+    }
+
+    std::vector<double> best(TRACK_SECONDS, 1e30);
+    for (int run = 0; run < NUM_RUNS; run++) {
+        auto fn = make();
+        l = srcL;
+        r = srcR;
+        std::vector<double> windowNs(TRACK_SECONDS, 0.0);
+        for (int pos = 0; pos < frames; pos += BLOCK_SIZE) {
+            int n = std::min(BLOCK_SIZE, frames - pos);
+            auto start = std::chrono::steady_clock::now();
+            fn(l.data() + pos, r.data() + pos, n);
+            auto end = std::chrono::steady_clock::now();
+            windowNs[pos / rate] += std::chrono::duration<double, std::nano>(end - start).count();
+        }
+        for (int w = 0; w < TRACK_SECONDS; w++) {
+            best[w] = std::min(best[w], windowNs[w] / rate);
+        }
+    }
+    return best;
+}
+
+template <typename Cascade>
+static void configureCascade(Cascade& cascade, const double* gains) {
+    cascade.setNumSections(Equalizer10::NUM_BANDS);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) {
+        BiquadFilter::Coefficients c = BiquadFilter::calculateCoefficients(bandDesign(i, gains[i]));
+        cascade.setSection(i, c.b0, c.b1, c.b2, c.a1, c.a2);
+    }
+}
+
+template <typename T>
+static bool checkConformance(const char* label, const double* gains, double tolerance) {
+    const int n = BLOCK_SIZE * 16;
+    std::vector<float> l(n), r(n);
+    fillNoise(l, 1);
+    fillNoise(r, 2);
+
+    std::vector<float> refL = l, refR = r;
+    LegacyEqualizer legacy(gains);
+    legacy.processStereo(refL.data(), refR.data(), n);
+
+    std::vector<float> out[2][2];
+    for (int simd = 0; simd < 2; simd++) {
+        BiquadCascade<T> cascade;
+        configureCascade(cascade, gains);
+        cascade.setSimdEnabled(simd != 0);
+
+        out[simd][0] = l;
+        out[simd][1] = r;
+        // Odd block sizes exercise state carry-over between calls
+        for (int pos = 0; pos < n; pos += 333) {
+            int len = std::min(333, n - pos);
+            cascade.processStereo(out[simd][0].data() + pos, out[simd][1].data() + pos, len);
+        }
+    }
+
+    bool exact = out[0][0] == out[1][0] && out[0][1] == out[1][1];
+    double maxError = 0.0;
+    for (int i = 0; i < n; i++) {
+        maxError = std::max(maxError, (double)std::fabs(out[0][0][i] - refL[i]));
+        maxError = std::max(maxError, (double)std::fabs(out[0][1][i] - refR[i]));
+    }
+
+    std::printf("  %-6s %-6s vs scalar: %s\n", label, BiquadCascade<T>::getKernelName(),
+                exact ? "bit-exact" : "MISMATCH");
+    std::printf("  %-6s scalar vs legacy: max |error| %.3g\n", label, maxError);
+    return exact && maxError < tolerance;
+}
+
+// Interleaved in-place path (runtime or unrolled NSections kernel) must
+// match the planar runtime path bit for bit
+template <typename T, int NSections = 0>
+static bool checkInterleaved(const char* label, const double* gains, int numChannels) {
+    const int n = BLOCK_SIZE * 4;
+    std::vector<std::vector<float>> planar(numChannels, std::vector<float>(n));
+    for (int c = 0; c < numChannels; c++) fillNoise(planar[c], 10 + c);
+
+    std::vector<float> interleaved(n * numChannels);
+    for (int i = 0; i < n; i++)
+        for (int c = 0; c < numChannels; c++) interleaved[i * numChannels + c] = planar[c][i];
+
+    BiquadCascade<T> ref;
+    BiquadCascade<T, NSections> test;
+    configureCascade(ref, gains);
+    configureCascade(test, gains);
+    ref.setSimdEnabled(false);
+
+    std::vector<float*> ptrs(numChannels);
+    for (int c = 0; c < numChannels; c++) ptrs[c] = planar[c].data();
+    ref.process(ptrs.data(), numChannels, n);
+    for (int pos = 0; pos < n; pos += 333) {
+        test.processInterleaved(interleaved.data() + pos * numChannels, numChannels, std::min(333, n - pos));
+    }
+
+    bool exact = true;
+    for (int i = 0; i < n; i++)
+        for (int c = 0; c < numChannels; c++)
+            exact = exact && interleaved[i * numChannels + c] == planar[c][i];
+    std::printf("  %-6s interleaved %dch%s vs planar scalar: %s\n", label, numChannels,
+                NSections > 0 ? ", unrolled" : "", exact ? "bit-exact" : "MISMATCH");
+    return exact;
+}
+
+// Table entries must match the direct calculation bit for bit
+static bool checkTable() {
+    int mismatches = 0;
+    for (int band = 0; band < Equalizer10::NUM_BANDS; band++) {
+        for (int step = -120; step <= 120; step++) {
+            BiquadFilter::Design design = bandDesign(band, step / 10.0);
+            BiquadFilter::Coefficients a = CoefficientTable::find(design)->lookup(design.gainDB);
+            BiquadFilter::Coefficients b = BiquadFilter::calculateCoefficients(design);
+            if (std::memcmp(&a, &b, sizeof(a)) != 0) mismatches++;
+        }
+    }
+    std::printf("  coefficient table vs calculation: %s\n", mismatches ? "MISMATCH" : "bit-exact");
+    return mismatches == 0;
+}
+
+// The parametric EQ on the default layout must match the graphic EQ, and
+// its execution plan must hold only the bands that are not flat
+static bool checkParametric(const double* gains) {
+    Equalizer10 graphic(SAMPLE_RATE);
+    ParametricEqualizer parametric(SAMPLE_RATE);
+    graphic.setSmoothingTime(0);
+    parametric.setSmoothingTime(0);
+    std::vector<float> l1(4096), r1(4096);
+    fillNoise(l1, 7);
+    fillNoise(r1, 8);
+    std::vector<float> l2 = l1, r2 = r1;
+
+    // Flat start: the graphic EQ runs identity sections, the parametric
+    // EQ none; sections inserted later start from the same history
+    graphic.processStereo(l1.data(), r1.data(), 64);
+    parametric.processStereo(l2.data(), r2.data(), 64);
+    int flatSections = parametric.getActiveSectionCount();
+
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) {
+        graphic.setBandGain(i, gains[i]);
+        parametric.setBandGain(i, gains[i]);
+    }
+    graphic.processStereo(l1.data() + 64, r1.data() + 64, 4032);
+    parametric.processStereo(l2.data() + 64, r2.data() + 64, 4032);
+    bool exact = true;
+    for (int i = 0; i < 4096; i++) {
+        if (l1[i] != l2[i] || r1[i] != r2[i]) exact = false;
+    }
+    int activeSections = parametric.getActiveSectionCount();
+
+    parametric.reset();
+    parametric.processStereo(l2.data(), r2.data(), 64);
+    bool pruned = flatSections == 0 && activeSections == Equalizer10::NUM_BANDS &&
+                  parametric.getActiveSectionCount() == 0;
+    std::printf("  parametric vs graphic (10-band): %s, plan %d/%d/%d sections (flat/rock/reset) %s\n",
+                exact ? "bit-exact" : "MISMATCH", flatSections, activeSections,
+                parametric.getActiveSectionCount(), pruned ? "ok" : "WRONG");
+    return exact && pruned;
+}
+
+// A flat EQ must leave samples untouched, also after a band has ramped
+// up and back down to 0 dB
+static bool checkBypass() {
+    Equalizer10 eq(SAMPLE_RATE);
+    std::vector<float> src(8192), l(8192), r(8192);
+    fillNoise(src, 9);
+    l = src;
+    r = src;
+    eq.processStereo(l.data(), r.data(), 2048);
+    bool before = std::memcmp(l.data(), src.data(), 2048 * sizeof(float)) == 0;
+
+    eq.setBandGain(5, 6.0);
+    eq.processStereo(l.data() + 2048, r.data() + 2048, 2048);
+    eq.setBandGain(5, 0.0);
+    eq.processStereo(l.data() + 4096, r.data() + 4096, 2048);
+    eq.processStereo(l.data() + 6144, r.data() + 6144, 2048);
+    bool after = std::memcmp(l.data() + 6144, src.data() + 6144, 2048 * sizeof(float)) == 0;
+
+    std::printf("  flat bypass: %s before, %s after a 6 dB ramp, %d sections\n",
+                before ? "untouched" : "MODIFIED", after ? "untouched" : "MODIFIED",
+                eq.getActiveSectionCount());
+    return before && after && eq.getActiveSectionCount() == 0;
+}
+
+// Partitioned convolution must match direct convolution, latency frames
+// later, for a stereo IR spanning several tiers and ragged call sizes.
+// The linear-phase EQ must be symmetric and follow the IIR magnitude.
+static bool checkConvolution(const double* gains) {
+    const int LATENCY = 64;
+    const int TAPS = 6000;
+    const int FRAMES = 16384;
+    ConvolutionEngine engine;
+    engine.configure(LATENCY, TAPS);
+    std::vector<float> irL(TAPS), irR(TAPS), src(FRAMES * 2);
+    fillNoise(irL, 11);
+    fillNoise(irR, 12);
+    fillNoise(src, 13);
+    for (int i = 0; i < TAPS; i++) {
+        float decay = 0.05f * std::exp(-4.0f * i / TAPS);
+        irL[i] *= decay;
+        irR[i] *= decay;
+    }
+    engine.setImpulseResponse(irL.data(), irR.data(), TAPS);
+    std::vector<float> out = src;
+    for (int f = 0, n = 1; f < FRAMES; f += n, n = n % 700 + 37) {
+        engine.processInterleaved(&out[f * 2], std::min(n, FRAMES - f));
+    }
+    double convError = 0.0;
+    for (int t = LATENCY; t < FRAMES; t++) {
+        int n = t - LATENCY;
+        double l = 0.0, r = 0.0;
+        for (int m = 0; m <= n && m < TAPS; m++) {
+            l += irL[m] * src[(n - m) * 2];
+            r += irR[m] * src[(n - m) * 2 + 1];
+        }
+        convError = std::max(convError, std::max(std::fabs(l - out[t * 2]), std::fabs(r - out[t * 2 + 1])));
+    }
+    bool convOk = convError < 1e-5;
+    std::printf("  convolution vs direct (%d taps, %d tiers): max error %.2e %s\n",
+                TAPS, engine.getNumTiers(), convError, convOk ? "" : "WRONG");
+
+    // Impulse through the linear-phase EQ
+    const int FIR = 8192;
+    AudioProcessor processor;
+    processor.initialize(SAMPLE_RATE);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) processor.setEQBandGain(i, gains[i]);
+    processor.useLinearPhaseEQ(FIR);
+    int delay = processor.getLatency();
+    std::vector<float> pulse((delay + FIR) * 2, 0.0f);
+    pulse[0] = pulse[1] = 0.25f;
+    processor.processInterleavedStereo(pulse.data(), (int)pulse.size());
+    const float* h = &pulse[(delay - FIR / 2) * 2];
+
+    double asymmetry = 0.0;
+    for (int k = 1; k < FIR / 2; k++) {
+        asymmetry = std::max(asymmetry, (double)std::fabs(h[(FIR / 2 + k) * 2] - h[(FIR / 2 - k) * 2]));
+    }
+    double magnitudeError = 0.0;
+    for (int band = 0; band < Equalizer10::NUM_BANDS; band++) {
+        BiquadFilter::Design design;
+        processor.getEQBand(band, design);
+        double omega = 2.0 * M_PI * design.frequency / SAMPLE_RATE;
+        std::complex<double> fir = 0.0, iir = 1.0;
+        for (int n = 0; n < FIR; n++) fir += (double)h[n * 2] * 4.0 * std::polar(1.0, -omega * n);
+        for (int i = 0; i < Equalizer10::NUM_BANDS; i++) {
+            processor.getEQBand(i, design);
+            BiquadFilter::Coefficients c = BiquadFilter::calculateCoefficients(design);
+            std::complex<double> z1 = std::polar(1.0, -omega), z2 = z1 * z1;
+            iir *= (c.b0 + c.b1 * z1 + c.b2 * z2) / (1.0 + c.a1 * z1 + c.a2 * z2);
+        }
+        magnitudeError = std::max(magnitudeError, std::fabs(20.0 * std::log10(std::abs(fir) / std::abs(iir))));
+    }
+    bool firOk = asymmetry < 1e-6 && magnitudeError < 0.5;
+    std::printf("  linear-phase EQ (%d taps): asymmetry %.1e, max %.2f dB off the IIR at band centres %s\n",
+                FIR, asymmetry, magnitudeError, firOk ? "" : "WRONG");
+    return convOk && firOk;
+}
+
+// Peak of a stereo-interleaved signal between samples: 16x windowed-sinc
+// reconstruction of both channels
+static double truePeak(const std::vector<float>& buf, int first, int last) {
+    const int HALF = 32;
+    double peak = 0.0;
+    for (int i = std::max(first, HALF); i < std::min(last, (int)buf.size() / 2 - HALF); i++) {
+        for (int ch = 0; ch < 2; ch++) {
+            peak = std::max(peak, (double)std::fabs(buf[i * 2 + ch]));
+            for (int p = 1; p < 16; p++) {
+                double t = i + p / 16.0, y = 0.0;
+                for (int k = i - HALF + 1; k <= i + HALF; k++) {
+                    double x = t - k;
+                    y += buf[k * 2 + ch] * std::sin(M_PI * x) / (M_PI * x) * (0.5 + 0.5 * std::cos(M_PI * x / (HALF + 1)));
+                }
+                peak = std::max(peak, std::fabs(y));
+            }
+        }
+    }
+    return peak;
+}
+
+// The limiter must keep bass_boost on a loud mix below the ceiling, in
+// samples and (within the 4x detector's error) between them, and pass
+// quiet signals as an exact delayed copy
+static bool checkLimiter() {
+    const int FRAMES = 44100;
+    const double CEILING = std::pow(10.0, -1.0 / 20.0);
+    std::vector<float> src(FRAMES * 2);
+    for (int i = 0; i < FRAMES; i++) {
+        double level = i / 11025 % 2 ? 0.9 : 0.3;
+        double x = level * (0.6 * std::sin(2.0 * M_PI * 40.0 * i / SAMPLE_RATE) +
+                            0.4 * std::sin(2.0 * M_PI * 9000.0 * i / SAMPLE_RATE));
+        src[i * 2] = (float)x;
+        src[i * 2 + 1] = (float)(0.7 * x);
+    }
+
+    AudioProcessor processor;
+    processor.initialize(SAMPLE_RATE);
+    processor.applyEQPreset("bass_boost");
+    processor.setAutoPreGain(false);
+    processor.setLimiterEnabled(true);
+    std::vector<float> out = src;
+    for (int f = 0, n = 1; f < FRAMES; f += n, n = n % 700 + 37) {
+        processor.processInterleavedStereo(&out[f * 2], std::min(n, FRAMES - f) * 2);
+    }
+    double samplePeak = 0.0;
+    for (float v : out) samplePeak = std::max(samplePeak, (double)std::fabs(v));
+    double overshoot = 20.0 * std::log10(truePeak(out, 0, FRAMES) / CEILING);
+    bool limitOk = samplePeak <= CEILING * (1.0 + 1e-6) && overshoot < 0.2;
+
+    TruePeakLimiter limiter;
+    limiter.prepare(SAMPLE_RATE);
+    std::vector<float> quiet(FRAMES * 2);
+    fillNoise(quiet, 17);
+    std::vector<float> delayed = quiet;
+    limiter.processInterleaved(delayed.data(), FRAMES);
+    int latency = limiter.getLatency();
+    int modified = 0;
+    for (int i = latency * 2; i < FRAMES * 2; i++) {
+        if (delayed[i] != quiet[i - latency * 2]) modified++;
+    }
+    bool quietOk = modified == 0;
+
+    std::printf("  limiter (bass_boost, loud mix): sample peak %.6f, true peak %+.2f dB over -1 dBTP %s\n",
+                samplePeak, overshoot, limitOk ? "" : "WRONG");
+    std::printf("  limiter (quiet noise): %d of %d samples changed vs a %d-frame delay %s\n",
+                modified, (FRAMES - latency) * 2, latency, quietOk ? "" : "WRONG");
+    return limitOk && quietOk;
+}
+
+// With ratio 1 the compressor's bands must sum back to a flat magnitude
+// response; a steady sine over the threshold must settle on the static
+// curve (-6 dB in, -18 dB threshold, 4:1 -> -15 dB out)
+static bool checkCompressor() {
+    const int FRAMES = 8192;
+    bool ok = true;
+    for (int numBands = MultibandCompressor::MIN_BANDS; numBands <= MultibandCompressor::MAX_BANDS; numBands++) {
+        MultibandCompressor compressor;
+        compressor.prepare(SAMPLE_RATE);
+        compressor.setBands(numBands);
+        MultibandCompressor::BandSettings unity;
+        unity.ratio = 1.0;
+        for (int b = 0; b < numBands; b++) compressor.setBand(b, unity);
+        std::vector<float> impulse(FRAMES * 2, 0.0f);
+        impulse[0] = impulse[1] = 1.0f;
+        compressor.processInterleaved(impulse.data(), FRAMES);
+
+        double deviation = 0.0;
+        for (double f = 20.0; f < 20000.0; f *= 1.05) {
+            std::complex<double> h(0.0, 0.0);
+            for (int i = 0; i < FRAMES; i++) {
+                h += (double)impulse[i * 2] * std::polar(1.0, -2.0 * M_PI * f * i / SAMPLE_RATE);
+            }
+            deviation = std::max(deviation, std::fabs(20.0 * std::log10(std::abs(h))));
+        }
+        bool flatOk = deviation < 0.05;
+        std::printf("  compressor (%d bands, ratio 1): max %.4f dB from flat %s\n",
+                    numBands, deviation, flatOk ? "" : "WRONG");
+        ok = ok && flatOk;
+    }
+
+    const int SECONDS = 2;
+    MultibandCompressor compressor;
+    compressor.prepare(SAMPLE_RATE);
+    MultibandCompressor::BandSettings settings;
+    settings.thresholdDB = -18.0;
+    settings.ratio = 4.0;
+    for (int b = 0; b < MultibandCompressor::DEFAULT_BANDS; b++) compressor.setBand(b, settings);
+    std::vector<float> sine((int)SAMPLE_RATE * SECONDS * 2);
+    for (size_t i = 0; i < sine.size() / 2; i++) {
+        sine[i * 2] = sine[i * 2 + 1] = (float)(0.5 * std::sin(2.0 * M_PI * 700.0 * i / SAMPLE_RATE));
+    }
+    compressor.processInterleaved(sine.data(), (int)sine.size() / 2);
+    double level = 0.0;
+    for (size_t i = sine.size() / 2; i < sine.size(); i++) level = std::max(level, (double)std::fabs(sine[i]));
+    double levelDB = 20.0 * std::log10(level);
+    bool curveOk = std::fabs(levelDB + 15.0) < 1.0;
+    std::printf("  compressor (700 Hz at -6 dB, 4:1 over -18 dB): %.2f dB out, %.2f dB reduction %s\n",
+                levelDB, compressor.getGainReduction(1), curveOk ? "" : "WRONG");
+    return ok && curveOk;
+}
+
+// The resampler against the ideal signal: a sine through each tier at
+// 44.1k -> 48k (SNR after the reported latency, both ends trimmed) and a
+// 30 kHz tone taken from 96k to 44.1k (everything left of it is aliasing)
+static bool checkResampler() {
+    const double MIN_SNR[3] = { 65.0, 100.0, 120.0 };
+    const double MAX_ALIAS[3] = { -60.0, -90.0, -110.0 };
+    const double TONES[2] = { 1000.0, 15000.0 };
+    bool ok = true;
+    for (int q = 0; q < 3; q++) {
+        SampleRateConverter::Quality quality = (SampleRateConverter::Quality)q;
+        double snr[2];
+        for (int t = 0; t < 2; t++) {
+            const int FRAMES = 44100;
+            SampleRateConverter converter;
+            converter.prepare(44100.0, 48000.0, 2, quality);
+            std::vector<float> src(FRAMES * 2), dst(converter.getMaxOutputFrames(FRAMES) * 2);
+            for (int i = 0; i < FRAMES; i++) {
+                src[i * 2] = src[i * 2 + 1] = (float)(0.5 * std::sin(2.0 * M_PI * TONES[t] * i / 44100.0));
+            }
+            int written = 0;
+            for (int f = 0, n = 1; f < FRAMES; f += n, n = n % 700 + 37) {
+                int count = std::min(n, FRAMES - f);
+                written += converter.process(&src[f * 2], count, &dst[written * 2]);
+            }
+            double signal = 0.0, noise = 0.0;
+            for (int k = 4800; k < written - 4800; k++) {
+                double ideal = 0.5 * std::sin(2.0 * M_PI * TONES[t] * (k - converter.getLatency()) / 48000.0);
+                for (int ch = 0; ch < 2; ch++) {
+                    noise += (dst[k * 2 + ch] - ideal) * (dst[k * 2 + ch] - ideal);
+                    signal += ideal * ideal;
+                }
+            }
+            snr[t] = 10.0 * std::log10(signal / noise);
+        }
+
+        const int FRAMES = 96000;
+        SampleRateConverter converter;
+        converter.prepare(96000.0, 44100.0, 2, quality);
+        std::vector<float> src(FRAMES * 2), dst(converter.getMaxOutputFrames(FRAMES) * 2);
+        for (int i = 0; i < FRAMES; i++) {
+            src[i * 2] = src[i * 2 + 1] = (float)(0.5 * std::sin(2.0 * M_PI * 30000.0 * i / 96000.0));
+        }
+        int written = converter.process(src.data(), FRAMES, dst.data());
+        double power = 0.0;
+        for (int k = written / 2; k < written; k++) power += dst[k * 2] * dst[k * 2];
+        double alias = 10.0 * std::log10(power / (written - written / 2) / 0.125);
+
+        bool tierOk = std::min(snr[0], snr[1]) >= MIN_SNR[q] && alias <= MAX_ALIAS[q];
+        std::printf("  resampler (%s): SNR %.1f / %.1f dB at 1k / 15k, 30 kHz alias %.1f dB %s\n",
+                    SampleRateConverter::getQualityName(quality), snr[0], snr[1], alias,
+                    tierOk ? "" : "WRONG");
+        ok = ok && tierOk;
+    }
+    return ok;
+}
+
+// A processor moved from 44.1k to 48k while set up must keep its
+// settings and then sound exactly like one built at 48k; a parametric band
+// above the lower Nyquist must come back when the rate rises again
+static bool checkReconfigure(const double* gains) {
+    const int FRAMES = 4096;
+    std::vector<float> noise(FRAMES * 2);
+    fillNoise(noise, 21);
+    for (float& x : noise) x *= 0.5f;
+
+    AudioProcessor moved, fresh;
+    moved.initialize(44100.0, BLOCK_SIZE);
+    fresh.initialize(48000.0, BLOCK_SIZE);
+    for (AudioProcessor* p : { &moved, &fresh }) {
+        p->setEQSmoothingTime(0.0);
+        for (int band = 0; band < Equalizer10::NUM_BANDS; band++) p->setEQBandGain(band, gains[band]);
+        p->setCompressorEnabled(true);
+        p->setLimiterEnabled(true);
+    }
+    std::vector<float> warm = noise;
+    moved.processInterleavedStereo(warm.data(), FRAMES * 2);
+    moved.reconfigure(48000.0);
+
+    bool kept = moved.getSampleRate() == 48000.0 && moved.isCompressorEnabled() && moved.isLimiterEnabled();
+    for (int band = 0; band < Equalizer10::NUM_BANDS; band++) {
+        kept = kept && moved.getEQBandGain(band) == fresh.getEQBandGain(band);
+    }
+    std::vector<float> a = noise, b = noise;
+    moved.processInterleavedStereo(a.data(), FRAMES * 2);
+    fresh.processInterleavedStereo(b.data(), FRAMES * 2);
+    double diff = 0.0;
+    for (int i = 0; i < FRAMES * 2; i++) diff = std::max(diff, (double)std::fabs(a[i] - b[i]));
+
+    ParametricEqualizer parametric(48000.0);
+    BiquadFilter::Design air;
+    air.type = BiquadFilter::HIGHSHELF;
+    air.frequency = 20000.0;
+    air.gainDB = 4.0;
+    int airBand = parametric.addBand(air);
+    parametric.setSampleRate(32000.0);
+    BiquadFilter::Design low, back;
+    parametric.getBand(airBand, low);
+    parametric.setSampleRate(48000.0);
+    parametric.getBand(airBand, back);
+    bool roundTrip = low.frequency < 16000.0 && back.frequency == 20000.0 && back.gainDB == 4.0;
+
+    bool ok = kept && diff < 1e-6 && roundTrip;
+    std::printf("  reconfigure 44.1k -> 48k: settings %s, max %.2e from a fresh 48k chain, "
+                "20 kHz band %.0f -> %.0f Hz at 32k -> 48k %s\n",
+                kept ? "kept" : "LOST", diff, low.frequency, back.frequency, ok ? "" : "WRONG");
+    return ok;
+}
+
+// Batch clips of uneven length, with presets and user curves
+static const int BATCH_CLIPS = 64;
+
+static std::vector<BatchProcessor::Job> batchJobs(std::vector<std::vector<float>>& clips, const double* gains) {
+    std::vector<BatchProcessor::Job> jobs(clips.size());
+    for (size_t c = 0; c < clips.size(); c++) {
+        jobs[c].buffer = clips[c].data();
+        jobs[c].numFrames = (int)clips[c].size() / 2;
+        jobs[c].presetId = c % 3 == 2 ? -1 : (int)(c % Equalizer::NUM_PRESETS);
+        if (jobs[c].presetId < 0) jobs[c].gains.assign(gains, gains + Equalizer10::NUM_BANDS);
+    }
+    return jobs;
+}
+
+static std::vector<std::vector<float>> batchClips(int seconds) {
+    std::vector<std::vector<float>> clips(BATCH_CLIPS);
+    for (int c = 0; c < BATCH_CLIPS; c++) {
+        clips[c].resize((size_t)(SAMPLE_RATE * (seconds + c % 3) + 37 * c) * 2);
+        fillNoise(clips[c], 30 + c);
+        for (float& x : clips[c]) x *= 0.25f;
+    }
+    return clips;
+}
+
+// Every clip of a batch, on any number of threads, must come out exactly
+// as a new processor with the same preset or curve would leave it
+static bool checkBatch(const double* gains) {
+    std::vector<std::vector<float>> clips = batchClips(0);
+    std::vector<std::vector<float>> expected = clips;
+    std::vector<BatchProcessor::Job> reference = batchJobs(expected, gains);
+    for (BatchProcessor::Job& job : reference) {
+        AudioProcessor processor;
+        processor.initialize(SAMPLE_RATE);
+        processor.setEQSmoothingTime(0.0);
+        if (job.presetId >= 0) {
+            processor.applyEQPreset(job.presetId);
+        } else {
+            processor.morphEQToCurve(job.gains.data(), (int)job.gains.size(), 0.0);
+        }
+        processor.processInterleavedStereo(job.buffer, job.numFrames * 2);
+    }
+
+    BatchProcessor batch(4);
+    bool same = true;
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        std::vector<std::vector<float>> processed = clips;
+        std::vector<BatchProcessor::Job> jobs = batchJobs(processed, gains);
+        batch.process(jobs, SAMPLE_RATE, Equalizer10::NUM_BANDS, threads);
+        same = same && processed == expected;
+    }
+
+    // Three batches at once share the pool, each limited differently
+    std::vector<std::vector<float>> overlapped[3] = { clips, clips, clips };
+    std::vector<std::thread> callers;
+    for (int b = 0; b < 3; b++) {
+        callers.emplace_back([&, b] {
+            std::vector<BatchProcessor::Job> jobs = batchJobs(overlapped[b], gains);
+            batch.process(jobs, SAMPLE_RATE, Equalizer10::NUM_BANDS, b + 1);
+        });
+    }
+    for (std::thread& caller : callers) caller.join();
+    for (int b = 0; b < 3; b++) same = same && overlapped[b] == expected;
+
+    std::printf("  batch of %d clips on 1/2/4 threads, and 3 at once: %s\n", BATCH_CLIPS,
+                same ? "bit-identical to one processor per clip" : "MISMATCH");
+    return same;
+}
+
+int main() {
+    const double gains[Equalizer10::NUM_BANDS] = { 5, 3, -2, -3, -1, 1, 3, 4, 5, 5 };  // "rock"
+
+    std::printf("Native equalizer DSP benchmark\n");
+    std::printf("Kernels: double %s, float %s; block %d frames, %d blocks, best of %d runs\n\n",
+                BiquadCascade<double>::getKernelName(), BiquadCascade<float>::getKernelName(),
+                BLOCK_SIZE, NUM_BLOCKS, NUM_RUNS);
+
+    std::printf("Conformance:\n");
+    bool ok = checkConformance<double>("double", gains, 1e-5);
+    ok = checkConformance<float>("float", gains, 1e-3) && ok;
+    for (int ch = 1; ch <= 8; ch++) {
+        ok = checkInterleaved<double>("double", gains, ch) && ok;
+    }
+    ok = checkInterleaved<float>("float", gains, 6) && ok;
+    ok = checkInterleaved<double, 10>("double", gains, 2) && ok;
+    ok = checkInterleaved<double, 10>("double", gains, 6) && ok;
+    ok = checkInterleaved<float, 10>("float", gains, 2) && ok;
+    ok = checkTable() && ok;
+    ok = checkParametric(gains) && ok;
+    ok = checkBypass() && ok;
+    ok = checkAutomation(gains) && ok;
+    ok = checkConvolution(gains) && ok;
+    ok = checkLimiter() && ok;
+    ok = checkCompressor() && ok;
+    ok = checkResampler() && ok;
+    ok = checkReconfigure(gains) && ok;
+    ok = checkBatch(gains) && ok;
+    std::printf("\n");
+
+    std::vector<float> srcL(BLOCK_SIZE), srcR(BLOCK_SIZE);
+    fillNoise(srcL, 3);
+    fillNoise(srcR, 4);
+
+    LegacyEqualizer legacy(gains);
+    double legacyNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        legacy.processStereo(l, r, n);
+    });
+
+    BiquadCascade<double> scalar;
+    configureCascade(scalar, gains);
+    scalar.setSimdEnabled(false);
+    double scalarNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        scalar.processStereo(l, r, n);
+    });
+
+    BiquadCascade<double> simd;
+    configureCascade(simd, gains);
+    double simdNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        simd.processStereo(l, r, n);
+    });
+
+    BiquadCascade<float> simdFloat;
+    configureCascade(simdFloat, gains);
+    double simdFloatNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        simdFloat.processStereo(l, r, n);
+    });
+
+    // Compile-time section count: unrolled cascade and each graphic layout
+    BiquadCascade<double, 10> unrolled;
+    configureCascade(unrolled, gains);
+    double unrolledNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        unrolled.processStereo(l, r, n);
+    });
+    const int LAYOUTS[3] = { 5, 10, 31 };
+    double layoutNs[3];
+    for (int k = 0; k < 3; k++) {
+        std::unique_ptr<Equalizer> eq = Equalizer::create(LAYOUTS[k], SAMPLE_RATE);
+        eq->applyPreset("rock");
+        layoutNs[k] = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+            eq->processStereo(l, r, n);
+        });
+    }
+
+    // Parametric EQ: 10 and 20 bands all active, and 20 bands mostly flat
+    auto timeParametric = [&](int numBands, int numActive) {
+        ParametricEqualizer eq(SAMPLE_RATE);
+        eq.setSmoothingTime(0);
+        for (int i = Equalizer10::NUM_BANDS; i < numBands; i++) {
+            BiquadFilter::Design design;
+            design.type = BiquadFilter::PEAKING;
+            design.frequency = Equalizer10::Layout::FREQUENCIES[i - Equalizer10::NUM_BANDS] * 1.41421356;
+            design.sampleRate = SAMPLE_RATE;
+            design.Q = 1.4;
+            eq.addBand(design);
+        }
+        for (int i = 0; i < numActive; i++) {
+            eq.setBandGain(i, gains[i % Equalizer10::NUM_BANDS]);
+        }
+        return timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+            eq.processStereo(l, r, n);
+        });
+    };
+    double parametric10Ns = timeParametric(10, 10);
+    double parametric20Ns = timeParametric(20, 20);
+    double parametric20SparseNs = timeParametric(20, 3);
+    double parametricFlatNs = timeParametric(20, 0);
+
+    // Flat and mostly-flat graphic EQ against all ten identity sections
+    BiquadCascade<double, 10> identity;
+    double identityNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        identity.processStereo(l, r, n);
+    });
+    auto timeActive = [&](int numActive) {
+        Equalizer10 eq(SAMPLE_RATE);
+        eq.setSmoothingTime(0);
+        for (int i = 0; i < numActive; i++) eq.setBandGain(i, gains[i]);
+        return timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+            eq.processStereo(l, r, n);
+        });
+    };
+    double flatNs = timeActive(0);
+    double twoActiveNs = timeActive(2);
+
+    // Track ending into silence: bare kernel, kernel with FTZ/DAZ, and the
+    // AudioProcessor path (silence detection + FTZ/DAZ)
+    std::vector<double> endKernel = timeTrackEnd([&]() {
+        auto cascade = std::make_shared<BiquadCascade<EqualizerSample, 10>>();
+        configureCascade(*cascade, gains);
+        return [cascade](float* l, float* r, int n) { cascade->processStereo(l, r, n); };
+    });
+    std::vector<double> endFlush = timeTrackEnd([&]() {
+        auto cascade = std::make_shared<BiquadCascade<EqualizerSample, 10>>();
+        configureCascade(*cascade, gains);
+        return [cascade](float* l, float* r, int n) {
+            DenormalGuard denormals;
+            cascade->processStereo(l, r, n);
+        };
+    });
+    std::vector<double> endProcessor = timeTrackEnd([&]() {
+        auto proc = std::make_shared<AudioProcessor>();
+        proc->initialize(SAMPLE_RATE);
+        proc->setEQSmoothingTime(0);
+        for (int i = 0; i < Equalizer10::NUM_BANDS; i++) proc->setEQBandGain(i, gains[i]);
+        return [proc](float* l, float* r, int n) { proc->processSeparateChannels(l, r, n); };
+    });
+
+    // AudioProcessor interleaved path: old de-interleave copy vs in place
+    std::vector<float> srcInterleaved(BLOCK_SIZE * 2);
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        srcInterleaved[i * 2] = srcL[i];
+        srcInterleaved[i * 2 + 1] = srcR[i];
+    }
+    std::vector<float> scratchL, scratchR;
+    double copyNs = timeInterleaved(srcInterleaved, [&](float* buf, int frames) {
+        scratchL.resize(frames);
+        scratchR.resize(frames);
+        for (int i = 0; i < frames; i++) { scratchL[i] = buf[i * 2]; scratchR[i] = buf[i * 2 + 1]; }
+        simd.processStereo(scratchL.data(), scratchR.data(), frames);
+        for (int i = 0; i < frames; i++) { buf[i * 2] = scratchL[i]; buf[i * 2 + 1] = scratchR[i]; }
+    });
+    AudioProcessor processor;
+    processor.initialize(SAMPLE_RATE);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) processor.setEQBandGain(i, gains[i]);
+    double inPlaceNs = timeInterleaved(srcInterleaved, [&](float* buf, int frames) {
+        processor.processInterleavedStereo(buf, frames * 2);
+    });
+
+    // Automation: one gain event per block against plain processing
+    AudioProcessor automated;
+    automated.initialize(SAMPLE_RATE);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) automated.setEQBandGain(i, gains[i]);
+    double automatedNs = timeInterleaved(srcInterleaved, [&](float* buf, int frames) {
+        long long at = automated.getFramePosition() + frames / 2;
+        int band = (int)(at % Equalizer10::NUM_BANDS);
+        AutomationEvent event = { at, AutomationEvent::BAND_GAIN, band, gains[band] + (at & 1) };
+        automated.scheduleAutomation(event);
+        automated.processInterleavedStereo(buf, frames * 2);
+    });
+
+    // SystemAudioHook packet: old per-frame processStereo calls vs one call
+    const int PACKET_FRAMES = 480;  // 10 ms at 48 kHz
+    Equalizer10 hookEq(SAMPLE_RATE);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) hookEq.setBandGain(i, gains[i]);
+    std::vector<float> packetSrc(PACKET_FRAMES * 8), packet(PACKET_FRAMES * 8);
+    fillNoise(packetSrc, 5);
+    auto timePacket = [&](int channels, bool perFrame) {
+        double best = 1e30;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int b = 0; b < NUM_BLOCKS; b++) {
+                std::memcpy(packet.data(), packetSrc.data(), PACKET_FRAMES * channels * sizeof(float));
+                float* buf = packet.data();
+                if (!perFrame) {
+                    hookEq.processInterleaved(buf, channels, PACKET_FRAMES);
+                } else if (channels == 2) {
+                    for (int i = 0; i < PACKET_FRAMES; i++) {
+                        float left = buf[i * 2], right = buf[i * 2 + 1];
+                        hookEq.processStereo(&left, &right, 1);
+                        buf[i * 2] = left;
+                        buf[i * 2 + 1] = right;
+                    }
+                } else {
+                    for (int i = 0; i < PACKET_FRAMES; i++) {
+                        float sample = buf[i];
+                        hookEq.processStereo(&sample, &sample, 1);
+                        buf[i] = sample;
+                    }
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count() / NUM_BLOCKS);
+        }
+        return best;
+    };
+    double packetStereoOld = timePacket(2, true);
+    double packetStereoNew = timePacket(2, false);
+    double packetMonoOld = timePacket(1, true);
+    double packetMonoNew = timePacket(1, false);
+    double packet51 = timePacket(6, false);
+    double packet71 = timePacket(8, false);
+
+    // Gain smoothing: settled vs ramping every band (ramp longer than the run)
+    Equalizer10 settledEq(SAMPLE_RATE);
+    settledEq.setSmoothingTime(0.0);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) settledEq.setBandGain(i, gains[i]);
+    double settledNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        settledEq.processStereo(l, r, n);
+    });
+    Equalizer10 rampEq(SAMPLE_RATE);
+    rampEq.setSmoothingTime(1e7);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) rampEq.setBandGain(i, gains[i]);
+    double rampNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        rampEq.processStereo(l, r, n);
+    });
+
+    // Preset morph: every band ramping from "rock" to "pop", and a crossfader
+    // dragged between them (new blend each block)
+    const int ROCK = Equalizer::findPreset("rock");
+    const int POP = Equalizer::findPreset("pop");
+    Equalizer10 morphEq(SAMPLE_RATE);
+    morphEq.setSmoothingTime(0.0);
+    morphEq.applyPreset(ROCK);
+    morphEq.morphToPreset(POP, 1e7);
+    double morphNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        morphEq.processStereo(l, r, n);
+    });
+    Equalizer10 fadeEq(SAMPLE_RATE);
+    int fadeStep = 0;
+    double crossfadeNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        fadeEq.morphPresets(ROCK, POP, (fadeStep++ % 64) / 63.0, 50.0);
+        fadeEq.processStereo(l, r, n);
+    });
+
+    // Preset switch on the control thread: by name vs pre-resolved ID
+    const int SWITCH_RUNS = 20000;
+    Equalizer10 switchEq(SAMPLE_RATE);
+    auto timeSwitch = [&](bool byName) {
+        double best = 1e30;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < SWITCH_RUNS; k++) {
+                if (byName) {
+                    switchEq.applyPreset(k & 1 ? "rock" : "jazz");
+                } else {
+                    switchEq.applyPreset(k & 1 ? ROCK : POP);
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / SWITCH_RUNS);
+        }
+        return best;
+    };
+    double switchNameNs = timeSwitch(true);
+    double switchIdNs = timeSwitch(false);
+
+    // Coefficient design: full RBJ math vs shared table
+    const int DESIGN_RUNS = 20000;
+    volatile double sink = 0.0;
+    const CoefficientTable* tables[Equalizer10::NUM_BANDS];
+    for (int band = 0; band < Equalizer10::NUM_BANDS; band++) {
+        tables[band] = CoefficientTable::find(bandDesign(band, 0.0));
+    }
+    auto timeDesign = [&](bool useTable) {
+        double best = 1e30;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < DESIGN_RUNS; k++) {
+                for (int band = 0; band < Equalizer10::NUM_BANDS; band++) {
+                    BiquadFilter::Design design = bandDesign(band, ((k + band) % 49 - 24) * 0.5);
+                    BiquadFilter::Coefficients c = useTable
+                        ? tables[band]->lookup(design.gainDB)
+                        : BiquadFilter::calculateCoefficients(design);
+                    sink += c.b0;
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            best = std::min(best, ns / (double(DESIGN_RUNS) * Equalizer10::NUM_BANDS));
+        }
+        return best;
+    };
+    double mathDesignNs = timeDesign(false);
+    double tableDesignNs = timeDesign(true);
+    auto timeRebuild = [&]() {
+        double best = 1e30;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < 1000; k++) {
+                Equalizer10 eq(k % 2 ? 44100.0 : 48000.0);
+                eq.applyPreset(k % 3 ? "rock" : "jazz");
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count() / 1000);
+        }
+        return best;
+    };
+    double rebuildUs = timeRebuild();
+    auto timeRetune = [&]() {
+        Equalizer10 eq(44100.0);
+        eq.applyPreset("rock");
+        double best = 1e30;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < 1000; k++) {
+                eq.setSampleRate(k % 2 ? 44100.0 : 48000.0);
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count() / 1000);
+        }
+        return best;
+    };
+    double retuneUs = timeRetune();
+
+    // Convolution: FFT pairs, then the engine by IR length, latency and
+    // partitioning, and the linear-phase EQ against the IIR path
+    const int FFT_SIZES[3] = { 128, 2048, 32768 };
+    double fftNs[3];
+    for (int k = 0; k < 3; k++) {
+        FFT fft(FFT_SIZES[k]);
+        std::vector<float> re(FFT_SIZES[k]), im(FFT_SIZES[k]);
+        fillNoise(re, 14);
+        fillNoise(im, 15);
+        int pairs = std::max(1, (1 << 22) / FFT_SIZES[k]);
+        fftNs[k] = 1e30;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < pairs; i++) {
+                fft.forward(re.data(), im.data());
+                fft.inverse(re.data(), im.data());
+                re[0] *= 1.0f / FFT_SIZES[k];
+            }
+            auto end = std::chrono::steady_clock::now();
+            fftNs[k] = std::min(fftNs[k], std::chrono::duration<double, std::nano>(end - start).count() / pairs);
+        }
+    }
+    const int IR_TAPS[2] = { 8192, 65536 };
+    const int LATENCIES[3] = { 64, 256, 1024 };
+    double convNs[2][3][2];
+    for (int t = 0; t < 2; t++) {
+        std::vector<float> ir(IR_TAPS[t]);
+        fillNoise(ir, 16);
+        for (int i = 0; i < IR_TAPS[t]; i++) ir[i] *= 0.01f * std::exp(-4.0f * i / IR_TAPS[t]);
+        for (int l = 0; l < 3; l++) {
+            for (int u = 0; u < 2; u++) {
+                ConvolutionEngine engine;
+                engine.configure(LATENCIES[l], IR_TAPS[t],
+                                 u ? ConvolutionEngine::UNIFORM : ConvolutionEngine::NON_UNIFORM);
+                engine.setImpulseResponse(ir.data(), nullptr, IR_TAPS[t]);
+                convNs[t][l][u] = timeInterleaved(srcInterleaved, [&](float* buf, int frames) {
+                    engine.processInterleaved(buf, frames);
+                });
+            }
+        }
+    }
+    AudioProcessor linearPhase;
+    linearPhase.initialize(SAMPLE_RATE);
+    for (int i = 0; i < Equalizer10::NUM_BANDS; i++) linearPhase.setEQBandGain(i, gains[i]);
+    linearPhase.useLinearPhaseEQ();
+    double linearPhaseNs = timeInterleaved(srcInterleaved, [&](float* buf, int frames) {
+        linearPhase.processInterleavedStereo(buf, frames * 2);
+    });
+
+    // Output stage on bass_boost: hard clamp vs unclamped + limiter, on
+    // the usual noise (below the ceiling) and 8 dB louder (limiting)
+    std::vector<float> loudInterleaved(srcInterleaved);
+    for (float& v : loudInterleaved) v *= 2.5f;
+    auto timeOutputStage = [&](const std::vector<float>& src, bool limit) {
+        AudioProcessor stageProcessor;
+        stageProcessor.initialize(SAMPLE_RATE);
+        stageProcessor.applyEQPreset("bass_boost");
+        stageProcessor.setLimiterEnabled(limit);
+        return timeInterleaved(src, [&](float* buf, int frames) {
+            stageProcessor.processInterleavedStereo(buf, frames * 2);
+        });
+    };
+    double clampStageNs = timeOutputStage(srcInterleaved, false);
+    double limiterStageNs = timeOutputStage(srcInterleaved, true);
+    double loudClampStageNs = timeOutputStage(loudInterleaved, false);
+    double loudLimiterStageNs = timeOutputStage(loudInterleaved, true);
+
+    // Multiband compressor on its own, every band compressing, against a
+    // budget of 1% of one core at each rate
+    const int COMPRESSOR_BANDS[3] = { 3, 4, 5 };
+    const double COMPRESSOR_RATES[3] = { 44100.0, 48000.0, 96000.0 };
+    double compressorNs[3][3];
+    for (int b = 0; b < 3; b++) {
+        for (int r = 0; r < 3; r++) {
+            MultibandCompressor compressor;
+            compressor.prepare(COMPRESSOR_RATES[r]);
+            compressor.setBands(COMPRESSOR_BANDS[b]);
+            MultibandCompressor::BandSettings settings;
+            settings.thresholdDB = -30.0;
+            for (int k = 0; k < COMPRESSOR_BANDS[b]; k++) compressor.setBand(k, settings);
+            compressorNs[b][r] = timeInterleaved(srcInterleaved, [&](float* buf, int frames) {
+                compressor.processInterleaved(buf, frames);
+            });
+        }
+    }
+
+    // Resampler throughput per tier, stereo, ns per input frame
+    const double RESAMPLE_RATES[5][2] = {
+        { 44100.0, 48000.0 }, { 48000.0, 44100.0 }, { 44100.0, 96000.0 }, { 96000.0, 44100.0 }, { 44100.0, 48004.8 }
+    };
+    double resampleNs[3][5];
+    bool resampleExact[5];
+    for (int q = 0; q < 3; q++) {
+        for (int r = 0; r < 5; r++) {
+            SampleRateConverter converter;
+            converter.prepare(RESAMPLE_RATES[r][0], RESAMPLE_RATES[r][1], 2, (SampleRateConverter::Quality)q);
+            resampleExact[r] = converter.isExact();
+            std::vector<float> converted(converter.getMaxOutputFrames(BLOCK_SIZE) * 2);
+            resampleNs[q][r] = timeInterleaved(srcInterleaved, [&](float* buf, int frames) {
+                converter.process(buf, frames, converted.data());
+            });
+        }
+    }
+
+    // Batch throughput by thread count, up to one per hardware thread
+    BatchProcessor batch;
+    std::vector<std::vector<float>> batchSource = batchClips(2);
+    double batchSeconds = 0.0;
+    for (const std::vector<float>& clip : batchSource) batchSeconds += clip.size() / 2 / SAMPLE_RATE;
+    std::vector<int> batchThreads;
+    std::vector<double> batchMs;
+    for (int threads = 1; ; threads = std::min(threads * 2, batch.getNumThreads())) {
+        double best = 1e30;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            std::vector<std::vector<float>> clips = batchSource;
+            std::vector<BatchProcessor::Job> jobs = batchJobs(clips, gains);
+            auto start = std::chrono::steady_clock::now();
+            batch.process(jobs, SAMPLE_RATE, Equalizer10::NUM_BANDS, threads);
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        batchThreads.push_back(threads);
+        batchMs.push_back(best);
+        if (threads == batch.getNumThreads()) break;
+    }
+
+    // Single section, per-sample calls vs one block call
+    BiquadFilter filter;
+    filter.setFrequency(1000.0, SAMPLE_RATE);
+    filter.setGain(6.0);
+    double perSampleNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        for (int i = 0; i < n; i++) l[i] = (float)filter.process(l[i]);
+        for (int i = 0; i < n; i++) r[i] = (float)filter.process(r[i]);
+    });
+    double blockNs = timeStereo(srcL, srcR, [&](float* l, float* r, int n) {
+        filter.processBlock(l, l, n);
+        filter.processBlock(r, r, n);
+    });
+
+    std::printf("10-band stereo, ns per stereo frame:\n");
+    std::printf("  %-28s %8.2f  (1.00x)\n", "legacy BiquadFilter loop", legacyNs);
+    std::printf("  %-28s %8.2f  (%.2fx)\n", "cascade double, scalar", scalarNs, legacyNs / scalarNs);
+    std::printf("  %-28s %8.2f  (%.2fx)\n", "cascade double, SIMD", simdNs, legacyNs / simdNs);
+    std::printf("  %-28s %8.2f  (%.2fx)\n", "cascade float, SIMD", simdFloatNs, legacyNs / simdFloatNs);
+    std::printf("  %-28s %8.2f  (%.2fx)\n", "cascade double, unrolled", unrolledNs, legacyNs / unrolledNs);
+    std::printf("\nGraphicEqualizer layouts (\"rock\"), ns per stereo frame:\n");
+    for (int k = 0; k < 3; k++) {
+        std::printf("  %-28s %8.2f  (%.2f per band)\n",
+                    LAYOUTS[k] == 5 ? "5-band" : LAYOUTS[k] == 10 ? "10-band" : "31-band",
+                    layoutNs[k], layoutNs[k] / LAYOUTS[k]);
+    }
+    std::printf("\nFlat bands (10-band), ns per stereo frame:\n");
+    std::printf("  %-28s %8.2f\n", "10 identity sections", identityNs);
+    std::printf("  %-28s %8.2f\n", "2 bands active", twoActiveNs);
+    std::printf("  %-28s %8.2f\n", "all flat (bypass)", flatNs);
+    std::printf("\nParametricEqualizer, ns per stereo frame:\n");
+    std::printf("  %-28s %8.2f\n", "10 bands, 10 active", parametric10Ns);
+    std::printf("  %-28s %8.2f  (%.2fx)\n", "20 bands, 20 active", parametric20Ns, parametric20Ns / parametric10Ns);
+    std::printf("  %-28s %8.2f  (%.2fx)\n", "20 bands, 3 active", parametric20SparseNs, parametric20SparseNs / parametric10Ns);
+    std::printf("  %-28s %8.2f\n", "20 bands, all flat", parametricFlatNs);
+    std::printf("\nTrack ending (1 s play, 1 s fade, silence), ns per stereo frame:\n");
+    std::printf("  %-8s %10s %10s %10s\n", "second", "kernel", "+FTZ/DAZ", "processor");
+    for (int w = 0; w < TRACK_SECONDS; w++) {
+        std::printf("  %-8d %10.2f %10.2f %10.2f\n", w, endKernel[w], endFlush[w], endProcessor[w]);
+    }
+    std::printf("\nInterleaved stereo, ns per stereo frame:\n");
+    std::printf("  %-28s %8.2f\n", "de-interleave + processStereo", copyNs);
+    std::printf("  %-28s %8.2f\n", "processInterleavedStereo", inPlaceNs);
+    std::printf("  %-28s %8.2f\n", "  + 1 automation event/block", automatedNs);
+    std::printf("\nSystemAudioHook packet (%d frames), us per packet:\n", PACKET_FRAMES);
+    std::printf("  %-28s %8.2f\n", "stereo, per-frame calls", packetStereoOld);
+    std::printf("  %-28s %8.2f  (%.1fx)\n", "stereo, one call", packetStereoNew, packetStereoOld / packetStereoNew);
+    std::printf("  %-28s %8.2f\n", "mono, per-frame calls", packetMonoOld);
+    std::printf("  %-28s %8.2f  (%.1fx)\n", "mono, one call", packetMonoNew, packetMonoOld / packetMonoNew);
+    std::printf("  %-28s %8.2f\n", "5.1, one call", packet51);
+    std::printf("  %-28s %8.2f\n", "7.1, one call", packet71);
+    std::printf("\nGain smoothing (update every %d frames), ns per stereo frame:\n",
+                Equalizer::SMOOTHING_INTERVAL);
+    std::printf("  %-28s %8.2f\n", "settled", settledNs);
+    std::printf("  %-28s %8.2f  (+%.2f)\n", "all 10 bands ramping", rampNs, rampNs - settledNs);
+    std::printf("  %-28s %8.2f  (+%.2f)\n", "preset morph rock -> pop", morphNs, morphNs - settledNs);
+    std::printf("  %-28s %8.2f  (+%.2f)\n", "crossfader, new blend/block", crossfadeNs, crossfadeNs - settledNs);
+    std::printf("\nPreset switch (control thread), ns per call:\n");
+    std::printf("  %-28s %8.2f\n", "applyPreset(name)", switchNameNs);
+    std::printf("  %-28s %8.2f\n", "applyPreset(id)", switchIdNs);
+    std::printf("\nCoefficient design, ns per band (0.5 dB steps):\n");
+    std::printf("  %-28s %8.2f\n", "calculateCoefficients", mathDesignNs);
+    std::printf("  %-28s %8.2f  (%.1fx)\n", "CoefficientTable lookup", tableDesignNs, mathDesignNs / tableDesignNs);
+    std::printf("  %-28s %8.2f us\n", "new Equalizer + preset", rebuildUs);
+    std::printf("  %-28s %8.2f us\n", "setSampleRate (in place)", retuneUs);
+    std::printf("\nConvolution, ns per FFT pair (forward + inverse):\n");
+    for (int k = 0; k < 3; k++) {
+        std::printf("  %-28d %8.0f  (%.2f per point)\n", FFT_SIZES[k], fftNs[k], fftNs[k] / FFT_SIZES[k]);
+    }
+    std::printf("\nConvolution, ns per stereo frame (one IR on both channels):\n");
+    std::printf("  %-8s %-8s %12s %12s\n", "taps", "latency", "non-uniform", "uniform");
+    for (int t = 0; t < 2; t++) {
+        for (int l = 0; l < 3; l++) {
+            std::printf("  %-8d %-8d %12.2f %12.2f\n", IR_TAPS[t], LATENCIES[l], convNs[t][l][0], convNs[t][l][1]);
+        }
+    }
+    std::printf("  %-28s %8.2f  (IIR %.2f)\n", "linear-phase EQ, 8192 taps", linearPhaseNs, inPlaceNs);
+    std::printf("\nOutput stage (\"bass_boost\"), ns per stereo frame:\n");
+    std::printf("  %-28s %8.2f\n", "EQ, clamped", clampStageNs);
+    std::printf("  %-28s %8.2f  (+%.2f)\n", "EQ, unclamped + limiter", limiterStageNs, limiterStageNs - clampStageNs);
+    std::printf("  %-28s %8.2f\n", "+8 dB: EQ, clamped", loudClampStageNs);
+    std::printf("  %-28s %8.2f  (+%.2f)\n", "+8 dB: EQ + limiter", loudLimiterStageNs,
+                loudLimiterStageNs - loudClampStageNs);
+    std::printf("\nMultiband compressor, ns per stereo frame (%% of one core, budget 1%%):\n");
+    bool compressorOk = true;
+    std::printf("  %-8s", "bands");
+    for (int r = 0; r < 3; r++) std::printf(" %13.1f kHz ", COMPRESSOR_RATES[r] / 1000.0);
+    std::printf("\n");
+    for (int b = 0; b < 3; b++) {
+        std::printf("  %-8d", COMPRESSOR_BANDS[b]);
+        for (int r = 0; r < 3; r++) {
+            double load = compressorNs[b][r] * COMPRESSOR_RATES[r] * 1e-7;
+            std::printf(" %8.2f (%5.2f%%)%s", compressorNs[b][r], load, load > 1.0 ? "!" : " ");
+            compressorOk = compressorOk && load <= 1.0;
+        }
+        std::printf("\n");
+    }
+    if (!compressorOk) std::printf("  WRONG: over the 1%% budget\n");
+    ok = ok && compressorOk;
+    std::printf("\nResampler, stereo, ns per input frame (M samples/s per channel):\n");
+    std::printf("  %-28s", "rates");
+    for (int q = 0; q < 3; q++) std::printf(" %18s", SampleRateConverter::getQualityName((SampleRateConverter::Quality)q));
+    std::printf("\n");
+    for (int r = 0; r < 5; r++) {
+        char label[64];
+        std::snprintf(label, sizeof(label), "%gk -> %gk%s", RESAMPLE_RATES[r][0] / 1000.0,
+                      RESAMPLE_RATES[r][1] / 1000.0, resampleExact[r] ? "" : " (interp.)");
+        std::printf("  %-28s", label);
+        for (int q = 0; q < 3; q++) std::printf(" %8.2f (%6.1f)", resampleNs[q][r], 1000.0 / resampleNs[q][r]);
+        std::printf("\n");
+    }
+    std::printf("\nBatch, %d clips (%.0f s of audio), ms per batch (speedup):\n", BATCH_CLIPS, batchSeconds);
+    for (size_t t = 0; t < batchThreads.size(); t++) {
+        char label[32];
+        std::snprintf(label, sizeof(label), "%d thread%s", batchThreads[t], batchThreads[t] == 1 ? "" : "s");
+        std::printf("  %-28s %8.2f  (%.2fx)\n", label, batchMs[t], batchMs[0] / batchMs[t]);
+    }
+    std::printf("\nSingle BiquadFilter, ns per stereo frame:\n");
+    std::printf("  %-28s %8.2f\n", "process() per sample", perSampleNs);
+    std::printf("  %-28s %8.2f\n", "processBlock()", blockNs);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,409 @@
+/**
+ * Microbenchmark suite for the DSP core
+ * Times BiquadFilter::process, Equalizer::processStereo and
+ * processInterleaved, and AudioProcessor::processInterleavedStereo over
+ * a sweep of block sizes (32-8192), channel counts, sample rates and
+ * presets, then the DspKernels hot loops (cascade, format conversion,
+ * interleave and clamp) once per kernel variant the CPU supports. Each
+ * case warms up, then takes timed samples of whole blocks and reports
+ * percentiles of ns per sample (one channel sample) and samples per
+ * second at the median, with the variant that ran it.
+ * The N-API processBuffer crossing is timed by bench/napi_bench.js in
+ * the same format.
+ *
+ * Build: node-gyp rebuild (target dsp_microbench)
+ * Run:   build/Release/dsp_microbench [--format=jsonl|csv|table]
+ *        [--filter=text] [--quick] [--samples=N] [--warmup-ms=N]
+ *        [--isa=scalar|baseline|sse4.1|avx2|avx512]
+ * --isa runs everything on one variant; otherwise the equalizer cases use
+ * the load-time choice and the kernel cases sweep all variants.
+ */
+
+#include "biquad_filter.h"
+#include "biquad_cascade.h"
+#include "equalizer.h"
+#include "audio_processor.h"
+#include "dsp_kernels.h"
+#include "denormals.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int BLOCK_SIZES[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+static const int QUICK_BLOCK_SIZES[] = { 32, 512, 8192 };
+static const double SAMPLE_RATES[] = { 44100.0, 48000.0, 96000.0 };
+static const char* const PRESETS[] = { "flat", "rock", "bass_boost" };
+static const int CHANNEL_COUNTS[] = { 1, 2, 6, 8 };
+static const int KERNEL_CHANNEL_COUNTS[] = { 2, 8 };
+static const int KERNEL_SECTIONS = 10;             // The 10-band equalizer's cascade
+
+static const double SAMPLE_TARGET_NS = 200000.0;   // Blocks per timed sample: at least 200 us
+
+struct Options {
+    enum Format { JSONL, CSV, TABLE };
+
+    Format format;
+    std::string filter;
+    bool quick;
+    int samples;
+    double warmupMs;
+    int isa;                    // DspKernels::Isa, or -1 for the load-time choice
+
+    Options() : format(JSONL), quick(false), samples(101), warmupMs(20.0), isa(-1) {}
+};
+
+// One benchmark case and its result
+struct Case {
+    const char* bench;
+    std::string preset;         // "-" where it does not apply
+    double sampleRate;
+    int channels;
+    int block;                  // Frames per call
+
+    double minNs = 0.0, p50Ns = 0.0;        // Per channel sample
+    double p90Ns = 0.0, p99Ns = 0.0;
+    const char* isa = "";                   // Kernel variant active while timed
+};
+
+// Processes one block of channels x block samples in place, interleaved
+// or one channel after another as the code under test takes them
+typedef std::function<void(float* buffer)> BlockFn;
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    double position = p * (sorted.size() - 1);
+    size_t below = (size_t)position;
+    size_t above = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (sorted[above] - sorted[below]) * (position - below);
+}
+
+// Warm up for warmupMs (caches, branch predictors, CPU clock, EQ ramps),
+// size a timed sample to SAMPLE_TARGET_NS, then take the samples. Each
+// block starts from the same noise, copied in as dsp_bench does.
+static void measure(Case& c, const Options& options, BlockFn process) {
+    size_t length = (size_t)c.block * c.channels;
+    std::vector<float> source(length), buffer(length);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (float& s : source) s = dist(rng);
+
+    typedef std::chrono::steady_clock Clock;
+    auto runBlocks = [&](long long blocks) {
+        auto start = Clock::now();
+        for (long long b = 0; b < blocks; b++) {
+            std::memcpy(buffer.data(), source.data(), length * sizeof(float));
+            process(buffer.data());
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    long long warmupBlocks = 0;
+    double warmupNs = 0.0;
+    while (warmupNs < options.warmupMs * 1e6 || warmupBlocks < 4) {
+        warmupNs += runBlocks(1);
+        warmupBlocks++;
+    }
+    long long blocksPerSample = std::max(1LL, (long long)(SAMPLE_TARGET_NS / (warmupNs / warmupBlocks)));
+
+    std::vector<double> nsPerSample(options.samples);
+    for (int s = 0; s < options.samples; s++) {
+        nsPerSample[s] = runBlocks(blocksPerSample) / ((double)blocksPerSample * length);
+    }
+    std::sort(nsPerSample.begin(), nsPerSample.end());
+    c.minNs = nsPerSample.front();
+    c.p50Ns = percentile(nsPerSample, 0.50);
+    c.p90Ns = percentile(nsPerSample, 0.90);
+    c.p99Ns = percentile(nsPerSample, 0.99);
+    c.isa = DspKernels::getIsaName(DspKernels::getActiveIsa());
+}
+
+static void printHeader(const Options& options) {
+    const char* precision =
+#if defined(EQ_SINGLE_PRECISION)
+        "float";
+#else
+        "double";
+#endif
+    switch (options.format) {
+        case Options::JSONL:
+            std::printf("{\"type\":\"meta\",\"kernel\":\"%s\",\"precision\":\"%s\",\"samples\":%d,"
+                        "\"warmup_ms\":%g,\"unit\":\"ns per channel sample\"}\n",
+                        BiquadCascade<EqualizerSample>::getKernelName(), precision, options.samples,
+                        options.warmupMs);
+            break;
+        case Options::CSV:
+            std::printf("# kernel %s, %s state, %d samples per case, %g ms warmup\n",
+                        BiquadCascade<EqualizerSample>::getKernelName(), precision, options.samples,
+                        options.warmupMs);
+            std::printf("bench,isa,preset,rate,channels,block,ns_min,ns_p50,ns_p90,ns_p99,samples_per_sec\n");
+            break;
+        case Options::TABLE:
+            std::printf("DSP microbenchmarks: kernel %s, %s state, %d samples per case, %g ms warmup\n",
+                        BiquadCascade<EqualizerSample>::getKernelName(), precision, options.samples,
+                        options.warmupMs);
+            std::printf("ns per channel sample; Msamples/s at the median\n\n");
+            std::printf("%-40s %-8s %-11s %6s %3s %5s %8s %8s %8s %8s %9s\n", "bench", "isa", "preset", "rate", "ch",
+                        "block", "min", "p50", "p90", "p99", "Msmp/s");
+            break;
+    }
+}
+
+static void printCase(const Case& c, const Options& options) {
+    double samplesPerSec = 1e9 / c.p50Ns;
+    switch (options.format) {
+        case Options::JSONL:
+            std::printf("{\"type\":\"result\",\"bench\":\"%s\",\"isa\":\"%s\",\"preset\":\"%s\",\"rate\":%g,\"channels\":%d,"
+                        "\"block\":%d,\"ns_min\":%.4f,\"ns_p50\":%.4f,\"ns_p90\":%.4f,\"ns_p99\":%.4f,"
+                        "\"samples_per_sec\":%.0f}\n",
+                        c.bench, c.isa, c.preset.c_str(), c.sampleRate, c.channels, c.block,
+                        c.minNs, c.p50Ns, c.p90Ns, c.p99Ns, samplesPerSec);
+            break;
+        case Options::CSV:
+            std::printf("%s,%s,%s,%g,%d,%d,%.4f,%.4f,%.4f,%.4f,%.0f\n", c.bench, c.isa, c.preset.c_str(), c.sampleRate,
+                        c.channels, c.block, c.minNs, c.p50Ns, c.p90Ns, c.p99Ns, samplesPerSec);
+            break;
+        case Options::TABLE:
+            std::printf("%-40s %-8s %-11s %6g %3d %5d %8.3f %8.3f %8.3f %8.3f %9.1f\n", c.bench, c.isa, c.preset.c_str(),
+                        c.sampleRate, c.channels, c.block, c.minNs, c.p50Ns, c.p90Ns, c.p99Ns,
+                        samplesPerSec / 1e6);
+            break;
+    }
+    std::fflush(stdout);
+}
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format=jsonl") {
+            options.format = Options::JSONL;
+        } else if (arg == "--format=csv") {
+            options.format = Options::CSV;
+        } else if (arg == "--format=table") {
+            options.format = Options::TABLE;
+        } else if (arg.compare(0, 9, "--filter=") == 0) {
+            options.filter = arg.substr(9);
+        } else if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg.compare(0, 10, "--samples=") == 0) {
+            options.samples = std::max(3, std::atoi(arg.c_str() + 10));
+        } else if (arg.compare(0, 12, "--warmup-ms=") == 0) {
+            options.warmupMs = std::max(0.0, std::atof(arg.c_str() + 12));
+        } else if (arg.compare(0, 6, "--isa=") == 0) {
+            DspKernels::Isa isa;
+            if (!DspKernels::parseIsa(arg.c_str() + 6, isa) || !DspKernels::isSupported(isa)) {
+                std::fprintf(stderr, "Kernel variant not available here: %s\n", arg.c_str() + 6);
+                return false;
+            }
+            options.isa = isa;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            std::fprintf(stderr, "Usage: dsp_microbench [--format=jsonl|csv|table] [--filter=text] "
+                                 "[--quick] [--samples=N] [--warmup-ms=N] [--isa=name]\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+    if (options.isa >= 0) DspKernels::setActiveIsa((DspKernels::Isa)options.isa);
+
+    // The processing entry points hold their own guard; the bare filter and
+    // equalizer run under one here, as on an audio thread
+    DenormalGuard denormals;
+
+    std::vector<int> blocks = options.quick
+        ? std::vector<int>(std::begin(QUICK_BLOCK_SIZES), std::end(QUICK_BLOCK_SIZES))
+        : std::vector<int>(std::begin(BLOCK_SIZES), std::end(BLOCK_SIZES));
+    auto selected = [&](const char* bench) {
+        return options.filter.empty() || std::string(bench).find(options.filter) != std::string::npos;
+    };
+
+    printHeader(options);
+
+    // BiquadFilter::process, one peaking filter per channel, per sample
+    if (selected("BiquadFilter::process")) {
+        for (double rate : SAMPLE_RATES) {
+            for (int block : blocks) {
+                BiquadFilter::Design design;
+                design.type = BiquadFilter::PEAKING;
+                design.frequency = 1000.0;
+                design.sampleRate = rate;
+                design.gainDB = 6.0;
+                design.Q = 1.0;
+                BiquadFilter filters[2];
+                for (BiquadFilter& filter : filters) filter.setDesign(design);
+
+                Case c = { "BiquadFilter::process", "-", rate, 2, block };
+                measure(c, options, [&](float* buffer) {
+                    for (int ch = 0; ch < 2; ch++) {
+                        float* samples = buffer + ch * block;
+                        for (int i = 0; i < block; i++) samples[i] = (float)filters[ch].process(samples[i]);
+                    }
+                });
+                printCase(c, options);
+            }
+        }
+    }
+
+    // Equalizer::processStereo, 10 bands, by preset and rate
+    if (selected("Equalizer::processStereo")) {
+        for (const char* preset : PRESETS) {
+            for (double rate : SAMPLE_RATES) {
+                for (int block : blocks) {
+                    std::unique_ptr<Equalizer> eq = Equalizer::create(Equalizer::DEFAULT_BANDS, rate);
+                    eq->setSmoothingTime(0.0);
+                    eq->applyPreset(preset);
+
+                    Case c = { "Equalizer::processStereo", preset, rate, 2, block };
+                    measure(c, options, [&](float* buffer) {
+                        eq->processStereo(buffer, buffer + block, block);
+                    });
+                    printCase(c, options);
+                }
+            }
+        }
+    }
+
+    // Equalizer::processInterleaved by channel count ("rock", 48 kHz)
+    if (selected("Equalizer::processInterleaved")) {
+        for (int channels : CHANNEL_COUNTS) {
+            for (int block : blocks) {
+                std::unique_ptr<Equalizer> eq = Equalizer::create(Equalizer::DEFAULT_BANDS, 48000.0);
+                eq->setSmoothingTime(0.0);
+                eq->applyPreset("rock");
+
+                Case c = { "Equalizer::processInterleaved", "rock", 48000.0, channels, block };
+                measure(c, options, [&](float* buffer) {
+                    eq->processInterleaved(buffer, channels, block);
+                });
+                printCase(c, options);
+            }
+        }
+    }
+
+    // AudioProcessor::processInterleavedStereo, the whole default chain
+    if (selected("AudioProcessor::processInterleavedStereo")) {
+        for (const char* preset : PRESETS) {
+            for (double rate : SAMPLE_RATES) {
+                for (int block : blocks) {
+                    AudioProcessor processor;
+                    processor.initialize(rate, block);
+                    processor.setEQSmoothingTime(0.0);
+                    processor.applyEQPreset(preset);
+
+                    Case c = { "AudioProcessor::processInterleavedStereo", preset, rate, 2, block };
+                    measure(c, options, [&](float* buffer) {
+                        processor.processInterleavedStereo(buffer, block * 2);
+                    });
+                    printCase(c, options);
+                }
+            }
+        }
+    }
+
+    // The kernels, straight from each variant's table (48 kHz noise)
+    DspKernels::Isa loaded = DspKernels::getActiveIsa();
+    std::vector<DspKernels::Isa> isas;
+    for (int isa = 0; isa < DspKernels::NUM_ISAS; isa++) {
+        if (options.isa >= 0 ? isa == options.isa : DspKernels::isSupported((DspKernels::Isa)isa)) {
+            isas.push_back((DspKernels::Isa)isa);
+        }
+    }
+
+    // DspKernels cascade, interleaved in place, 10 sections of the
+    // equalizer's precision
+    if (selected("DspKernels::cascade")) {
+        std::vector<EqualizerSample> coefficients(KERNEL_SECTIONS * 5);
+        for (int s = 0; s < KERNEL_SECTIONS; s++) {
+            BiquadFilter::Design design;
+            design.type = BiquadFilter::PEAKING;
+            design.frequency = 31.25 * (1 << s);
+            design.sampleRate = 48000.0;
+            design.gainDB = s % 2 ? 4.0 : -3.0;
+            design.Q = 1.4;
+            BiquadFilter::Coefficients k = BiquadFilter::calculateCoefficients(design);
+            EqualizerSample values[5] = { (EqualizerSample)k.b0, (EqualizerSample)k.b1, (EqualizerSample)k.b2,
+                                          (EqualizerSample)k.a1, (EqualizerSample)k.a2 };
+            std::copy(values, values + 5, &coefficients[s * 5]);
+        }
+        std::vector<EqualizerSample> history((DspKernels::MAX_SECTIONS + 1) * 2 * DspKernels::MAX_CHANNELS);
+        int fixed = DspKernels::getFixedIndex(KERNEL_SECTIONS);
+
+        for (DspKernels::Isa isa : isas) {
+            DspKernels::setActiveIsa(isa);
+            const DspKernels::CascadeKernels<EqualizerSample>& kernels =
+#if defined(EQ_SINGLE_PRECISION)
+                DspKernels::get().cascadeFloat;
+#else
+                DspKernels::get().cascadeDouble;
+#endif
+            for (int channels : KERNEL_CHANNEL_COUNTS) {
+                for (int block : blocks) {
+                    std::fill(history.begin(), history.end(), (EqualizerSample)0);
+                    DspKernels::CascadeArgs<EqualizerSample> args = {};
+                    args.coefficients = coefficients.data();
+                    args.numSections = KERNEL_SECTIONS;
+                    args.history = history.data();
+                    args.limit = (EqualizerSample)1;
+                    args.numChannels = channels;
+                    args.numSamples = block;
+                    args.frameStride = channels;
+
+                    Case c = { "DspKernels::cascade", "-", 48000.0, channels, block };
+                    measure(c, options, [&](float* buffer) {
+                        args.frames = buffer;
+                        kernels.run[DspKernels::INTERLEAVED][fixed](args);
+                    });
+                    printCase(c, options);
+                }
+            }
+        }
+    }
+
+    // Format conversion and the output clamp, one stereo block
+    if (selected("DspKernels::floatToInt16") || selected("DspKernels::int16ToFloat") ||
+        selected("DspKernels::interleaveClamp")) {
+        for (DspKernels::Isa isa : isas) {
+            DspKernels::setActiveIsa(isa);
+            const DspKernels::Table& table = DspKernels::get();
+            for (int block : blocks) {
+                std::vector<int16_t> pcm(block * 2);
+                std::vector<float> frames(block * 2);
+
+                if (selected("DspKernels::floatToInt16")) {
+                    Case c = { "DspKernels::floatToInt16", "-", 48000.0, 2, block };
+                    measure(c, options, [&](float* buffer) {
+                        table.floatToInt16(buffer, pcm.data(), block * 2);
+                    });
+                    printCase(c, options);
+                }
+                if (selected("DspKernels::int16ToFloat")) {
+                    table.floatToInt16(frames.data(), pcm.data(), block * 2);
+                    Case c = { "DspKernels::int16ToFloat", "-", 48000.0, 2, block };
+                    measure(c, options, [&](float* buffer) {
+                        table.int16ToFloat(pcm.data(), buffer, block * 2);
+                    });
+                    printCase(c, options);
+                }
+                if (selected("DspKernels::interleaveClamp")) {
+                    Case c = { "DspKernels::interleaveClamp", "-", 48000.0, 2, block };
+                    measure(c, options, [&](float* buffer) {
+                        table.interleaveClamp(buffer, buffer + block, frames.data(), block, 0.25f);
+                    });
+                    printCase(c, options);
+                }
+            }
+        }
+    }
+    DspKernels::setActiveIsa(loaded);
+    return 0;
+}
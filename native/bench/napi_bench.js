@@ -0,0 +1,163 @@
+/**
+ * Microbenchmark for the N-API processBuffer crossing
+ * The JavaScript half of bench/microbench.cpp: times processBuffer from
+ * Node over the same block sizes, sample rates and presets, with the same
+ * warmup, percentiles and output formats. Subtracting the matching
+ * AudioProcessor::processInterleavedStereo rows gives the cost of the
+ * crossing itself. The kernel variant is the one chosen at load; set
+ * EQ_KERNEL_ISA to compare against a microbench --isa run.
+ *
+ * Run: node bench/napi_bench.js [--format=jsonl|csv|table] [--quick]
+ *      [--samples=N] [--warmup-ms=N]
+ */
+
+const path = require('path');
+
+const BLOCK_SIZES = [32, 64, 128, 256, 512, 1024, 2048, 4096, 8192];
+const QUICK_BLOCK_SIZES = [32, 512, 8192];
+const SAMPLE_RATES = [44100, 48000, 96000];
+const PRESETS = ['flat', 'rock', 'bass_boost'];
+
+const SAMPLE_TARGET_NS = 200000;   // Blocks per timed sample: at least 200 us
+const BENCH = 'napi.processBuffer';
+
+function parseOptions(argv) {
+  const options = { format: 'jsonl', quick: false, samples: 101, warmupMs: 20 };
+  for (const arg of argv) {
+    if (arg === '--format=jsonl' || arg === '--format=csv' || arg === '--format=table') {
+      options.format = arg.slice(9);
+    } else if (arg === '--quick') {
+      options.quick = true;
+    } else if (arg.startsWith('--samples=')) {
+      options.samples = Math.max(3, parseInt(arg.slice(10), 10) || 0);
+    } else if (arg.startsWith('--warmup-ms=')) {
+      options.warmupMs = Math.max(0, parseFloat(arg.slice(12)) || 0);
+    } else {
+      console.error(`Unknown option: ${arg}`);
+      console.error('Usage: node bench/napi_bench.js [--format=jsonl|csv|table] [--quick] ' +
+                    '[--samples=N] [--warmup-ms=N]');
+      return null;
+    }
+  }
+  return options;
+}
+
+function percentile(sorted, p) {
+  const position = p * (sorted.length - 1);
+  const below = Math.floor(position);
+  const above = Math.min(below + 1, sorted.length - 1);
+  return sorted[below] + (sorted[above] - sorted[below]) * (position - below);
+}
+
+// Same shape as measure() in microbench.cpp: warm up, size a timed sample
+// to SAMPLE_TARGET_NS, take the samples, each block starting from the
+// same noise
+function measure(eq, block, options) {
+  const length = block * 2;
+  const source = new Float32Array(length);
+  const buffer = new Float32Array(length);
+  let seed = 7;
+  for (let i = 0; i < length; i++) {
+    seed = (seed * 1103515245 + 12345) >>> 0;
+    source[i] = seed / 4294967296 - 0.5;
+  }
+
+  const runBlocks = (blocks) => {
+    const start = process.hrtime.bigint();
+    for (let b = 0; b < blocks; b++) {
+      buffer.set(source);
+      eq.processBuffer(buffer);
+    }
+    return Number(process.hrtime.bigint() - start);
+  };
+
+  let warmupBlocks = 0;
+  let warmupNs = 0;
+  while (warmupNs < options.warmupMs * 1e6 || warmupBlocks < 4) {
+    warmupNs += runBlocks(1);
+    warmupBlocks++;
+  }
+  const blocksPerSample = Math.max(1, Math.floor(SAMPLE_TARGET_NS / (warmupNs / warmupBlocks)));
+
+  const nsPerSample = [];
+  for (let s = 0; s < options.samples; s++) {
+    nsPerSample.push(runBlocks(blocksPerSample) / (blocksPerSample * length));
+  }
+  nsPerSample.sort((a, b) => a - b);
+  return {
+    min: nsPerSample[0],
+    p50: percentile(nsPerSample, 0.50),
+    p90: percentile(nsPerSample, 0.90),
+    p99: percentile(nsPerSample, 0.99),
+  };
+}
+
+function printHeader(options) {
+  switch (options.format) {
+    case 'jsonl':
+      console.log(JSON.stringify({ type: 'meta', runtime: `node ${process.version}`, kernel: options.isa,
+                                   samples: options.samples, warmup_ms: options.warmupMs,
+                                   unit: 'ns per channel sample' }));
+      break;
+    case 'csv':
+      console.log(`# node ${process.version}, kernel ${options.isa}, ${options.samples} samples per case, ` +
+                  `${options.warmupMs} ms warmup`);
+      console.log('bench,isa,preset,rate,channels,block,ns_min,ns_p50,ns_p90,ns_p99,samples_per_sec');
+      break;
+    case 'table':
+      console.log(`N-API microbenchmarks: node ${process.version}, kernel ${options.isa}, ` +
+                  `${options.samples} samples per case, ${options.warmupMs} ms warmup`);
+      console.log('ns per channel sample; Msamples/s at the median\n');
+      console.log(`${'bench'.padEnd(40)} ${'isa'.padEnd(8)} ${'preset'.padEnd(11)} ${'rate'.padStart(6)} ${'ch'.padStart(3)} ` +
+                  `${'block'.padStart(5)} ${'min'.padStart(8)} ${'p50'.padStart(8)} ${'p90'.padStart(8)} ` +
+                  `${'p99'.padStart(8)} ${'Msmp/s'.padStart(9)}`);
+      break;
+  }
+}
+
+function printCase(c, options) {
+  const samplesPerSec = 1e9 / c.p50;
+  switch (options.format) {
+    case 'jsonl':
+      console.log(JSON.stringify({
+        type: 'result', bench: BENCH, isa: options.isa, preset: c.preset, rate: c.rate, channels: 2, block: c.block,
+        ns_min: +c.min.toFixed(4), ns_p50: +c.p50.toFixed(4), ns_p90: +c.p90.toFixed(4),
+        ns_p99: +c.p99.toFixed(4), samples_per_sec: Math.round(samplesPerSec),
+      }));
+      break;
+    case 'csv':
+      console.log([BENCH, options.isa, c.preset, c.rate, 2, c.block, c.min.toFixed(4), c.p50.toFixed(4), c.p90.toFixed(4),
+                   c.p99.toFixed(4), Math.round(samplesPerSec)].join(','));
+      break;
+    case 'table':
+      console.log(`${BENCH.padEnd(40)} ${options.isa.padEnd(8)} ${c.preset.padEnd(11)} ${String(c.rate).padStart(6)} ${'2'.padStart(3)} ` +
+                  `${String(c.block).padStart(5)} ${c.min.toFixed(3).padStart(8)} ${c.p50.toFixed(3).padStart(8)} ` +
+                  `${c.p90.toFixed(3).padStart(8)} ${c.p99.toFixed(3).padStart(8)} ` +
+                  `${(samplesPerSec / 1e6).toFixed(1).padStart(9)}`);
+      break;
+  }
+}
+
+function main() {
+  const options = parseOptions(process.argv.slice(2));
+  if (!options) return 2;
+
+  const eq = require(path.join(__dirname, '..', 'build', 'Release', 'audio_equalizer.node'));
+  options.isa = eq.getDspKernels().active;
+  const blocks = options.quick ? QUICK_BLOCK_SIZES : BLOCK_SIZES;
+
+  printHeader(options);
+  for (const preset of PRESETS) {
+    for (const rate of SAMPLE_RATES) {
+      for (const block of blocks) {
+        eq.initialize(rate, block);
+        eq.setSmoothingTime(0);
+        eq.applyPreset(preset);
+        printCase({ preset, rate, block, ...measure(eq, block, options) }, options);
+      }
+    }
+  }
+  return 0;
+}
+
+process.exitCode = main();
@@ -1,12 +1,43 @@
 {
+  "variables": {
+    "eq_single_precision%": "false"
+  },
+  "target_defaults": {
+    "conditions": [
+      ["eq_single_precision=='true'", {
+        "defines": [ "EQ_SINGLE_PRECISION" ]
+      }]
+    ]
+  },
   "targets": [
     {
       "target_name": "audio_equalizer",
+      "dependencies": [
+        "dsp_kernels_sse41",
+        "dsp_kernels_avx2",
+        "dsp_kernels_avx512"
+      ],
       "sources": [
         "src/equalizer.cpp",
+        "src/band_equalizer.cpp",
+        "src/graphic_equalizer.cpp",
+        "src/parametric_equalizer.cpp",
         "src/biquad_filter.cpp",
+        "src/biquad_cascade.cpp",
+        "src/dsp_kernels.cpp",
+        "src/dsp_kernels_baseline.cpp",
+        "src/coefficient_table.cpp",
         "src/audio_processor.cpp",
+        "src/automation_timeline.cpp",
+        "src/fft.cpp",
+        "src/convolution_engine.cpp",
+        "src/true_peak_limiter.cpp",
+        "src/multiband_compressor.cpp",
+        "src/sample_rate_converter.cpp",
+        "src/capture_pipeline.cpp",
         "src/system_audio_hook.cpp",
+        "src/processor_pool.cpp",
+        "src/batch_processor.cpp",
         "src/bindings.cpp"
       ],
       "include_dirs": [
@@ -43,6 +74,287 @@
           }
         }]
       ]
+    },
+    {
+      "target_name": "dsp_bench",
+      "type": "executable",
+      "dependencies": [
+        "dsp_kernels_sse41",
+        "dsp_kernels_avx2",
+        "dsp_kernels_avx512"
+      ],
+      "sources": [
+        "bench/dsp_bench.cpp",
+        "src/audio_processor.cpp",
+        "src/batch_processor.cpp",
+        "src/automation_timeline.cpp",
+        "src/equalizer.cpp",
+        "src/band_equalizer.cpp",
+        "src/graphic_equalizer.cpp",
+        "src/parametric_equalizer.cpp",
+        "src/biquad_filter.cpp",
+        "src/biquad_cascade.cpp",
+        "src/dsp_kernels.cpp",
+        "src/dsp_kernels_baseline.cpp",
+        "src/coefficient_table.cpp",
+        "src/fft.cpp",
+        "src/convolution_engine.cpp",
+        "src/true_peak_limiter.cpp",
+        "src/multiband_compressor.cpp",
+        "src/sample_rate_converter.cpp"
+      ],
+      "include_dirs": [
+        "include"
+      ],
+      "cflags!": [ "-fno-exceptions" ],
+      "cflags_cc!": [ "-fno-exceptions" ],
+      "conditions": [
+        ["OS=='linux'", {
+          "libraries": [ "-lpthread" ]
+        }],
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1
+            }
+          }
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "CLANG_CXX_LIBRARY": "libc++",
+            "MACOSX_DEPLOYMENT_TARGET": "10.13"
+          }
+        }]
+      ]
+    },
+    {
+      "target_name": "dsp_microbench",
+      "type": "executable",
+      "dependencies": [
+        "dsp_kernels_sse41",
+        "dsp_kernels_avx2",
+        "dsp_kernels_avx512"
+      ],
+      "sources": [
+        "bench/microbench.cpp",
+        "src/audio_processor.cpp",
+        "src/automation_timeline.cpp",
+        "src/equalizer.cpp",
+        "src/band_equalizer.cpp",
+        "src/graphic_equalizer.cpp",
+        "src/parametric_equalizer.cpp",
+        "src/biquad_filter.cpp",
+        "src/biquad_cascade.cpp",
+        "src/dsp_kernels.cpp",
+        "src/dsp_kernels_baseline.cpp",
+        "src/coefficient_table.cpp",
+        "src/fft.cpp",
+        "src/convolution_engine.cpp",
+        "src/true_peak_limiter.cpp",
+        "src/multiband_compressor.cpp",
+        "src/sample_rate_converter.cpp"
+      ],
+      "include_dirs": [
+        "include"
+      ],
+      "cflags!": [ "-fno-exceptions" ],
+      "cflags_cc!": [ "-fno-exceptions" ],
+      "conditions": [
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1
+            }
+          }
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "CLANG_CXX_LIBRARY": "libc++",
+            "MACOSX_DEPLOYMENT_TARGET": "10.13"
+          }
+        }]
+      ]
+    },
+    {
+      "target_name": "realtime_check",
+      "type": "executable",
+      "dependencies": [
+        "dsp_kernels_sse41",
+        "dsp_kernels_avx2",
+        "dsp_kernels_avx512"
+      ],
+      "sources": [
+        "test/realtime_check.cpp",
+        "src/realtime_check.cpp",
+        "src/capture_pipeline.cpp",
+        "src/audio_processor.cpp",
+        "src/automation_timeline.cpp",
+        "src/equalizer.cpp",
+        "src/band_equalizer.cpp",
+        "src/graphic_equalizer.cpp",
+        "src/parametric_equalizer.cpp",
+        "src/biquad_filter.cpp",
+        "src/biquad_cascade.cpp",
+        "src/dsp_kernels.cpp",
+        "src/dsp_kernels_baseline.cpp",
+        "src/coefficient_table.cpp",
+        "src/fft.cpp",
+        "src/convolution_engine.cpp",
+        "src/true_peak_limiter.cpp",
+        "src/multiband_compressor.cpp",
+        "src/sample_rate_converter.cpp"
+      ],
+      "include_dirs": [
+        "include"
+      ],
+      "defines": [
+        "EQ_REALTIME_CHECK"
+      ],
+      "cflags!": [ "-fno-exceptions" ],
+      "cflags_cc!": [ "-fno-exceptions" ],
+      "conditions": [
+        ["OS=='linux'", {
+          "libraries": [ "-ldl", "-lpthread" ]
+        }],
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1
+            }
+          }
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "CLANG_CXX_LIBRARY": "libc++",
+            "MACOSX_DEPLOYMENT_TARGET": "10.13"
+          }
+        }]
+      ]
+    },
+    {
+      "target_name": "kernel_conformance",
+      "type": "executable",
+      "dependencies": [
+        "dsp_kernels_sse41",
+        "dsp_kernels_avx2",
+        "dsp_kernels_avx512"
+      ],
+      "sources": [
+        "test/kernel_conformance.cpp",
+        "src/equalizer.cpp",
+        "src/band_equalizer.cpp",
+        "src/graphic_equalizer.cpp",
+        "src/parametric_equalizer.cpp",
+        "src/biquad_filter.cpp",
+        "src/biquad_cascade.cpp",
+        "src/dsp_kernels.cpp",
+        "src/dsp_kernels_baseline.cpp",
+        "src/coefficient_table.cpp"
+      ],
+      "include_dirs": [
+        "include"
+      ],
+      "cflags!": [ "-fno-exceptions" ],
+      "cflags_cc!": [ "-fno-exceptions" ],
+      "conditions": [
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1
+            }
+          }
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "CLANG_CXX_LIBRARY": "libc++",
+            "MACOSX_DEPLOYMENT_TARGET": "10.13"
+          }
+        }]
+      ]
+    },
+    {
+      "target_name": "dsp_kernels_sse41",
+      "type": "static_library",
+      "sources": [
+        "src/dsp_kernels_sse41.cpp"
+      ],
+      "include_dirs": [
+        "include"
+      ],
+      "cflags": [ "-fPIC", "-ffp-contract=off" ],
+      "conditions": [
+        ["target_arch=='x64' or target_arch=='ia32'", {
+          "cflags": [ "-msse4.1" ],
+          "xcode_settings": {
+            "OTHER_CPLUSPLUSFLAGS": [ "-msse4.1", "-ffp-contract=off" ]
+          },
+          "conditions": [
+            ["OS=='win'", {
+              "defines": [ "EQ_ASSUME_SSE41" ]
+            }]
+          ]
+        }]
+      ]
+    },
+    {
+      "target_name": "dsp_kernels_avx2",
+      "type": "static_library",
+      "sources": [
+        "src/dsp_kernels_avx2.cpp"
+      ],
+      "include_dirs": [
+        "include"
+      ],
+      "cflags": [ "-fPIC", "-ffp-contract=off" ],
+      "conditions": [
+        ["target_arch=='x64' or target_arch=='ia32'", {
+          "cflags": [ "-mavx2" ],
+          "xcode_settings": {
+            "OTHER_CPLUSPLUSFLAGS": [ "-mavx2", "-ffp-contract=off" ]
+          },
+          "conditions": [
+            ["OS=='win'", {
+              "msvs_settings": {
+                "VCCLCompilerTool": {
+                  "EnableEnhancedInstructionSet": "5"
+                }
+              }
+            }]
+          ]
+        }]
+      ]
+    },
+    {
+      "target_name": "dsp_kernels_avx512",
+      "type": "static_library",
+      "sources": [
+        "src/dsp_kernels_avx512.cpp"
+      ],
+      "include_dirs": [
+        "include"
+      ],
+      "cflags": [ "-fPIC", "-ffp-contract=off" ],
+      "conditions": [
+        ["target_arch=='x64' or target_arch=='ia32'", {
+          "cflags": [ "-mavx512f" ],
+          "xcode_settings": {
+            "OTHER_CPLUSPLUSFLAGS": [ "-mavx512f", "-ffp-contract=off" ]
+          },
+          "conditions": [
+            ["OS=='win'", {
+              "msvs_settings": {
+                "VCCLCompilerTool": {
+                  "AdditionalOptions": [ "/arch:AVX512" ]
+                }
+              }
+            }]
+          ]
+        }]
+      ]
     }
   ]
 }
@@ -2,45 +2,248 @@
 #define AUDIO_PROCESSOR_H
 
 #include "equalizer.h"
+#include "automation_timeline.h"
+#include "convolution_engine.h"
+#include "true_peak_limiter.h"
+#include "multiband_compressor.h"
+#include "sample_rate_converter.h"
+#include "parameter_channel.h"
+#include <atomic>
 #include <memory>
 #include <vector>
 
 /**
  * Audio Processor - Handles real-time audio stream processing
  * Manages buffer processing and EQ application
+ *
+ * Processing calls never allocate: buffers are filtered in place, and
+ * anything longer than the configured maximum block size is processed
+ * in maxBlockSize-frame chunks. They run with denormals flushed to zero
+ * (restored before returning to JavaScript).
+ *
+ * Automation: events scheduled at absolute frames (counted from
+ * initialize) are applied at exactly their frame; processing calls split
+ * their block at each event. The audio thread never waits for the EQ's
+ * parameter lock: an event that finds a control-thread change holding it
+ * is retried every Equalizer::SMOOTHING_INTERVAL frames.
+ *
+ * Stages: the same processing calls run the IIR equalizer, the
+ * convolution engine in its place (e.g. the EQ curve as a linear-phase
+ * FIR), or both in series (EQ plus room correction). Convolution adds
+ * getLatency() frames of delay.
+ *
+ * Dynamics: the multiband compressor, when enabled, runs on the same
+ * frames after the EQ/convolution stage.
+ *
+ * Output: the last stage clamps to [-1, 1] unless the true-peak limiter
+ * is on, in which case the stages run unclamped and the limiter (after
+ * everything else) keeps the output below its ceiling. Auto pre-gain
+ * lowers the limiter's input by the peak boost of the EQ curve.
+ *
+ * Streams: processStream() runs the same chain at the rate given to
+ * initialize (the processing rate) for sources at another rate,
+ * converting the input to it and the result to the output rate.
+ *
+ * Reconfiguring: reconfigure() moves a running processor to another
+ * sample rate or block size (an output device switch) without touching
+ * the audio thread's memory. Band gains, presets, enabled flags, the
+ * compressor, limiter and stream settings all carry over; each stage
+ * recomputes its coefficients, and anything new is allocated and
+ * published before the audio thread sees it.
  */
 class AudioProcessor {
 public:
+    static const int DEFAULT_MAX_BLOCK_SIZE = 4096;
+    static const int DEFAULT_LINEAR_PHASE_TAPS = 8192;
+    
+    enum Stage {
+        STAGE_EQ,                   // IIR equalizer (default)
+        STAGE_CONVOLUTION,          // Convolution engine in place of the EQ
+        STAGE_EQ_CONVOLUTION        // EQ, then convolution
+    };
+
     AudioProcessor();
     ~AudioProcessor();
 
-    // Initialize with sample rate
-    void initialize(double sampleRate);
+    // Initialize with sample rate, the largest block the caller will push
+    // and the EQ layout (5, 10 or 31 graphic bands, or Equalizer::PARAMETRIC)
+    void initialize(double sampleRate, int maxBlockSize = DEFAULT_MAX_BLOCK_SIZE,
+                    int numBands = Equalizer::DEFAULT_BANDS);
+    int getMaxBlockSize() const;
+    int getLayout() const;
+    
+    // Initialize with every setting back at a new processor's defaults
+    // (stages, limiter, compressor, IR and convolution layout), reusing the
+    // memory already held: a recycled processor costs microseconds where
+    // constructing one costs about a millisecond. Nothing may be processing.
+    void reset(double sampleRate, int maxBlockSize = DEFAULT_MAX_BLOCK_SIZE,
+               int numBands = Equalizer::DEFAULT_BANDS);
+    
+    // Change the processing rate and, if maxBlockSize > 0, the block size
+    // while keeping every setting; safe while another thread processes.
+    // A linear-phase EQ is redesigned for the new rate, a loaded impulse
+    // response is kept as it is, and stream rates too far from the new
+    // processing rate fall back to pass-through. Initializes if needed.
+    bool reconfigure(double sampleRate, int maxBlockSize = 0);
+    double getSampleRate() const;
     
-    // Process interleaved stereo audio buffer
+    // Process interleaved stereo audio buffer in place
     void processInterleavedStereo(float* buffer, int numSamples);
     
     // Process separate stereo channels
     void processSeparateChannels(float* leftChannel, float* rightChannel, int numSamples);
     
+    // Sample-rate conversion around the chain (control thread; the new
+    // converters are published to the audio thread at its next call). A
+    // rate equal to the processing rate skips its converter; initialize
+    // resets both.
+    bool setStreamRates(double inputRate, double outputRate,
+                        SampleRateConverter::Quality quality = SampleRateConverter::QUALITY_MEDIUM);
+    
+    // Convert numFrames interleaved stereo frames from the input rate,
+    // process them and convert to the output rate. Returns the frames
+    // written to output (at most getMaxStreamFrames(numFrames)); output
+    // must not overlap input.
+    int processStream(const float* input, int numFrames, float* output);
+    int getMaxStreamFrames(int numFrames) const;
+    
+    // Delay through conversion and processing, in output-rate frames
+    double getStreamLatency() const;
+    
     // EQ control
     void setEQBandGain(int bandIndex, double gainDB);
     double getEQBandGain(int bandIndex);
     void applyEQPreset(const std::string& presetName);
+    void applyEQPreset(int presetId);
+    void morphEQToPreset(int presetId, double milliseconds);
+    void morphEQPresets(int fromPresetId, int toPresetId, double amount, double milliseconds);
+    void morphEQToCurve(const double* gainsDB, int numGains, double milliseconds);
     void resetEQ();
     void setEQEnabled(bool enabled);
     bool isEQEnabled();
+    void setEQSmoothingTime(double milliseconds);
+    
+    // Parametric EQ band editing (refused by graphic layouts)
+    int addEQBand(const BiquadFilter::Design& design);
+    bool removeEQBand(int bandIndex);
+    bool setEQBand(int bandIndex, const BiquadFilter::Design& design);
+    bool getEQBand(int bandIndex, BiquadFilter::Design& design);
     
     // Get EQ band frequencies
     std::vector<double> getBandFrequencies();
     
+    // Automation (control thread): false if the queue is full
+    bool scheduleAutomation(const AutomationEvent& event);
+    int getAutomationSpace() const;
+    
+    // Frames processed since initialize
+    long long getFramePosition() const;
+    
+    // Convolution (control thread). Changing the latency, or loading an IR
+    // longer than the current layout, re-lays out the engine: the new
+    // layout is built here and adopted by the audio thread at its next
+    // block, starting from silence.
+    bool setConvolutionLatency(int latency);
+    bool loadImpulseResponse(const float* left, const float* right, int numTaps);
+    
+    // Design a linear-phase FIR (numTaps, a power of two) from the EQ's
+    // current gain curve, load it and switch to STAGE_CONVOLUTION. Later
+    // EQ changes need another call.
+    bool useLinearPhaseEQ(int numTaps = DEFAULT_LINEAR_PHASE_TAPS);
+    
+    // False for a convolution stage with no IR loaded
+    bool setStage(Stage stage);
+    Stage getStage() const;
+    
+    // Frames of delay added by the current stage (engine latency, plus
+    // half the FIR for a linear-phase EQ) and the limiter's lookahead
+    int getLatency() const;
+    
+    // True-peak limiter in place of the hard clamp (off by default: it
+    // adds TruePeakLimiter lookahead latency)
+    void setLimiterEnabled(bool enabled);
+    bool isLimiterEnabled() const;
+    void setLimiterCeiling(double dBTP);
+    void setLimiterRelease(double milliseconds);
+    
+    // Multiband compressor after the EQ/convolution stage (off by default)
+    void setCompressorEnabled(bool enabled);
+    bool isCompressorEnabled() const;
+    bool setCompressorBands(int numBands, const double* crossovers = nullptr);
+    bool setCompressorBand(int band, const MultibandCompressor::BandSettings& settings);
+    bool getCompressorBand(int band, MultibandCompressor::BandSettings& settings) const;
+    int getCompressorBandCount() const;
+    double getCompressorGainReduction(int band) const;
+    
+    // Pre-gain of -(peak EQ boost) ahead of the limiter. EQ setters
+    // recompute it while the limiter runs; otherwise it is worked out when
+    // the limiter starts or the value is read. Curves changed by
+    // automation events are picked up by refreshPreGain() (also called by
+    // scheduleAutomation), from the control thread after processing.
+    void setAutoPreGain(bool enabled);
+    double getPreGainDB();
+    void refreshPreGain();
+    
 private:
     std::unique_ptr<Equalizer> equalizer;
-    double sampleRate;
+    std::atomic<double> sampleRate;     // reconfigure() may run while another thread processes
+    std::atomic<int> maxBlockSize;
+    int layout;                         // numBands given to initialize
     bool initialized;
     
-    std::vector<float> leftBuffer;
-    std::vector<float> rightBuffer;
+    AutomationTimeline automation;
+    std::atomic<long long> framePosition;
+    
+    ConvolutionEngine convolution;
+    std::atomic<int> stage;
+    int linearPhaseDelay;               // Peak position of a linear-phase EQ IR
+    
+    MultibandCompressor compressor;
+    std::atomic<bool> compressing;
+    
+    TruePeakLimiter limiter;
+    std::atomic<bool> limiting;
+    bool autoPreGain;
+    std::atomic<bool> preGainStale;     // Curve changed since the pre-gain was computed
+    
+    // Converters for one set of stream rates, built on the control thread
+    // and handed to processStream() whole
+    struct Stream {
+        SampleRateConverter input;
+        SampleRateConverter output;
+        bool convertingInput;
+        bool convertingOutput;
+        double rate;                    // Processing rate
+        int chunk;                      // Input frames per pass (converted fits the block size)
+        std::vector<float> buffer;      // Interleaved stereo at the processing rate
+    };
+    ParameterChannel<std::unique_ptr<Stream>> streams;
+    Stream* stream;                     // Control thread: the last one published
+    double streamInputRate;
+    double streamOutputRate;
+    SampleRateConverter::Quality streamQuality;
+    
+    void publishStream();
+    
+    // Run process(offset, count) over the block in chunks of at most
+    // maxBlockSize frames, applying automation events between chunks
+    template <typename Process>
+    void processTimeline(int numFrames, Process process);
+    // False if the equalizer's parameter lock was busy (nothing applied)
+    bool applyAutomation(const AutomationEvent& event);
+    
+    // Clamp only at the last stage before the output (none with the
+    // limiter). Called with the new state after a stage switches on and
+    // before one switches off, so the output is never left unclamped.
+    void updateOutputClamps(bool compressed, bool limited);
+    
+    // Design the linear-phase FIR for the EQ curve and load it
+    bool loadLinearPhaseEQ(int numTaps);
+    
+    // Peak |H| of the EQ curve (1 when flat or disabled)
+    double peakMagnitude();
+    void updatePreGain();
+    void computePreGain();
 };
 
 #endif // AUDIO_PROCESSOR_H
@@ -0,0 +1,61 @@
+#ifndef AUTOMATION_TIMELINE_H
+#define AUTOMATION_TIMELINE_H
+
+#include "event_queue.h"
+
+// One scheduled parameter change
+struct AutomationEvent {
+    enum Type {
+        BAND_GAIN,      // band, value = gain in dB
+        ENABLED,        // value = 0 or 1
+        PRESET          // value = preset ID (Equalizer::findPreset)
+    };
+
+    long long frame;    // Absolute frame on the processor's timeline
+    int type;
+    int band;
+    double value;
+};
+
+/**
+ * Automation Timeline
+ * Events scheduled by the control thread at absolute frame positions,
+ * handed to the processing thread through a lock-free EventQueue. The
+ * processing side keeps them sorted by frame (FIFO for equal frames) in
+ * fixed storage and tells the caller where to split its block so each
+ * event lands on exactly its frame. Nothing allocates or blocks.
+ */
+class AutomationTimeline {
+public:
+    static const int CAPACITY = 1024;
+
+    AutomationTimeline();
+
+    // Control thread: queue an event; false if the queue is full
+    bool schedule(const AutomationEvent& event);
+    int getSpace() const;
+
+    // Processing thread: take newly scheduled events; call once per block
+    void collect();
+
+    // Processing thread: next event due at or before position, if any
+    bool nextDue(long long position, AutomationEvent& event);
+
+    // Processing thread: put back the event nextDue just returned, to be
+    // returned again first
+    void restore(const AutomationEvent& event);
+
+    // Processing thread: frames from position to the next event, at most limit
+    int framesUntilNext(long long position, int limit) const;
+
+    // Processing thread: drop every scheduled event
+    void clear();
+
+private:
+    EventQueue<AutomationEvent, CAPACITY> queue;
+    AutomationEvent pending[CAPACITY];  // Sorted by frame in [first, last)
+    int first;
+    int last;
+};
+
+#endif // AUTOMATION_TIMELINE_H
@@ -0,0 +1,172 @@
+#ifndef BAND_EQUALIZER_H
+#define BAND_EQUALIZER_H
+
+#include "equalizer.h"
+#include "biquad_filter.h"
+#include "biquad_cascade.h"
+#include "coefficient_table.h"
+#include "parameter_channel.h"
+#include <mutex>
+
+/**
+ * Band Equalizer Engine
+ * Shared core of the graphic and parametric equalizers: up to MaxBands
+ * band slots, each holding one biquad design, run as one SIMD cascade.
+ *
+ * Threading: the setters run on a control thread (JS), the process calls
+ * on an audio thread. Setters compute coefficients and publish a complete
+ * snapshot through a lock-free ParameterChannel; the audio thread adopts
+ * the newest snapshot at the start of each block, so a preset always
+ * lands as a whole on one block boundary. Process calls never block or
+ * allocate.
+ *
+ * Gain changes ramp over the smoothing time instead of jumping. Gains move
+ * linearly in dB, which is geometric in the RBJ amplitude A = 10^(dB/40),
+ * so the audio thread steps A with one multiply and redesigns the band
+ * from its precomputed prototype (no trigonometry) every
+ * SMOOTHING_INTERVAL samples. Settled bands cost nothing. Preset morphs
+ * are the same ramps with their own duration, so they cost no more.
+ *
+ * Execution plan: the cascade only holds sections that do something.
+ * Shelf and peaking bands settled at 0 dB are identity filters and are
+ * dropped; a band leaving 0 dB is inserted as an identity section and
+ * ramps up from there. Insertion and removal keep the surrounding filter
+ * history, so the plan changes without a click. Sections stay in slot
+ * order, each channel in its own SIMD lane. With an empty plan (every
+ * band flat) or the EQ disabled, blocks pass through untouched; the
+ * cascade only records the last input samples so bands can come back in
+ * without a step.
+ *
+ * Silence: once the filter history has decayed below SILENCE_THRESHOLD,
+ * silent input blocks are bypassed the same way, which also flushes the
+ * tail before it can reach the (slow) denormal range.
+ */
+template <int MaxBands>
+class BandEqualizer : public Equalizer {
+public:
+    static constexpr int MAX_BANDS = MaxBands;
+
+    void processStereo(float* leftChannel, float* rightChannel, int numSamples) override;
+    void processInterleaved(float* buffer, int numChannels, int numFrames) override;
+    void setBandGain(int bandIndex, double gainDB) override;
+    double getBandGain(int bandIndex) const override;
+    using Equalizer::applyPreset;
+    void applyPreset(int presetId) override;
+    void morphToPreset(int presetId, double milliseconds) override;
+    void morphPresets(int fromPresetId, int toPresetId, double amount, double milliseconds) override;
+    void morphToCurve(const double* gainsDB, int numGains, double milliseconds) override;
+    void reset() override;
+    void setEnabled(bool enabled) override;
+    bool isEnabled() const override;
+    bool trySetBandGain(int bandIndex, double gainDB) override;
+    bool trySetEnabled(bool enabled) override;
+    bool tryApplyPreset(int presetId) override;
+    void setOutputClamp(bool enabled) override;
+    void setSampleRate(double sampleRate) override;
+    double getSampleRate() const override;
+    void setSmoothingTime(double milliseconds) override;
+    double getSmoothingTime() const override;
+    int getNumBands() const override;
+    const double* getBandFrequencies() const override;
+    bool getBand(int bandIndex, BiquadFilter::Design& design) const override;
+
+    // Sections currently in the cascade (audio thread)
+    int getActiveSectionCount() const;
+
+protected:
+    BandEqualizer(double sampleRate);
+    ~BandEqualizer();
+
+    // Control thread; callers hold controlMutex and publish() afterwards
+    void assignBand(int slot, const BiquadFilter::Design& design);
+    void releaseBand(int slot);
+    bool setSlotGain(int slot, double gainDB, double rampMs = -1.0);
+    int slotOf(int bandIndex) const;        // -1 if out of range
+    bool isSlotUsed(int slot) const;
+    void publish();
+
+    mutable std::mutex controlMutex;        // Getters too: the try-setters write from the audio thread
+    double sampleRate;
+
+private:
+    enum SlotMode {
+        SLOT_EMPTY,         // Not in the plan
+        SLOT_GAIN,          // Shelf/peaking: identity at 0 dB, gain ramps
+        SLOT_FIXED          // Pass/notch/all-pass: always in the plan
+    };
+
+    // One slot as the audio thread sees it
+    struct SlotParams {
+        double coefficients[5];             // b0, b1, b2, a1, a2 at the target gain
+        BiquadFilter::Prototype prototype;
+        double gainDB;
+        double rampMs;                      // Ramp time of the last gain change; < 0 = smoothing time
+        int mode;
+    };
+
+    // Everything the audio thread needs, published as one unit
+    struct Snapshot {
+        SlotParams slots[MaxBands];
+        double sampleRate;                  // Ramp step counts
+        double smoothingMs;
+        bool enabled;
+        bool clamp;                         // Output clamped to [-1, 1]
+        unsigned resetCount;                // Bumped when filter history must be cleared
+    };
+
+    // Gain ramp of one slot (audio thread)
+    struct Ramp {
+        double gainDB;          // Current gain
+        double targetDB;
+        double stepDB;          // Gain change per update
+        double amplitude;       // Current A = 10^(gainDB / 40)
+        double ratio;           // A multiplier per update
+        int stepsLeft;
+    };
+
+    // Control thread
+    BiquadFilter::Design designs[MaxBands];
+    double requestedFrequencies[MaxBands];      // Before the Nyquist limit
+    const CoefficientTable* tables[MaxBands];  // Shared per design; nullptr = calculate
+    bool used[MaxBands];
+    double frequencies[MaxBands];               // Used bands, in band order
+    double presetGains[NUM_PRESETS][MaxBands];  // Per slot, resolved when the band is assigned
+    int numBands;
+    Snapshot staging;
+
+    // Control -> audio
+    ParameterChannel<Snapshot> parameters;
+
+    // Audio thread
+    BiquadCascade<EqualizerSample, MaxBands> cascade;   // Coefficients + state (hot)
+    bool audioEnabled;
+    unsigned audioResetCount;
+    Ramp ramps[MaxBands];
+    int positions[MaxBands];                    // Cascade section of each slot, -1 = pruned
+    bool ramping;
+    int samplesToUpdate;
+
+    // Setter bodies; callers hold controlMutex
+    void changeBandGain(int bandIndex, double gainDB);
+    void changeEnabled(bool enabled);
+    void changePresets(int fromPresetId, int toPresetId, double amount, double milliseconds);
+
+    void updateCoefficients(int slot);
+    void updateFrequencies();
+    void pullParameters();
+    void updatePlan();
+    void loadSection(int slot);
+    void advanceRamps();
+    void settleRamps();
+
+    // Run process(offset, count) over the block, split at ramp updates
+    template <typename Process>
+    void processSmoothed(int numFrames, Process process);
+};
+
+extern template class BandEqualizer<5>;
+extern template class BandEqualizer<10>;
+extern template class BandEqualizer<31>;
+extern template class BandEqualizer<32>;
+
+#endif // BAND_EQUALIZER_H
@@ -0,0 +1,54 @@
+#ifndef BAND_LAYOUT_H
+#define BAND_LAYOUT_H
+
+#include "biquad_filter.h"
+
+/**
+ * Graphic EQ band layouts, fixed at compile time
+ * Each layout gives the band centre frequencies and the Q shared by its
+ * bands. Topology is the same for every layout: low shelf on the first
+ * band, high shelf on the last, peaking in between.
+ */
+template <int NBands>
+struct BandLayout;
+
+// Two-octave spacing
+template <>
+struct BandLayout<5> {
+    static constexpr double FREQUENCIES[5] = {
+        60.0, 250.0, 1000.0, 4000.0, 16000.0
+    };
+    static constexpr double Q = 0.7;
+};
+
+// Octave spacing (the original 10-band layout)
+template <>
+struct BandLayout<10> {
+    static constexpr double FREQUENCIES[10] = {
+        31.0, 62.0, 125.0, 250.0, 500.0,
+        1000.0, 2000.0, 4000.0, 8000.0, 16000.0
+    };
+    static constexpr double Q = 1.0;
+};
+
+// ISO 266 third-octave centres
+template <>
+struct BandLayout<31> {
+    static constexpr double FREQUENCIES[31] = {
+        20.0, 25.0, 31.5, 40.0, 50.0, 63.0, 80.0, 100.0,
+        125.0, 160.0, 200.0, 250.0, 315.0, 400.0, 500.0, 630.0,
+        800.0, 1000.0, 1250.0, 1600.0, 2000.0, 2500.0, 3150.0, 4000.0,
+        5000.0, 6300.0, 8000.0, 10000.0, 12500.0, 16000.0, 20000.0
+    };
+    static constexpr double Q = 4.3;
+};
+
+// Filter type of a band in an NBands layout
+template <int NBands>
+constexpr BiquadFilter::FilterType bandType(int band) {
+    return band == 0 ? BiquadFilter::LOWSHELF
+         : band == NBands - 1 ? BiquadFilter::HIGHSHELF
+         : BiquadFilter::PEAKING;
+}
+
+#endif // BAND_LAYOUT_H
@@ -0,0 +1,91 @@
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include "equalizer.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Batch Processor - many independent clips EQ'd across cores
+ * Each job is one interleaved stereo buffer with a preset or a gain curve,
+ * processed in place from clean filter history, as a new equalizer would.
+ *
+ * Work stealing: a batch's jobs are dealt out longest first, round robin,
+ * to the deques of the pool threads it may use. Each thread takes from the
+ * front of its own deque and, once that is empty, steals from the back of
+ * the others (jobs of batches it may run), so the short jobs left at the
+ * end even out the load. A job is never split: its filter history is
+ * serial.
+ *
+ * Every thread keeps its own Equalizer and reuses it from job to job. The
+ * coefficients come from the shared CoefficientTable registry, immutable
+ * once built, so switching presets per job is a table lookup and threads
+ * share nothing they write.
+ *
+ * Threading: process() runs on any control thread (the bindings call it on
+ * a libuv pool thread), queues its jobs and sleeps until they are done.
+ * Concurrent batches share the pool: their jobs sit in the same deques and
+ * each call returns as soon as its own count of jobs reaches zero, rather
+ * than waiting for the batches queued before it.
+ */
+class BatchProcessor {
+public:
+    struct Job {
+        float* buffer;                  // Interleaved stereo, processed in place
+        int numFrames;
+        int presetId;                   // Preset to apply; < 0 = gains
+        std::vector<double> gains;      // One per band, in dB
+    };
+
+    // numThreads pool threads; 0 = one per hardware thread
+    explicit BatchProcessor(int numThreads = 0);
+    ~BatchProcessor();                  // No process() call may be running
+
+    // Process every job on up to maxThreads threads (0 = all)
+    void process(std::vector<Job>& jobs, double sampleRate, int numBands, int maxThreads = 0);
+
+    int getNumThreads() const;
+
+private:
+    // One process() call, on the caller's stack
+    struct Batch {
+        std::vector<Job>* jobs;
+        double sampleRate;
+        int numBands;
+        int participants;                       // Pool threads 0 .. participants - 1 run its jobs
+        int remaining;                          // Jobs not finished yet (stateMutex)
+        std::condition_variable finished;
+    };
+
+    struct Task {
+        Batch* batch;
+        int job;
+    };
+
+    // One pool thread
+    struct Worker {
+        std::mutex mutex;                       // Guards queue (owner and thieves)
+        std::deque<Task> queue;
+        std::unique_ptr<Equalizer> equalizer;   // Only this thread uses it
+        int equalizerBands;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // Batch arrivals and completions
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    unsigned generation;                        // Bumped when a batch is queued
+    bool stopping;
+
+    void threadMain(int index);
+    bool take(int index, Task& task);
+    void run(Worker& worker, const Task& task);
+};
+
+#endif // BATCH_PROCESSOR_H
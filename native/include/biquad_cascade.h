@@ -0,0 +1,117 @@
+#ifndef BIQUAD_CASCADE_H
+#define BIQUAD_CASCADE_H
+
+#include "dsp_kernels.h"
+
+/**
+ * Cascaded Biquad Kernel
+ * Runs a chain of biquad sections over several channels at once, one
+ * channel per SIMD lane, through the kernel variant DspKernels chose for
+ * this CPU (SSE4.1/AVX2/AVX-512 on x86, NEON on AArch64). The scalar
+ * reference variant produces bit-identical output.
+ *
+ * Sections share their history: the output history of section k is the
+ * input history of section k+1, so a cascade of N sections only keeps
+ * N+1 history pairs per channel. All storage is fixed-size.
+ *
+ * T is the coefficient/state precision (float or double). NSections > 0
+ * fixes the capacity at compile time: storage is sized exactly and the
+ * per-sample section loop is fully unrolled for every count with its own
+ * kernel (DspKernels::FIXED_SECTIONS), NSections itself included. 0 keeps
+ * a runtime count of up to MAX_SECTIONS on the runtime kernel.
+ */
+template <typename T, int NSections = 0>
+class BiquadCascade {
+public:
+    static constexpr int MAX_SECTIONS = NSections > 0 ? NSections : DspKernels::MAX_SECTIONS;
+    static constexpr int MAX_CHANNELS = DspKernels::MAX_CHANNELS;
+
+    BiquadCascade(int numSections = NSections);
+    ~BiquadCascade();
+
+    // Configure the number of sections (resets history)
+    void setNumSections(int numSections);
+    int getNumSections() const;
+
+    // Set normalized coefficients for a section (a0 == 1)
+    void setSection(int index, double b0, double b1, double b2, double a1, double a2);
+
+    // Insert an identity section before index. Its output history starts as
+    // a copy of its input history, so the output continues without a step.
+    void insertSection(int index);
+
+    // Remove a section; seamless when the section is (close to) identity
+    void removeSection(int index);
+
+    // Process two separate channels in place, clamping output to [-1, 1]
+    // unless clamping is off
+    void processStereo(float* leftChannel, float* rightChannel, int numSamples);
+
+    // Process up to MAX_CHANNELS separate channels in place
+    void process(float* const* channels, int numChannels, int numSamples);
+
+    // Process up to MAX_CHANNELS channels from input to output (may alias)
+    void processBlock(const float* const* input, float* const* output,
+                      int numChannels, int numSamples);
+
+    // Process interleaved frames in place; channels beyond MAX_CHANNELS pass through
+    void processInterleaved(float* buffer, int numChannels, int numFrames);
+
+    // Process the first channels of interleaved frames into separate
+    // channel buffers (a band split reading the caller's buffer directly)
+    void processInterleavedTo(const float* buffer, int numChannels, float* const* output,
+                              int numOutputs, int numFrames);
+
+    // Let a block pass unfiltered (no per-sample work, no clamping). Every
+    // node takes the block's last input samples as its history, as if all
+    // sections were identity, so filtering can resume without a step.
+    void bypassStereo(const float* leftChannel, const float* rightChannel, int numSamples);
+    void bypassInterleaved(const float* buffer, int numChannels, int numFrames);
+
+    // Clear filter history
+    void reset();
+
+    // True when all history is below threshold in magnitude: the tail has
+    // died away and, with silent input, the output would be silent too
+    bool isQuiet(double threshold) const;
+
+    // Clamp output to [-1, 1] (default), or leave the range to a limiter
+    // further down the chain. The bound is a kernel operand, so both cost
+    // the same.
+    void setClampEnabled(bool enabled);
+    bool isClampEnabled() const;
+
+    // Select the active kernel variant or the scalar reference (for verification)
+    void setSimdEnabled(bool enabled);
+    bool isSimdEnabled() const;
+
+    // Cap the kernel variant, e.g. at AVX2 for a cascade with too few
+    // channels to fill 512-bit lanes (default: no cap)
+    void setWidestIsa(DspKernels::Isa isa);
+    DspKernels::Isa getWidestIsa() const;
+
+    // Name of the active kernel variant ("avx2", "baseline", ...; see DspKernels)
+    static const char* getKernelName();
+
+private:
+    // b0, b1, b2, a1, a2 per section
+    alignas(64) T coefficients[MAX_SECTIONS * 5];
+
+    // z1/z2 per node per channel: [(node * 2 + k) * MAX_CHANNELS + channel]
+    alignas(64) T history[(MAX_SECTIONS + 1) * 2 * MAX_CHANNELS];
+
+    int numSections;
+    bool simdEnabled;
+    DspKernels::Isa widestIsa;
+    T outputLimit;          // Clamp bound; max() when clamping is off
+
+    // Fill in the cascade state and run the unrolled kernel for the
+    // current section count, or the runtime one
+    void run(DspKernels::Layout layout, DspKernels::CascadeArgs<T>& args);
+
+    // Bypass helpers: input history of one channel, then copy to every node
+    void trackInput(int channel, const float* samples, int stride, int numSamples);
+    void copyInputHistory();
+};
+
+#endif // BIQUAD_CASCADE_H
@@ -3,16 +3,92 @@
 
 #include <cmath>
 
+/**
+ * Hot-path biquad section
+ * Normalized coefficients and Direct Form II Transposed state packed into
+ * one cache line (7 values: 28 bytes as float, 56 bytes as double).
+ * Templated on the state precision so builds can pick float or double.
+ */
+template <typename T>
+struct alignas(64) BiquadSection {
+    T b0, b1, b2, a1, a2;   // Coefficients (a0 == 1)
+    T z1, z2;               // State
+
+    BiquadSection() : b0(1), b1(0), b2(0), a1(0), a2(0), z1(0), z2(0) {}
+
+    void setCoefficients(double nb0, double nb1, double nb2, double na1, double na2) {
+        b0 = static_cast<T>(nb0);
+        b1 = static_cast<T>(nb1);
+        b2 = static_cast<T>(nb2);
+        a1 = static_cast<T>(na1);
+        a2 = static_cast<T>(na2);
+    }
+
+    inline T process(T x) {
+        T y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+
+    // Filter a block; input and output may alias
+    void processBlock(const float* input, float* output, int numSamples) {
+        T s1 = z1, s2 = z2;
+        for (int i = 0; i < numSamples; i++) {
+            T x = input[i];
+            T y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            output[i] = static_cast<float>(y);
+        }
+        z1 = s1;
+        z2 = s2;
+    }
+
+    void reset() {
+        z1 = z2 = 0;
+    }
+};
+
 /**
  * Professional Biquad Filter Implementation
- * Used for parametric EQ bands
+ * Used for parametric EQ bands. Design parameters are kept apart from the
+ * hot coefficient/state section so per-sample code never touches them.
  */
 class BiquadFilter {
 public:
     enum FilterType {
         LOWSHELF,
         HIGHSHELF,
-        PEAKING
+        PEAKING,
+        LOWPASS,
+        HIGHPASS,
+        NOTCH,
+        ALLPASS
+    };
+
+    // Design parameters (cold - only read when coefficients change)
+    struct Design {
+        FilterType type;
+        double frequency;
+        double sampleRate;
+        double gainDB;
+        double Q;
+
+        Design();
+    };
+
+    // Normalized coefficients (a0 == 1)
+    struct Coefficients {
+        double b0, b1, b2, a1, a2;
+    };
+
+    // Design with the trigonometry done; only the gain is left free
+    struct Prototype {
+        FilterType type;
+        double sn, cs;      // sin/cos of the normalized frequency
+        double alpha;       // sn / (2Q)
+        double Q;
     };
 
     BiquadFilter();
@@ -24,26 +100,41 @@ public:
     void setGain(double gainDB);
     void setQ(double q);
 
+    // Set all parameters at once (one recompute)
+    void setDesign(const Design& design);
+
     // Process audio sample
     double process(double input);
 
+    // Process a block of samples; input and output may alias
+    void processBlock(const float* input, float* output, int numSamples);
+
+    // Get normalized coefficients (a0 == 1)
+    void getCoefficients(double& b0, double& b1, double& b2, double& a1, double& a2) const;
+
+    const Design& getDesign() const;
+
     // Reset filter state
     void reset();
 
+    // RBJ cookbook coefficients for a design
+    static Coefficients calculateCoefficients(const Design& design);
+
+    // Precompute the gain-independent part of a design
+    static Prototype prepare(const Design& design);
+
+    // Coefficients for linear amplitude A = 10^(gainDB / 40) - no trigonometry
+    static Coefficients calculateCoefficients(const Prototype& prototype, double A);
+
+    // Linear amplitude A for a gain in dB
+    static double amplitude(double gainDB);
+
+    // Shelves and peaking use gainDB; the other types ignore it
+    static bool hasGain(FilterType type);
+
 private:
-    // Filter coefficients
-    double a0, a1, a2, b0, b1, b2;
-    
-    // Filter state
-    double x1, x2;  // Input history
-    double y1, y2;  // Output history
-
-    // Parameters
-    FilterType type;
-    double frequency;
-    double sampleRate;
-    double gainDB;
-    double Q;
+    BiquadSection<double> section;  // Hot: coefficients + state
+    Design design;                  // Cold: parameters
 
     // Recalculate coefficients
     void calculateCoefficients();
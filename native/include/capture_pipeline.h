@@ -0,0 +1,60 @@
+#ifndef CAPTURE_PIPELINE_H
+#define CAPTURE_PIPELINE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "equalizer.h"
+
+/**
+ * Capture Pipeline - the device-independent half of the system audio hook
+ * Owns the equalizer the capture thread runs and filters one interleaved
+ * packet at a time in place. SystemAudioHook feeds it WASAPI packets; the
+ * realtime_check target feeds it a simulated device. Packets are 32-bit
+ * float, or 16/32-bit PCM converted to float and back through a scratch
+ * buffer sized before capture starts.
+ *
+ * setEqualizer swaps equalizers without ever blocking the capture thread:
+ * the new one is published atomically and the control thread waits out
+ * a grace period before the old one can be released.
+ */
+class CapturePipeline {
+public:
+    // Packet sample format (the device mix format)
+    enum SampleFormat { FORMAT_FLOAT32, FORMAT_INT16, FORMAT_INT32, FORMAT_UNSUPPORTED };
+
+    CapturePipeline();
+    ~CapturePipeline();
+
+    // Control thread
+    Equalizer* getEqualizer();
+    void setEqualizer(std::shared_ptr<Equalizer> eq);
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Control thread, before capture starts: the packet format and the
+    // largest packet. FORMAT_UNSUPPORTED packets pass through untouched.
+    void setSampleFormat(SampleFormat format, int maxFrames, int numChannels);
+    SampleFormat getSampleFormat() const;
+
+    // Capture thread: filter one packet in place (up to
+    // Equalizer::MAX_CHANNELS channels)
+    void processPacket(void* data, int numFrames, int numChannels);
+
+private:
+    std::shared_ptr<Equalizer> equalizer;          // Owner (control thread)
+    std::atomic<Equalizer*> activeEqualizer;       // Published to the capture thread
+    std::atomic<Equalizer*> capturingEqualizer;    // In use by the capture thread, or null
+    std::atomic<bool> enabled;
+    SampleFormat format;
+    std::vector<float> scratch;                    // Integer packets as float
+
+    // Capture thread: integer packets through scratch, a chunk at a time
+    void processConverted(Equalizer* eq, void* data, int numFrames, int numChannels);
+
+    // Capture thread: pin the active equalizer for one packet (never blocks)
+    Equalizer* acquireEqualizer();
+    void releaseEqualizer();
+};
+
+#endif // CAPTURE_PIPELINE_H
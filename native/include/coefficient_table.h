@@ -0,0 +1,42 @@
+#ifndef COEFFICIENT_TABLE_H
+#define COEFFICIENT_TABLE_H
+
+#include "biquad_filter.h"
+
+/**
+ * Precomputed band coefficients over a fine gain grid
+ * One table per band design (sample rate, frequency, type, Q), filled in a
+ * single pass the first time the design is requested and shared for the
+ * lifetime of the process. Gain changes, preset switches and equalizers
+ * rebuilt for a sample rate seen before become table lookups.
+ *
+ * The grid runs from -MAX_GAIN_DB to +MAX_GAIN_DB in 1/STEPS_PER_DB dB.
+ * Entries are computed from exactly the gain a caller would pass (k / 10.0),
+ * so a lookup returns the same bits as BiquadFilter::calculateCoefficients.
+ * Gains off the grid fall back to that calculation.
+ *
+ * Tables are immutable once published, so lookups take no lock.
+ */
+class CoefficientTable {
+public:
+    static const int STEPS_PER_DB = 10;
+    static const int MAX_GAIN_DB = 12;
+    static const int GRID_SIZE = 2 * MAX_GAIN_DB * STEPS_PER_DB + 1;
+    static const int MAX_TABLES = 512;
+
+    // Shared table for a design (gain ignored); nullptr once MAX_TABLES exist
+    static const CoefficientTable* find(const BiquadFilter::Design& design);
+
+    // Coefficients for a gain: table entry on the grid, calculated otherwise
+    BiquadFilter::Coefficients lookup(double gainDB) const;
+
+    const BiquadFilter::Prototype& getPrototype() const;
+
+private:
+    explicit CoefficientTable(const BiquadFilter::Design& design);
+
+    BiquadFilter::Prototype prototype;
+    BiquadFilter::Coefficients entries[GRID_SIZE];
+};
+
+#endif // COEFFICIENT_TABLE_H
@@ -0,0 +1,182 @@
+#ifndef CONVOLUTION_ENGINE_H
+#define CONVOLUTION_ENGINE_H
+
+#include "fft.h"
+#include "parameter_channel.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * Partitioned FFT convolution engine (stereo, overlap-save)
+ * Runs impulse responses of up to MAX_TAPS taps (room/headphone
+ * correction, linear-phase EQ) with a fixed latency of MIN_LATENCY to
+ * MAX_LATENCY frames, whatever block sizes the caller pushes.
+ *
+ * Partitioning: the head of the IR is cut into latency-sized partitions,
+ * later parts into partitions TIER_RATIO times longer, and so on up to
+ * MAX_TIER_BLOCK (non-uniform). Each tier is a uniformly partitioned
+ * overlap-save convolver with a frequency-domain delay line. The first
+ * tier starts at tap 0 and runs in the block that completes its input.
+ * A later tier with block size B starts at tap 2B - latency, one block
+ * later than its output could land, and its FFT passes and
+ * multiply-accumulates are spread evenly over the B / latency blocks
+ * before that output is due, so no block computes a whole large
+ * partition. Each tier ends where the next one starts, so the tiers tile
+ * the IR without gaps. UNIFORM keeps one tier of latency-sized partitions
+ * (cheapest at short IRs, the reference at long ones).
+ *
+ * Both channels share one complex FFT (left in the real part, right in
+ * the imaginary part). A stereo IR adds a mirrored-bin term so each
+ * channel still sees its own response.
+ *
+ * Threading: configure() builds a new layout (tiers, delay lines, staging
+ * and output ring) on the control thread, and impulse responses are
+ * transformed there too. Both reach the audio thread through one
+ * ParameterChannel of kernels, each holding the layout it was built for,
+ * so re-partitioning or loading an IR while audio runs never blocks or
+ * allocates on the audio thread. A new layout starts from silence.
+ */
+class ConvolutionEngine {
+public:
+    static const int MIN_LATENCY = 64;
+    static const int MAX_LATENCY = 1024;
+    static const int MAX_TAPS = 65536;
+    static const int DEFAULT_LATENCY = 256;
+    static const int DEFAULT_MAX_TAPS = 8192;
+    static const int TIER_RATIO = 8;            // Block growth between tiers
+    static const int MAX_TIER_BLOCK = 16384;    // Largest partition (FFT of twice this)
+
+    enum Partitioning {
+        NON_UNIFORM,
+        UNIFORM
+    };
+
+    ConvolutionEngine();
+    ~ConvolutionEngine();
+
+    // Control thread: lay out partitions for a latency (power of two in
+    // MIN_LATENCY..MAX_LATENCY) and IR length (1..MAX_TAPS). Keeps the
+    // loaded IR (truncated to maxTaps) and clears the history.
+    bool configure(int latency, int maxTaps, Partitioning partitioning = NON_UNIFORM);
+
+    // Control thread: load an IR (right == nullptr: left on both channels).
+    // Taps beyond getMaxTaps() are dropped. Adopted at the next block.
+    bool setImpulseResponse(const float* left, const float* right, int numTaps);
+
+    // Control thread: clear the history at the next block
+    void clear();
+
+    // Control thread: unload the IR and return to the default layout (a
+    // recycled engine); allocates only if the layout was changed
+    void restoreDefaults();
+
+    // Clamp output to [-1, 1] (default); off when a limiter follows
+    void setOutputClamp(bool enabled);
+
+    // Audio thread: filter interleaved stereo or separate channels in
+    // place; the output is delayed by getLatency() frames
+    void processInterleaved(float* buffer, int numFrames);
+    void processStereo(float* leftChannel, float* rightChannel, int numFrames);
+
+    // Control thread: linear-phase FIR (numTaps, a power of two) with a
+    // zero-phase magnitude response given at numTaps / 2 + 1 equally
+    // spaced frequencies from 0 to Nyquist. The peak sits at numTaps / 2.
+    static void designLinearPhase(const double* magnitude, int numTaps, float* impulse);
+
+    int getLatency() const;
+    int getMaxTaps() const;
+    int getNumTiers() const;
+    bool hasImpulseResponse() const;
+
+private:
+    static const int STEP_POINTS = 8192;        // Largest piece of tier work per step
+
+    // One piece of a tier block's work over points [first, first + count)
+    struct Step {
+        enum Kind { FORWARD, PREPARE, MULTIPLY, MULTIPLY_MIRRORED, INVERSE, OUTPUT };
+        Kind kind;
+        int index;                      // FFT pass or partition
+        int first;
+        int count;
+    };
+
+    struct Tier {
+        int blockSize;
+        int start;                      // First tap
+        int partitions;
+        int kernelOffset;               // Into Kernel::spectra
+        FFT fft;                        // 2 * blockSize
+        std::vector<float> inputRe;     // Overlap-save window (left)
+        std::vector<float> inputIm;     // Overlap-save window (right)
+        std::vector<float> history;     // Delay line: partitions x (X re, X im, mirrored re, mirrored im)
+        std::vector<float> workRe;
+        std::vector<float> workIm;
+        std::vector<int> mirror;        // Storage position of bin -k for each position
+        int fill;                       // Frames in the window's second half
+        int newest;                     // Delay line slot of the newest spectrum
+
+        // Work for a completed block: forward passes, mirror and clear,
+        // direct and mirrored multiply-accumulate per partition, inverse
+        // passes, then the add into the output ring, cut into steps of at
+        // most STEP_POINTS points where the data allow. An even share runs
+        // in each of the spread blocks from the one that completes it.
+        std::vector<Step> plan;
+        int spread;
+        int step;                       // Next step; plan.size() when idle
+        int elapsed;                    // Blocks since the work started
+        long long outputStart;          // First output frame of that block
+
+        Tier(int blockSize, int start, int partitions, int kernelOffset, int spread);
+        void addSteps(Step::Kind kind, int index, int total, int chunk);
+        int getNumSteps() const;
+    };
+
+    // One partitioning with its audio-side state: latency-sized staging
+    // so calls of any size keep the partition clock, and the output
+    // accumulator ring. Built on the control thread, then only the audio
+    // thread touches it.
+    struct Layout {
+        int latency;
+        std::vector<std::unique_ptr<Tier>> tiers;
+        std::vector<float> blockIn;     // Interleaved stereo
+        std::vector<float> blockOut;    // Interleaved stereo
+        int blockPos;
+        std::vector<float> accLeft;
+        std::vector<float> accRight;
+        int accMask;
+        long long clock;                // Frames consumed, multiple of latency at block edges
+    };
+
+    // IR spectra for every tier of a layout, scaled by 1 / FFT size
+    struct Kernel {
+        std::shared_ptr<Layout> layout;
+        std::vector<float> spectra;     // Per partition: A re, A im, B re, B im (FFT size each)
+        bool stereo;                    // B (left/right difference) in use
+        bool loaded;
+
+        Kernel() : stereo(false), loaded(false) {}
+    };
+
+    // Control thread. Slots keep their layouts alive until overwritten,
+    // so a replaced layout is always freed here, never on the audio thread
+    int latency;
+    int maxTaps;
+    Partitioning partitioning;
+    int kernelSize;
+    std::shared_ptr<Layout> layout;     // The one kernels are built for
+    ParameterChannel<Kernel> kernels;
+    std::vector<float> irLeft;
+    std::vector<float> irRight;         // Empty for a mono IR
+    std::atomic<bool> clearRequested;
+    std::atomic<bool> clamping;
+
+    void buildKernel(Kernel& kernel);
+    void process(float* left, float* right, int stride, int numFrames);
+    void processBlock(Layout& active, const Kernel& kernel);
+    void startTier(Layout& active, Tier& tier, const Kernel& kernel);
+    void advanceTier(Layout& active, Tier& tier, const Kernel& kernel, int until);
+    void clearHistory(Layout& active);
+};
+
+#endif // CONVOLUTION_ENGINE_H
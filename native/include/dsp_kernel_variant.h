@@ -0,0 +1,417 @@
+#ifndef DSP_KERNEL_VARIANT_H
+#define DSP_KERNEL_VARIANT_H
+
+/**
+ * Kernel bodies shared by the dsp_kernels_*.cpp variant sources
+ * Each variant source includes this once and is built with its own
+ * instruction set flags; simd.h then provides the widest lane wrappers
+ * those flags allow. Everything here has internal linkage (see
+ * EQ_SIMD_PRIVATE in simd.h).
+ *
+ * The cascade runs every channel group with the widest lanes first (8,
+ * then 4, then 2, then single channels). The conversion and clamp loops
+ * use x86 vectors where the variant has them and finish, or run
+ * entirely, with the scalar expression they must match.
+ */
+
+#define EQ_SIMD_PRIVATE 1
+#include "dsp_kernels.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+typedef DspKernels DK;
+
+// Lane set of the scalar reference: every width is the scalar wrapper
+template <typename T>
+struct ReferenceLanes {
+    typedef typename SimdLanes<T>::Scalar Scalar;
+    typedef Scalar Pair;
+    typedef Scalar Quad;
+    typedef Scalar Oct;
+    static const bool HAS_PAIR = false;
+    static const bool HAS_QUAD = false;
+    static const bool HAS_OCT = false;
+};
+
+// Separate channel buffers, one pointer per lane
+struct PlanarIO {
+    const float* const* input;
+    float* const* output;
+
+    template <typename S>
+    inline typename S::Vec load(int i) const { return S::gather(input, i); }
+    template <typename S>
+    inline void store(int i, typename S::Vec v) const { S::scatter(output, i, v); }
+};
+
+// Interleaved frames filtered in place; the group's lanes are adjacent
+struct InterleavedIO {
+    float* frames;      // First channel of the group in frame 0
+    int frameStride;    // Total channels per frame
+
+    template <typename S>
+    inline typename S::Vec load(int i) const { return S::loadFloats(frames + (ptrdiff_t)i * frameStride); }
+    template <typename S>
+    inline void store(int i, typename S::Vec v) const { S::storeFloats(frames + (ptrdiff_t)i * frameStride, v); }
+};
+
+// Interleaved frames in, separate channel buffers out
+struct SplitIO {
+    const float* frames;
+    int frameStride;
+    float* const* output;
+
+    template <typename S>
+    inline typename S::Vec load(int i) const { return S::loadFloats(frames + (ptrdiff_t)i * frameStride); }
+    template <typename S>
+    inline void store(int i, typename S::Vec v) const { S::scatter(output, i, v); }
+};
+
+/**
+ * Cascade kernel for one group of S::WIDTH channels.
+ * History for the group is loaded into locals at block start and written
+ * back once at block end. Every lane width evaluates the same expression
+ * in the same order, so all widths yield the same bits as the scalar path.
+ * FIXED > 0 makes the section count a constant so the loops unroll;
+ * SECTIONS is the storage capacity.
+ */
+template <int FIXED, int SECTIONS, typename S, typename IO>
+static void runCascade(const typename S::T* coeffs, int runtimeSections, typename S::T* history,
+                       typename S::T limit, int firstChannel, const IO& io, int numSamples) {
+    typedef typename S::Vec Vec;
+    const int CH = DK::MAX_CHANNELS;
+    const int numSections = FIXED > 0 ? FIXED : runtimeSections;
+
+    Vec b0[SECTIONS], b1[SECTIONS], b2[SECTIONS], a1[SECTIONS], a2[SECTIONS];
+    Vec z1[SECTIONS + 1], z2[SECTIONS + 1];
+
+    for (int s = 0; s < numSections; s++) {
+        b0[s] = S::set1(coeffs[s * 5 + 0]);
+        b1[s] = S::set1(coeffs[s * 5 + 1]);
+        b2[s] = S::set1(coeffs[s * 5 + 2]);
+        a1[s] = S::set1(coeffs[s * 5 + 3]);
+        a2[s] = S::set1(coeffs[s * 5 + 4]);
+    }
+    for (int n = 0; n <= numSections; n++) {
+        z1[n] = S::load(&history[(n * 2 + 0) * CH + firstChannel]);
+        z2[n] = S::load(&history[(n * 2 + 1) * CH + firstChannel]);
+    }
+
+    const Vec lo = S::set1(-limit);
+    const Vec hi = S::set1(limit);
+
+    for (int i = 0; i < numSamples; i++) {
+        Vec x = io.template load<S>(i);
+        Vec x1 = z1[0];
+        Vec x2 = z2[0];
+        z2[0] = x1;
+        z1[0] = x;
+
+        for (int s = 0; s < numSections; s++) {
+            Vec y1 = z1[s + 1];
+            Vec y2 = z2[s + 1];
+
+            // History terms first: only b0 * x waits on the previous section
+            Vec h = S::add(S::mul(b1[s], x1), S::mul(b2[s], x2));
+            h = S::sub(h, S::mul(a1[s], y1));
+            h = S::sub(h, S::mul(a2[s], y2));
+            Vec y = S::add(S::mul(b0[s], x), h);
+
+            z2[s + 1] = y1;
+            z1[s + 1] = y;
+            x = y;
+            x1 = y1;
+            x2 = y2;
+        }
+
+        io.template store<S>(i, S::clamp(x, lo, hi));
+    }
+
+    for (int n = 0; n <= numSections; n++) {
+        S::store(&history[(n * 2 + 0) * CH + firstChannel], z1[n]);
+        S::store(&history[(n * 2 + 1) * CH + firstChannel], z2[n]);
+    }
+}
+
+// Every channel group of a block, widest lanes first
+template <typename Lanes, int FIXED, typename T, typename MakeIO>
+static void runGroups(const DK::CascadeArgs<T>& a, MakeIO makeIO) {
+    const int SECTIONS = FIXED > 0 ? FIXED : DK::MAX_SECTIONS;
+    int c = 0;
+    if (Lanes::HAS_OCT) {
+        for (; a.numChannels - c >= 8; c += 8) {
+            runCascade<FIXED, SECTIONS, typename Lanes::Oct>(
+                a.coefficients, a.numSections, a.history, a.limit, c, makeIO(c), a.numSamples);
+        }
+    }
+    if (Lanes::HAS_QUAD) {
+        for (; a.numChannels - c >= 4; c += 4) {
+            runCascade<FIXED, SECTIONS, typename Lanes::Quad>(
+                a.coefficients, a.numSections, a.history, a.limit, c, makeIO(c), a.numSamples);
+        }
+    }
+    if (Lanes::HAS_PAIR) {
+        for (; a.numChannels - c >= 2; c += 2) {
+            runCascade<FIXED, SECTIONS, typename Lanes::Pair>(
+                a.coefficients, a.numSections, a.history, a.limit, c, makeIO(c), a.numSamples);
+        }
+    }
+    for (; c < a.numChannels; c++) {
+        runCascade<FIXED, SECTIONS, typename Lanes::Scalar>(
+            a.coefficients, a.numSections, a.history, a.limit, c, makeIO(c), a.numSamples);
+    }
+}
+
+template <typename Lanes, int FIXED, typename T>
+static void cascadePlanar(const DK::CascadeArgs<T>& a) {
+    runGroups<Lanes, FIXED>(a, [&](int c) {
+        PlanarIO io = { a.input + c, a.output + c };
+        return io;
+    });
+}
+
+template <typename Lanes, int FIXED, typename T>
+static void cascadeInterleaved(const DK::CascadeArgs<T>& a) {
+    runGroups<Lanes, FIXED>(a, [&](int c) {
+        InterleavedIO io = { a.frames + c, a.frameStride };
+        return io;
+    });
+}
+
+template <typename Lanes, int FIXED, typename T>
+static void cascadeSplit(const DK::CascadeArgs<T>& a) {
+    runGroups<Lanes, FIXED>(a, [&](int c) {
+        SplitIO io = { a.frames + c, a.frameStride, a.output + c };
+        return io;
+    });
+}
+
+template <typename Lanes, typename T, int INDEX>
+constexpr void setCascade(DK::CascadeKernels<T>& kernels) {
+    constexpr int FIXED = DK::FIXED_SECTIONS[INDEX];
+    kernels.run[DK::PLANAR][INDEX] = &cascadePlanar<Lanes, FIXED, T>;
+    kernels.run[DK::INTERLEAVED][INDEX] = &cascadeInterleaved<Lanes, FIXED, T>;
+    kernels.run[DK::SPLIT][INDEX] = &cascadeSplit<Lanes, FIXED, T>;
+}
+
+template <typename Lanes, typename T>
+constexpr DK::CascadeKernels<T> makeCascade() {
+    static_assert(DK::NUM_FIXED == 8, "one setCascade per FIXED_SECTIONS entry");
+    DK::CascadeKernels<T> kernels = {};
+    setCascade<Lanes, T, 0>(kernels);
+    setCascade<Lanes, T, 1>(kernels);
+    setCascade<Lanes, T, 2>(kernels);
+    setCascade<Lanes, T, 3>(kernels);
+    setCascade<Lanes, T, 4>(kernels);
+    setCascade<Lanes, T, 5>(kernels);
+    setCascade<Lanes, T, 6>(kernels);
+    setCascade<Lanes, T, 7>(kernels);
+    return kernels;
+}
+
+// Scalar definitions of the conversions and the clamp; the vector loops
+// below reproduce them bit for bit (cvtps rounds to nearest even like
+// lrint, and min/max keep std::min/std::max operand order)
+static const float INT16_SCALE = 32768.0f;
+static const float INT16_MAX_FLOAT = 32767.0f;
+static const float INT32_SCALE = 2147483648.0f;
+static const float INT32_MAX_FLOAT = 2147483520.0f;     // Largest float below 2^31
+
+static inline float clampSample(float v, float lo, float hi) {
+    return std::max(lo, std::min(hi, v));
+}
+
+template <bool VECTOR>
+static void int16ToFloat(const int16_t* input, float* output, int count) {
+    const float scale = 1.0f / INT16_SCALE;
+    int i = 0;
+    if (VECTOR) {
+#if defined(EQ_HAVE_AVX512)
+        const __m512 s = _mm512_set1_ps(scale);
+        for (; count - i >= 16; i += 16) {
+            __m512i v = _mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)));
+            _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(v), s));
+        }
+#elif defined(EQ_HAVE_AVX2)
+        const __m256 s = _mm256_set1_ps(scale);
+        for (; count - i >= 8; i += 8) {
+            __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)));
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), s));
+        }
+#elif defined(EQ_HAVE_SSE41)
+        const __m128 s = _mm_set1_ps(scale);
+        for (; count - i >= 4; i += 4) {
+            __m128i v = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + i)));
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), s));
+        }
+#elif defined(EQ_HAVE_SSE2)
+        const __m128 s = _mm_set1_ps(scale);
+        for (; count - i >= 4; i += 4) {
+            // Sign-extend by unpacking into the high halves
+            __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + i));
+            v = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), s));
+        }
+#endif
+    }
+    for (; i < count; i++) output[i] = (float)input[i] * scale;
+}
+
+template <bool VECTOR>
+static void floatToInt16(const float* input, int16_t* output, int count) {
+    int i = 0;
+    if (VECTOR) {
+#if defined(EQ_HAVE_AVX512)
+        const __m512 s = _mm512_set1_ps(INT16_SCALE);
+        const __m512 lo = _mm512_set1_ps(-INT16_SCALE), hi = _mm512_set1_ps(INT16_MAX_FLOAT);
+        for (; count - i >= 16; i += 16) {
+            __m512 v = _mm512_max_ps(_mm512_min_ps(_mm512_mul_ps(_mm512_loadu_ps(input + i), s), hi), lo);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(v)));
+        }
+#elif defined(EQ_HAVE_AVX2)
+        const __m256 s = _mm256_set1_ps(INT16_SCALE);
+        const __m256 lo = _mm256_set1_ps(-INT16_SCALE), hi = _mm256_set1_ps(INT16_MAX_FLOAT);
+        for (; count - i >= 8; i += 8) {
+            __m256 v = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), s), hi), lo);
+            __m256i n = _mm256_cvtps_epi32(v);
+            __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(n), _mm256_extracti128_si256(n, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+        }
+#elif defined(EQ_HAVE_SSE2)
+        const __m128 s = _mm_set1_ps(INT16_SCALE);
+        const __m128 lo = _mm_set1_ps(-INT16_SCALE), hi = _mm_set1_ps(INT16_MAX_FLOAT);
+        for (; count - i >= 8; i += 8) {
+            __m128 a = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(input + i), s), hi), lo);
+            __m128 b = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), s), hi), lo);
+            __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+        }
+#endif
+    }
+    for (; i < count; i++) {
+        output[i] = (int16_t)std::lrint(clampSample(input[i] * INT16_SCALE, -INT16_SCALE, INT16_MAX_FLOAT));
+    }
+}
+
+template <bool VECTOR>
+static void int32ToFloat(const int32_t* input, float* output, int count) {
+    const float scale = 1.0f / INT32_SCALE;
+    int i = 0;
+    if (VECTOR) {
+#if defined(EQ_HAVE_AVX512)
+        const __m512 s = _mm512_set1_ps(scale);
+        for (; count - i >= 16; i += 16) {
+            __m512i v = _mm512_loadu_si512(input + i);
+            _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(v), s));
+        }
+#elif defined(EQ_HAVE_AVX2)
+        const __m256 s = _mm256_set1_ps(scale);
+        for (; count - i >= 8; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), s));
+        }
+#elif defined(EQ_HAVE_SSE2)
+        const __m128 s = _mm_set1_ps(scale);
+        for (; count - i >= 4; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), s));
+        }
+#endif
+    }
+    for (; i < count; i++) output[i] = (float)input[i] * scale;
+}
+
+template <bool VECTOR>
+static void floatToInt32(const float* input, int32_t* output, int count) {
+    int i = 0;
+    if (VECTOR) {
+#if defined(EQ_HAVE_AVX512)
+        const __m512 s = _mm512_set1_ps(INT32_SCALE);
+        const __m512 lo = _mm512_set1_ps(-INT32_SCALE), hi = _mm512_set1_ps(INT32_MAX_FLOAT);
+        for (; count - i >= 16; i += 16) {
+            __m512 v = _mm512_max_ps(_mm512_min_ps(_mm512_mul_ps(_mm512_loadu_ps(input + i), s), hi), lo);
+            _mm512_storeu_si512(output + i, _mm512_cvtps_epi32(v));
+        }
+#elif defined(EQ_HAVE_AVX2)
+        const __m256 s = _mm256_set1_ps(INT32_SCALE);
+        const __m256 lo = _mm256_set1_ps(-INT32_SCALE), hi = _mm256_set1_ps(INT32_MAX_FLOAT);
+        for (; count - i >= 8; i += 8) {
+            __m256 v = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), s), hi), lo);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_cvtps_epi32(v));
+        }
+#elif defined(EQ_HAVE_SSE2)
+        const __m128 s = _mm_set1_ps(INT32_SCALE);
+        const __m128 lo = _mm_set1_ps(-INT32_SCALE), hi = _mm_set1_ps(INT32_MAX_FLOAT);
+        for (; count - i >= 4; i += 4) {
+            __m128 v = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(input + i), s), hi), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_cvtps_epi32(v));
+        }
+#endif
+    }
+    for (; i < count; i++) {
+        output[i] = (int32_t)std::lrint(clampSample(input[i] * INT32_SCALE, -INT32_SCALE, INT32_MAX_FLOAT));
+    }
+}
+
+template <bool VECTOR>
+static void interleaveClamp(const float* left, const float* right, float* frames, int count, float limit) {
+    int i = 0;
+    if (VECTOR) {
+#if defined(EQ_HAVE_AVX512)
+        const __m512 lo = _mm512_set1_ps(-limit), hi = _mm512_set1_ps(limit);
+        const __m512i first = _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0);
+        const __m512i second = _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8);
+        for (; count - i >= 16; i += 16) {
+            __m512 l = _mm512_max_ps(_mm512_min_ps(_mm512_loadu_ps(left + i), hi), lo);
+            __m512 r = _mm512_max_ps(_mm512_min_ps(_mm512_loadu_ps(right + i), hi), lo);
+            _mm512_storeu_ps(frames + 2 * i, _mm512_permutex2var_ps(l, first, r));
+            _mm512_storeu_ps(frames + 2 * i + 16, _mm512_permutex2var_ps(l, second, r));
+        }
+#elif defined(EQ_HAVE_AVX)
+        const __m256 lo = _mm256_set1_ps(-limit), hi = _mm256_set1_ps(limit);
+        for (; count - i >= 8; i += 8) {
+            __m256 l = AvxFloat8::clamp(_mm256_loadu_ps(left + i), lo, hi);
+            __m256 r = AvxFloat8::clamp(_mm256_loadu_ps(right + i), lo, hi);
+            // unpack works within 128-bit halves; reassemble them in order
+            __m256 low = _mm256_unpacklo_ps(l, r), high = _mm256_unpackhi_ps(l, r);
+            _mm256_storeu_ps(frames + 2 * i, _mm256_permute2f128_ps(low, high, 0x20));
+            _mm256_storeu_ps(frames + 2 * i + 8, _mm256_permute2f128_ps(low, high, 0x31));
+        }
+#elif defined(EQ_HAVE_SSE2)
+        const __m128 lo = _mm_set1_ps(-limit), hi = _mm_set1_ps(limit);
+        for (; count - i >= 4; i += 4) {
+            __m128 l = Sse2Float4::clamp(_mm_loadu_ps(left + i), lo, hi);
+            __m128 r = Sse2Float4::clamp(_mm_loadu_ps(right + i), lo, hi);
+            _mm_storeu_ps(frames + 2 * i, _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(frames + 2 * i + 4, _mm_unpackhi_ps(l, r));
+        }
+#endif
+    }
+    for (; i < count; i++) {
+        frames[2 * i] = clampSample(left[i], -limit, limit);
+        frames[2 * i + 1] = clampSample(right[i], -limit, limit);
+    }
+}
+
+template <typename FloatLanes, typename DoubleLanes, bool VECTOR>
+constexpr DK::Table makeKernelTable(DK::Isa isa) {
+    DK::Table table = {};
+    table.isa = isa;
+    table.cascadeFloat = makeCascade<FloatLanes, float>();
+    table.cascadeDouble = makeCascade<DoubleLanes, double>();
+    table.int16ToFloat = &int16ToFloat<VECTOR>;
+    table.floatToInt16 = &floatToInt16<VECTOR>;
+    table.int32ToFloat = &int32ToFloat<VECTOR>;
+    table.floatToInt32 = &floatToInt32<VECTOR>;
+    table.interleaveClamp = &interleaveClamp<VECTOR>;
+    return table;
+}
+
+}
+
+#endif // DSP_KERNEL_VARIANT_H
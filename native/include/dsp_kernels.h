@@ -0,0 +1,114 @@
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <cstdint>
+
+/**
+ * DSP Kernels - the hot loops, built once per instruction set
+ * The biquad cascade, sample format conversion and the output clamp are
+ * compiled as a scalar reference, at the build's baseline (SSE2 on x86-64,
+ * NEON on AArch64) and, on x86, as SSE4.1, AVX2 and AVX-512 variants, each
+ * in its own source with its own compiler flags. The widest variant the
+ * CPU and OS support is chosen from CPUID when the module loads;
+ * EQ_KERNEL_ISA=scalar|baseline|sse4.1|avx2|avx512 overrides the choice
+ * (an unsupported request falls back to detection).
+ *
+ * Every variant produces the same bits as the scalar reference: the lane
+ * wrappers in simd.h mirror scalar rounding and no variant is built with
+ * FMA contraction. History and coefficient layouts are shared, so the
+ * variant can change between any two blocks.
+ */
+class DspKernels {
+public:
+    enum Isa { SCALAR, BASELINE, SSE41, AVX2, AVX512, NUM_ISAS };
+
+    // Cascade I/O: separate channel buffers, interleaved frames in place,
+    // or interleaved frames in and separate channels out
+    enum Layout { PLANAR, INTERLEAVED, SPLIT, NUM_LAYOUTS };
+
+    static const int MAX_CHANNELS = 8;          // History lanes per cascade node
+
+    // Section counts with an unrolled cascade kernel; index 0 is the
+    // runtime count (up to MAX_SECTIONS)
+    static const int MAX_SECTIONS = 32;
+    static const int NUM_FIXED = 8;
+    static constexpr int FIXED_SECTIONS[NUM_FIXED] = { 0, 2, 3, 4, 5, 10, 31, 32 };
+
+    // One cascade run over all channels of a block
+    template <typename T>
+    struct CascadeArgs {
+        const T* coefficients;          // b0, b1, b2, a1, a2 per section
+        int numSections;
+        T* history;                     // [(node * 2 + k) * MAX_CHANNELS + channel]
+        T limit;                        // Output clamp bound
+        int numChannels;                // Up to MAX_CHANNELS
+        int numSamples;
+        const float* const* input;      // PLANAR: one pointer per channel
+        float* const* output;           // PLANAR and SPLIT
+        float* frames;                  // INTERLEAVED (in place) and SPLIT (read only)
+        int frameStride;                // Channels per interleaved frame
+    };
+
+    template <typename T>
+    struct CascadeKernels {
+        typedef void (*Fn)(const CascadeArgs<T>& args);
+        Fn run[NUM_LAYOUTS][NUM_FIXED];
+    };
+
+    struct Table {
+        Isa isa;
+        CascadeKernels<float> cascadeFloat;
+        CascadeKernels<double> cascadeDouble;
+
+        // Integer PCM, full scale 1.0. To integer: scale, clamp (NaN to
+        // positive full scale, as std::min does) and round to nearest even.
+        void (*int16ToFloat)(const int16_t* input, float* output, int count);
+        void (*floatToInt16)(const float* input, int16_t* output, int count);
+        void (*int32ToFloat)(const int32_t* input, float* output, int count);
+        void (*floatToInt32)(const float* input, int32_t* output, int count);
+
+        // Interleave two channels into frames, clamped to [-limit, limit]
+        void (*interleaveClamp)(const float* left, const float* right, float* frames, int count, float limit);
+    };
+
+    // The active variant (chosen when the module loads)
+    static const Table& get();
+
+    // The active variant, or the widest supported one up to widest when
+    // the active one is wider (for kernels that cannot fill its lanes)
+    static const Table& getCapped(Isa widest);
+
+    // The scalar reference
+    static const Table& getReference();
+
+    // A variant, or null when it is not built for this target or the CPU
+    // lacks its instructions
+    static const Table* getVariant(Isa isa);
+    static bool isSupported(Isa isa);
+
+    // Switch variants, for tests and benchmarks; false if unsupported
+    static bool setActiveIsa(Isa isa);
+    static Isa getActiveIsa();
+
+    // Widest supported variant, ignoring EQ_KERNEL_ISA
+    static Isa detectIsa();
+
+    // "scalar", "baseline", "sse4.1", "avx2", "avx512"
+    static const char* getIsaName(Isa isa);
+    static bool parseIsa(const char* name, Isa& isa);
+
+    // Kernel index for a compile-time section count (0 if none matches)
+    static int getFixedIndex(int numSections);
+
+private:
+    // One per variant source; null when the variant is not compiled in
+    static const Table* scalarVariant();
+    static const Table* baselineVariant();
+    static const Table* sse41Variant();
+    static const Table* avx2Variant();
+    static const Table* avx512Variant();
+
+    static const Table* chooseVariant();
+};
+
+#endif // DSP_KERNELS_H
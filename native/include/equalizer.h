@@ -2,51 +2,112 @@
 #define EQUALIZER_H
 
 #include "biquad_filter.h"
-#include <vector>
+#include "biquad_cascade.h"
+#include <memory>
 #include <string>
 
+// Filter state precision, chosen per build (define EQ_SINGLE_PRECISION for float)
+#ifdef EQ_SINGLE_PRECISION
+typedef float EqualizerSample;
+#else
+typedef double EqualizerSample;
+#endif
+
 /**
- * 10-Band Professional Equalizer
- * Frequencies: 31, 62, 125, 250, 500, 1k, 2k, 4k, 8k, 16k Hz
+ * Professional Equalizer interface
+ * Graphic EQs with 5, 10 or 31 bands and the parametric EQ are created
+ * through create(); each graphic band count is its own GraphicEqualizer
+ * instantiation, so callers pick the layout at runtime and the audio path
+ * stays specialized.
  */
 class Equalizer {
 public:
-    static const int NUM_BANDS = 10;
+    static const int DEFAULT_BANDS = 10;
+    static const int NUM_PRESETS = 12;                 // Preset IDs are 0 .. NUM_PRESETS - 1
+    static const int PARAMETRIC = 0;                   // create() band count for ParametricEqualizer
+    static const int MAX_CHANNELS = BiquadCascade<EqualizerSample>::MAX_CHANNELS;
+    static const int SMOOTHING_INTERVAL = 32;          // Samples between coefficient updates
+    static constexpr double DEFAULT_SMOOTHING_MS = 30.0;
+    static constexpr double SILENCE_THRESHOLD = 1e-6;  // -120 dBFS; quieter blocks count as silence
+    
+    // Create a graphic EQ with 5, 10 or 31 bands, or a parametric EQ for
+    // PARAMETRIC (nullptr for other counts)
+    static std::unique_ptr<Equalizer> create(int numBands, double sampleRate = 44100.0);
+    static bool isSupportedBandCount(int numBands);
+    
+    // Preset IDs, resolved once so switching never looks names up
+    // (-1 / nullptr if unknown)
+    static int findPreset(const std::string& presetName);
+    static const char* getPresetName(int presetId);
     
-    Equalizer(double sampleRate = 44100.0);
-    ~Equalizer();
+    virtual ~Equalizer() {}
 
     // Process stereo audio buffer
-    void processStereo(float* leftChannel, float* rightChannel, int numSamples);
+    virtual void processStereo(float* leftChannel, float* rightChannel, int numSamples) = 0;
+    
+    // Process interleaved frames in place (no scratch copy, no allocation).
+    // Channels beyond MAX_CHANNELS pass through unfiltered.
+    virtual void processInterleaved(float* buffer, int numChannels, int numFrames) = 0;
     
     // Set gain for specific band (-12 to +12 dB)
-    void setBandGain(int bandIndex, double gainDB);
+    virtual void setBandGain(int bandIndex, double gainDB) = 0;
     
     // Get current gain for band
-    double getBandGain(int bandIndex) const;
+    virtual double getBandGain(int bandIndex) const = 0;
     
-    // Apply preset by name
+    // Apply preset by name or ID; bands ramp over the smoothing time
     void applyPreset(const std::string& presetName);
+    virtual void applyPreset(int presetId) = 0;
+    
+    // Morph to a preset, to a blend of two presets (amount 0 = from,
+    // 1 = to) or to a user curve (one gain per band) over the given time.
+    // A morph runs on the same per-band gain ramps as any gain change.
+    virtual void morphToPreset(int presetId, double milliseconds) = 0;
+    virtual void morphPresets(int fromPresetId, int toPresetId, double amount, double milliseconds) = 0;
+    virtual void morphToCurve(const double* gainsDB, int numGains, double milliseconds) = 0;
     
     // Reset all bands to 0 dB
-    void reset();
+    virtual void reset() = 0;
     
     // Enable/disable EQ
-    void setEnabled(bool enabled);
-    bool isEnabled() const;
+    virtual void setEnabled(bool enabled) = 0;
+    virtual bool isEnabled() const = 0;
+    
+    // Processing thread (automation): setBandGain, setEnabled and
+    // applyPreset(id) without waiting for the parameter lock. False, with
+    // nothing changed, while a control-thread setter holds it.
+    virtual bool trySetBandGain(int bandIndex, double gainDB) = 0;
+    virtual bool trySetEnabled(bool enabled) = 0;
+    virtual bool tryApplyPreset(int presetId) = 0;
+    
+    // Clamp output to [-1, 1] (default); off when a limiter follows
+    virtual void setOutputClamp(bool enabled) = 0;
+    
+    // Move to another sample rate, keeping every band, gain, preset blend
+    // and setting: only the coefficients are recomputed (bands above the
+    // new Nyquist are held just below it and return when it rises again).
+    // Publishes like any other setter, so it is safe while audio runs;
+    // filter history is cleared at the next block.
+    virtual void setSampleRate(double sampleRate) = 0;
+    virtual double getSampleRate() const = 0;
+    
+    // Ramp time for gain changes in milliseconds (0 = jump)
+    virtual void setSmoothingTime(double milliseconds) = 0;
+    virtual double getSmoothingTime() const = 0;
     
-    // Get band frequencies
-    static const double* getBandFrequencies();
+    // Band layout
+    virtual int getNumBands() const = 0;
+    virtual const double* getBandFrequencies() const = 0;
+    virtual bool getBand(int bandIndex, BiquadFilter::Design& design) const = 0;
     
-private:
-    std::vector<BiquadFilter> leftFilters;
-    std::vector<BiquadFilter> rightFilters;
-    std::vector<double> currentGains;
-    double sampleRate;
-    bool enabled;
+    // Band editing; fixed layouts refuse (-1 / false)
+    virtual int addBand(const BiquadFilter::Design& design) { return -1; }
+    virtual bool removeBand(int bandIndex) { return false; }
+    virtual bool setBand(int bandIndex, const BiquadFilter::Design& design) { return false; }
     
-    void initializeFilters();
-    void updateFilter(int bandIndex);
+protected:
+    // Gain of a preset at a frequency (0.1 dB grid)
+    static double getPresetGain(int presetId, double frequency);
 };
 
 #endif // EQUALIZER_H
@@ -0,0 +1,49 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <atomic>
+
+/**
+ * Lock-free event queue (single producer, single consumer ring)
+ * Companion to ParameterChannel for discrete events that must all arrive,
+ * in order, rather than only the newest state. Capacity is fixed (a power
+ * of two); push fails instead of growing, so neither side allocates or
+ * blocks.
+ */
+template <typename T, int Capacity>
+class EventQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    EventQueue() : head(0), tail(0) {}
+
+    // Producer: false if the queue is full
+    bool push(const T& event) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == (unsigned)Capacity) return false;
+        events[t & (Capacity - 1)] = event;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Free slots as seen by the producer
+    int space() const {
+        return Capacity - (int)(tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire));
+    }
+
+    // Consumer: oldest event, false if the queue is empty
+    bool pop(T& event) {
+        unsigned h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        event = events[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T events[Capacity];
+    alignas(64) std::atomic<unsigned> head;     // Next to pop (consumer)
+    alignas(64) std::atomic<unsigned> tail;     // Next to push (producer)
+};
+
+#endif // EVENT_QUEUE_H
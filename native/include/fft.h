@@ -0,0 +1,68 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+
+/**
+ * Complex FFT for fast convolution
+ * Power-of-two sizes, in place, split format (separate real and imaginary
+ * arrays). Radix-4 passes (plus one radix-2 pass for odd powers of two)
+ * with per-pass twiddle tables; the butterflies run four bins at a time
+ * on SSE2/NEON.
+ *
+ * Spectra are left in bit-reversed order: forward() takes natural order
+ * and returns scrambled bins, inverse() takes scrambled bins and returns
+ * natural order. Convolution only multiplies spectra bin by bin, so as
+ * long as both operands come from forward() the permutation is never
+ * paid. binPosition() maps a natural bin index to its storage position
+ * for code that needs specific bins.
+ *
+ * inverse() is unnormalized (the result is size times the input signal);
+ * callers fold 1 / size into their filter spectra.
+ *
+ * Either direction can also run one pass at a time, over part of the
+ * array if it covers whole butterfly groups, so a large transform can be
+ * spread over several calls.
+ */
+class FFT {
+public:
+    static const int MIN_SIZE = 4;
+
+    // size must be a power of two >= MIN_SIZE
+    explicit FFT(int size);
+
+    int getSize() const;
+
+    // Natural order in, bit-reversed order out
+    void forward(float* re, float* im) const;
+
+    // Bit-reversed order in, natural order out, scaled by size
+    void inverse(float* re, float* im) const;
+
+    // forward() runs passes 0 .. getNumPasses() - 1; inverse() undoes them
+    // from the last down to 0. A pass may cover points [first, first +
+    // count) alone when both are multiples of getPassLength(pass).
+    int getNumPasses() const;
+    int getPassLength(int pass) const;
+    void forwardPass(float* re, float* im, int pass, int first, int count) const;
+    void inversePass(float* re, float* im, int pass, int first, int count) const;
+
+    // Storage position of natural-order bin k in a transformed array
+    int binPosition(int k) const;
+
+    static bool isPowerOfTwo(int n);
+
+private:
+    struct Pass {
+        int length;         // Butterfly span
+        int radix;          // 2 or 4
+        int twiddles;       // Offset into twiddleTable
+    };
+
+    int size;
+    std::vector<Pass> passes;           // Forward order (longest span first)
+    std::vector<float> twiddleTable;    // Per pass: re/im of W^j (radix 2) or W^j, W^2j, W^3j (radix 4)
+    std::vector<int> bitReversed;
+};
+
+#endif // FFT_H
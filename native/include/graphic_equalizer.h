@@ -0,0 +1,27 @@
+#ifndef GRAPHIC_EQUALIZER_H
+#define GRAPHIC_EQUALIZER_H
+
+#include "band_equalizer.h"
+#include "band_layout.h"
+
+/**
+ * NBands-Band Graphic Equalizer
+ * Band count, frequencies and shelf/peak topology come from
+ * BandLayout<NBands> at compile time, and the cascade is sized to match,
+ * so its section loop is fully unrolled while every band is active.
+ */
+template <int NBands>
+class GraphicEqualizer : public BandEqualizer<NBands> {
+public:
+    typedef BandLayout<NBands> Layout;
+    static constexpr int NUM_BANDS = NBands;
+
+    GraphicEqualizer(double sampleRate = 44100.0);
+    ~GraphicEqualizer();
+};
+
+extern template class GraphicEqualizer<5>;
+extern template class GraphicEqualizer<10>;
+extern template class GraphicEqualizer<31>;
+
+#endif // GRAPHIC_EQUALIZER_H
@@ -0,0 +1,153 @@
+#ifndef MULTIBAND_COMPRESSOR_H
+#define MULTIBAND_COMPRESSOR_H
+
+#include "equalizer.h"
+#include "parameter_channel.h"
+#include <atomic>
+
+/**
+ * Multiband compressor (stereo-linked, 3 to 5 bands)
+ * Splits the signal with 4th-order Linkwitz-Riley crossovers (two
+ * Butterworth BiquadFilter sections per half, run as BiquadCascades with
+ * left and right in SIMD lanes, capped at the AVX2 kernels), compresses
+ * each band and sums them.
+ * Lower bands pass through the all-pass response of every crossover above
+ * them, so with no gain reduction the sum is flat in magnitude. Those
+ * sections follow the band's low half in the same cascade: two lanes
+ * leave each cascade bound by its recursion latency, whatever its length,
+ * so fewer and longer cascades are cheaper.
+ *
+ * The first split reads the caller's frames directly (interleaved or
+ * separate channels) and the sum is written back in place, so chaining
+ * after the Equalizer needs no de-interleave copy.
+ *
+ * Dynamics run in blocks of GAIN_INTERVAL frames: band levels
+ * (max |L|, |R|) are taken four frames per vector, the peak of each
+ * interval drives a release-then-attack envelope with the bands in SIMD
+ * lanes, and the soft-knee gain computer (the only log/pow) runs once per
+ * interval per band that is near its threshold. Gains ramp linearly to
+ * each new value over the next interval.
+ *
+ * Threading: setters run on the control thread and publish a snapshot
+ * through a ParameterChannel; the audio thread adopts it at the next
+ * block, prepare() included (a new sample rate redesigns the crossovers
+ * and clears all state there).
+ */
+class MultibandCompressor {
+public:
+    static const int MIN_BANDS = 3;
+    static const int MAX_BANDS = 5;
+    static const int DEFAULT_BANDS = 3;
+    static const int GAIN_INTERVAL = 16;        // Frames between gain computer runs
+    static const int CHUNK = 256;               // Frames per band-split pass
+
+    struct BandSettings {
+        double thresholdDB;
+        double ratio;           // 1 = no compression
+        double kneeDB;          // Soft knee width
+        double attackMs;
+        double releaseMs;
+        double makeupDB;
+
+        BandSettings();
+    };
+
+    MultibandCompressor();
+    ~MultibandCompressor();
+
+    // Control thread: recompute for a sample rate and clear all state at
+    // the next block (bands and settings are kept; crossovers above 0.45
+    // of the new rate are designed at that limit until it rises again)
+    void prepare(double sampleRate);
+
+    // Control thread: clear filter and envelope state at the next block
+    void clear();
+
+    // Control thread: default bands, crossovers and settings (a recycled
+    // compressor); clears the band state
+    void restoreDefaults();
+
+    // Control thread: band count and its numBands - 1 ascending crossover
+    // frequencies (nullptr = default spacing). Clears the band state.
+    bool setBands(int numBands, const double* crossovers = nullptr);
+    int getNumBands() const;
+    double getCrossover(int index) const;
+
+    bool setBand(int band, const BandSettings& settings);
+    bool getBand(int band, BandSettings& settings) const;
+
+    // Clamp output to [-1, 1] (default); off when a limiter follows
+    void setOutputClamp(bool enabled);
+
+    // Audio thread: compress interleaved stereo or separate channels in place
+    void processInterleaved(float* buffer, int numFrames);
+    void processStereo(float* leftChannel, float* rightChannel, int numFrames);
+
+    // Current gain reduction of a band in dB (<= 0), for metering
+    double getGainReduction(int band) const;
+
+private:
+    typedef EqualizerSample T;
+    static const int LANES = 8;                 // Bands padded to two float quads
+
+    // Per-band dynamics as the audio thread uses them
+    struct Dynamics {
+        float threshold;        // dB
+        float slope;            // 1 / ratio - 1
+        float knee;             // dB
+        float kneeStart;        // Linear level where the knee begins
+        float attack;           // Per-interval smoothing coefficients
+        float release;
+        float makeup;           // Linear
+    };
+
+    struct Snapshot {
+        int numBands;
+        double crossovers[MAX_BANDS - 1];
+        double lowpass[MAX_BANDS - 1][5];       // Butterworth half of each LR4 crossover
+        double highpass[MAX_BANDS - 1][5];
+        double allpass[MAX_BANDS - 1][5];       // LR4 low + high of each crossover
+        Dynamics dynamics[MAX_BANDS];
+        bool clamp;
+        unsigned resetCount;
+    };
+
+    // Control thread
+    double sampleRate;
+    Snapshot staging;
+    BandSettings settings[MAX_BANDS];
+    ParameterChannel<Snapshot> parameters;
+
+    // Audio thread: band split (low half plus all-pass compensation, high
+    // half per crossover) and band buffers
+    BiquadCascade<T, MAX_BANDS> lowpass[MAX_BANDS - 1];
+    BiquadCascade<T, 2> highpass[MAX_BANDS - 1];
+    alignas(16) float bands[MAX_BANDS][2][CHUNK + 4];
+    alignas(16) float levels[MAX_BANDS][CHUNK + 4];
+    alignas(16) float gains[MAX_BANDS][CHUNK + 4];
+
+    // Audio thread: dynamics state, bands in lanes
+    alignas(16) float intervalPeak[LANES];
+    alignas(16) float peak[LANES];
+    alignas(16) float envelope[LANES];
+    alignas(16) float attack[LANES];
+    alignas(16) float release[LANES];
+    float gain[MAX_BANDS];
+    float gainTarget[MAX_BANDS];
+    float gainStep[MAX_BANDS];
+    int intervalPos;
+    int numBands;
+    float limit;
+    unsigned audioResetCount;
+    std::atomic<float> reduction[MAX_BANDS];
+    std::atomic<bool> clearRequested;
+
+    void publish();
+    void pullParameters();
+    void resetState(const Snapshot& p);
+    void updateGains(const Snapshot& p);
+    void process(float* left, float* right, int stride, int numFrames);
+    void processChunk(const Snapshot& p, float* left, float* right, int stride, int numFrames);
+};
+
+#endif // MULTIBAND_COMPRESSOR_H
@@ -0,0 +1,49 @@
+#ifndef PARAMETER_CHANNEL_H
+#define PARAMETER_CHANNEL_H
+
+#include <atomic>
+
+/**
+ * Lock-free parameter channel (triple buffer)
+ * One control thread writes complete snapshots, one audio thread reads
+ * them. The writer fills the back slot and publishes it with a single
+ * atomic exchange; the reader adopts the newest published slot at a block
+ * boundary with another exchange. Neither side blocks or allocates, and
+ * the reader always sees a whole snapshot, never a mix of two writes.
+ */
+template <typename T>
+class ParameterChannel {
+public:
+    ParameterChannel() : back(0), middle(1), front(2) {}
+
+    // Writer: slot to fill completely, then publish()
+    T& write() {
+        return slots[back];
+    }
+
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader: adopt the newest snapshot; returns true if a new one arrived
+    bool pull() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& read() const {
+        return slots[front];
+    }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4;
+
+    T slots[3];
+    int back;                               // Writer only
+    alignas(64) std::atomic<int> middle;    // Shared: index | FRESH
+    alignas(64) int front;                  // Reader only
+};
+
+#endif // PARAMETER_CHANNEL_H
@@ -0,0 +1,27 @@
+#ifndef PARAMETRIC_EQUALIZER_H
+#define PARAMETRIC_EQUALIZER_H
+
+#include "band_equalizer.h"
+
+/**
+ * Parametric Equalizer
+ * Up to MAX_BANDS user bands, each with its own type, frequency, gain
+ * and Q. Starts with the 10-band graphic layout.
+ *
+ * Band indices are positions in the band list: removing a band shifts
+ * the later ones down, and a new band is appended when there is room
+ * after the last one (otherwise it takes the first free position).
+ * Removed shelf/peaking bands fade out over the smoothing time; pass,
+ * notch and all-pass bands switch in and out directly.
+ */
+class ParametricEqualizer : public BandEqualizer<32> {
+public:
+    ParametricEqualizer(double sampleRate = 44100.0);
+    ~ParametricEqualizer();
+
+    int addBand(const BiquadFilter::Design& design) override;
+    bool removeBand(int bandIndex) override;
+    bool setBand(int bandIndex, const BiquadFilter::Design& design) override;
+};
+
+#endif // PARAMETRIC_EQUALIZER_H
@@ -0,0 +1,62 @@
+#ifndef PROCESSOR_POOL_H
+#define PROCESSOR_POOL_H
+
+#include "audio_processor.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Processor Pool - recycled AudioProcessors for short-lived instances
+ * Constructing an AudioProcessor allocates every stage's state (the
+ * convolution engine's partitions alone take most of a millisecond);
+ * AudioProcessor::reset() on one that exists takes microseconds. The pool
+ * keeps released processors, already reset to their configuration, and
+ * hands them out again: a preview player that comes and goes reuses the
+ * same state blocks, and reserve() builds them before they are needed.
+ *
+ * acquire() prefers a pooled processor with the same sample rate, block
+ * size and layout (no work at all), then any pooled one (reset to the
+ * configuration), then a new one. Either way it behaves exactly like a
+ * new processor initialized with the same arguments.
+ *
+ * The bindings keep one pool per Node environment, so worker_threads never
+ * share one. Threading: any control thread; a mutex guards the free list
+ * and is never taken on an audio thread.
+ */
+class ProcessorPool {
+public:
+    static const int DEFAULT_CAPACITY = 16;
+
+    ProcessorPool();
+    ~ProcessorPool();
+
+    std::unique_ptr<AudioProcessor> acquire(double sampleRate,
+                                            int maxBlockSize = AudioProcessor::DEFAULT_MAX_BLOCK_SIZE,
+                                            int numBands = Equalizer::DEFAULT_BANDS);
+
+    // Take a processor back (nothing may still be processing with it). It
+    // is reset and kept while fewer than the capacity are pooled, and
+    // destroyed otherwise.
+    void release(std::unique_ptr<AudioProcessor> processor);
+
+    // Build processors for a configuration ahead of time, up to the
+    // capacity; returns how many are pooled
+    int reserve(int count, double sampleRate,
+                int maxBlockSize = AudioProcessor::DEFAULT_MAX_BLOCK_SIZE,
+                int numBands = Equalizer::DEFAULT_BANDS);
+
+    // Most processors kept (surplus ones are destroyed)
+    void setCapacity(int capacity);
+    int getCapacity() const;
+    int getPooledCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<AudioProcessor>> pooled;
+    int capacity;
+
+    static bool matches(const AudioProcessor& processor, double sampleRate, int maxBlockSize, int numBands);
+};
+
+#endif // PROCESSOR_POOL_H
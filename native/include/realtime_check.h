@@ -0,0 +1,60 @@
+#ifndef REALTIME_CHECK_H
+#define REALTIME_CHECK_H
+
+/**
+ * Real-time safety checker
+ * In builds with EQ_REALTIME_CHECK (the realtime_check target), a thread
+ * inside a RealtimeScope is an audio thread, and these calls made on it
+ * are violations:
+ * - heap allocation or release (operator new/delete, malloc, calloc,
+ *   realloc, free)
+ * - blocking mutex locks
+ * Each violation is counted. In abort mode the checker also prints the
+ * kind and aborts, so a debugger or core dump shows the offending call.
+ * Processing entry points (AudioProcessor, CapturePipeline) open a scope
+ * for each call.
+ *
+ * The malloc family and pthread_mutex_lock are intercepted on glibc;
+ * operator new/delete everywhere. Without EQ_REALTIME_CHECK a scope is
+ * empty and nothing is intercepted.
+ */
+class RealtimeCheck {
+public:
+    enum Violation {
+        ALLOCATION,
+        DEALLOCATION,
+        LOCK,
+        NUM_VIOLATIONS
+    };
+
+#if defined(EQ_REALTIME_CHECK)
+    static bool isRealtimeThread();
+
+    // Count violations (default) or abort at the first one
+    static void setAbortOnViolation(bool enabled);
+
+    static long long getViolations(Violation kind);
+    static long long getTotalViolations();
+    static void resetViolations();
+    static const char* getViolationName(Violation kind);
+
+    // Interceptors: record a violation if the calling thread is real-time
+    static void report(Violation kind);
+#endif
+};
+
+class RealtimeScope {
+public:
+#if defined(EQ_REALTIME_CHECK)
+    RealtimeScope();
+    ~RealtimeScope();
+#else
+    RealtimeScope() {}
+    ~RealtimeScope() {}
+#endif
+
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+};
+
+#endif // REALTIME_CHECK_H
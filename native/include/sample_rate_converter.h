@@ -0,0 +1,101 @@
+#ifndef SAMPLE_RATE_CONVERTER_H
+#define SAMPLE_RATE_CONVERTER_H
+
+#include <atomic>
+#include <vector>
+
+/**
+ * Streaming polyphase sample-rate converter (interleaved, 1 to 8 channels)
+ * Each output frame is a dot product of the newest input history with one
+ * phase of a Kaiser-windowed sinc, four taps per SIMD vector. The cutoff
+ * sits at the lower of the two Nyquist frequencies, so aliasing only
+ * reaches the transition band above the quality tier's passband.
+ *
+ * Phases: when both rates are whole numbers whose reduced ratio has at
+ * most MAX_EXACT_PHASES output steps (every pair of standard rates), the
+ * table holds one row per output phase and the kernel reads it directly.
+ * Any other ratio uses a fixed grid of rows and interpolates linearly
+ * between the two nearest, once per output frame for all channels.
+ *
+ * Latency: the history starts with taps - 1 frames of silence, so output
+ * starts with the first call and is delayed by getLatency() output frames.
+ *
+ * Threading: prepare() designs the filter and allocates; it must not run
+ * concurrently with process(). clear() may be called from any thread and
+ * takes effect at the next call.
+ */
+class SampleRateConverter {
+public:
+    static const int MAX_CHANNELS = 8;
+    static const int MAX_EXACT_PHASES = 1024;
+    static const int CHUNK = 256;               // Input frames per pass
+    static constexpr double MAX_RATIO = 16.0;   // Either direction
+
+    enum Quality {
+        QUALITY_FAST,       // 16 taps, ~74% passband, ~60 dB
+        QUALITY_MEDIUM,     // 64 taps, ~90% passband, ~96 dB (default)
+        QUALITY_BEST        // 128 taps, ~94% passband, ~120 dB
+    };
+
+    SampleRateConverter();
+    ~SampleRateConverter();
+
+    // Control thread: design the filter for a rate pair and allocate the
+    // history. False for a ratio beyond MAX_RATIO or a bad channel count.
+    bool prepare(double inputRate, double outputRate, int numChannels,
+                 Quality quality = QUALITY_MEDIUM);
+
+    // Positive rates within MAX_RATIO of each other
+    static bool isSupported(double inputRate, double outputRate);
+
+    // Clear the history at the next call
+    void clear();
+
+    // Audio thread: convert numFrames interleaved frames into output and
+    // return the frames written (at most getMaxOutputFrames(numFrames))
+    int process(const float* input, int numFrames, float* output);
+
+    int getMaxOutputFrames(int inputFrames) const;
+    double getLatency() const;                  // Output frames
+    int getNumTaps() const;
+    int getNumChannels() const;
+    double getInputRate() const;
+    double getOutputRate() const;
+    Quality getQuality() const;
+    bool isExact() const;                       // Rational ratio, no phase interpolation
+
+    static const char* getQualityName(Quality quality);
+
+private:
+    double inputRate;
+    double outputRate;
+    int numChannels;
+    Quality quality;
+    int numTaps;                        // Multiple of 8
+
+    // Position of the next output: whole input frames into the history
+    // plus frac / denominator. Each output advances by step / denominator.
+    bool exact;
+    long long denominator;
+    long long stepWhole;
+    long long stepFrac;
+    int phaseShift;                     // Interpolated: frac >> phaseShift = row
+    float phaseScale;                   // Interpolated: weight of the next row per unit of frac
+
+    std::vector<float> phases;          // Rows of numTaps coefficients
+    std::vector<float> deltas;          // Interpolated: next row minus this row
+    std::vector<float> row;             // Interpolated: the blended row
+
+    // Audio thread
+    std::vector<float> history;         // numChannels x (numTaps + CHUNK), planar
+    int historyStride;
+    int held;                           // Frames in each history row
+    long long frac;
+    std::atomic<bool> clearRequested;
+
+    void design();
+    void reset();
+    int processChunk(const float* input, int numFrames, float* output);
+};
+
+#endif // SAMPLE_RATE_CONVERTER_H
@@ -0,0 +1,504 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EQ_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX__) || defined(EQ_ASSUME_SSE41)
+#define EQ_HAVE_SSE41 1
+#include <smmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define EQ_HAVE_AVX 1
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define EQ_HAVE_AVX2 1
+#endif
+
+#if defined(__AVX512F__)
+#define EQ_HAVE_AVX512 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define EQ_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+/**
+ * SIMD lane wrappers for the DSP kernels
+ * Each wrapper carries WIDTH audio channels, one per lane, in float or
+ * double precision (T). Every operation mirrors the scalar expression it
+ * replaces (same rounding, same min/max operand order) so that a kernel
+ * written against these wrappers produces bit-identical output for every
+ * width.
+ *
+ * sum() adds the lanes of one vector (a horizontal reduction, for dot
+ * products that run along the lanes rather than across channels).
+ *
+ * The kernel variant sources (dsp_kernels_*.cpp) are built with wider
+ * instruction sets than the rest of the module and define
+ * EQ_SIMD_PRIVATE: the wrappers then get internal linkage, so the linker
+ * can never hand baseline code a copy compiled for AVX-512.
+ */
+
+#if defined(EQ_SIMD_PRIVATE)
+namespace {
+#endif
+
+// One channel, plain C++ - the reference every other wrapper must match
+struct ScalarDouble {
+    typedef double T;
+    typedef double Vec;
+    static const int WIDTH = 1;
+
+    static inline Vec set1(double v) { return v; }
+    static inline Vec load(const double* p) { return *p; }
+    static inline void store(double* p, Vec v) { *p = v; }
+    static inline Vec add(Vec a, Vec b) { return a + b; }
+    static inline Vec sub(Vec a, Vec b) { return a - b; }
+    static inline Vec mul(Vec a, Vec b) { return a * b; }
+
+    // std::max(lo, std::min(hi, v))
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return std::max(lo, std::min(hi, v)); }
+
+    // std::max(a, b), std::fabs(v), a / b
+    static inline Vec max(Vec a, Vec b) { return std::max(a, b); }
+    static inline Vec abs(Vec v) { return std::fabs(v); }
+    static inline Vec div(Vec a, Vec b) { return a / b; }
+    static inline T sum(Vec v) { return v; }
+
+    // WIDTH adjacent floats (one interleaved frame slice)
+    static inline Vec loadFloats(const float* p) { return *p; }
+    static inline void storeFloats(float* p, Vec v) { *p = static_cast<float>(v); }
+
+    // One float per lane from separate channel pointers
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) { return ch[0][offset]; }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        ch[0][offset] = static_cast<float>(v);
+    }
+};
+
+// One channel, single precision
+struct ScalarFloat {
+    typedef float T;
+    typedef float Vec;
+    static const int WIDTH = 1;
+
+    static inline Vec set1(float v) { return v; }
+    static inline Vec load(const float* p) { return *p; }
+    static inline void store(float* p, Vec v) { *p = v; }
+    static inline Vec add(Vec a, Vec b) { return a + b; }
+    static inline Vec sub(Vec a, Vec b) { return a - b; }
+    static inline Vec mul(Vec a, Vec b) { return a * b; }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return std::max(lo, std::min(hi, v)); }
+    static inline Vec max(Vec a, Vec b) { return std::max(a, b); }
+    static inline Vec abs(Vec v) { return std::fabs(v); }
+    static inline Vec div(Vec a, Vec b) { return a / b; }
+    static inline T sum(Vec v) { return v; }
+
+    static inline Vec loadFloats(const float* p) { return *p; }
+    static inline void storeFloats(float* p, Vec v) { *p = v; }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) { return ch[0][offset]; }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) { ch[0][offset] = v; }
+};
+
+#ifdef EQ_HAVE_SSE2
+// Two channels in one SSE2 register
+struct Sse2Double2 {
+    typedef double T;
+    typedef __m128d Vec;
+    static const int WIDTH = 2;
+
+    static inline Vec set1(double v) { return _mm_set1_pd(v); }
+    static inline Vec load(const double* p) { return _mm_loadu_pd(p); }
+    static inline void store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+
+    // minpd/maxpd return the second operand on unordered compares,
+    // which is exactly what std::min(hi, v) / std::max(lo, v) do
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return _mm_max_pd(_mm_min_pd(v, hi), lo); }
+    static inline Vec max(Vec a, Vec b) { return _mm_max_pd(b, a); }
+    static inline Vec abs(Vec v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); }
+    static inline Vec div(Vec a, Vec b) { return _mm_div_pd(a, b); }
+    static inline T sum(Vec v) { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+
+    static inline Vec loadFloats(const float* p) {
+        return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+    }
+    static inline void storeFloats(float* p, Vec v) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_castps_si128(_mm_cvtpd_ps(v)));
+    }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        return _mm_set_pd(ch[1][offset], ch[0][offset]);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        __m128 f = _mm_cvtpd_ps(v);
+        ch[0][offset] = _mm_cvtss_f32(f);
+        ch[1][offset] = _mm_cvtss_f32(_mm_shuffle_ps(f, f, 1));
+    }
+};
+
+// Four channels in one SSE register, single precision
+struct Sse2Float4 {
+    typedef float T;
+    typedef __m128 Vec;
+    static const int WIDTH = 4;
+
+    static inline Vec set1(float v) { return _mm_set1_ps(v); }
+    static inline Vec load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return _mm_max_ps(_mm_min_ps(v, hi), lo); }
+    static inline Vec max(Vec a, Vec b) { return _mm_max_ps(b, a); }
+    static inline Vec abs(Vec v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+    static inline Vec div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+    static inline T sum(Vec v) {
+        __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    }
+
+    static inline Vec loadFloats(const float* p) { return _mm_loadu_ps(p); }
+    static inline void storeFloats(float* p, Vec v) { _mm_storeu_ps(p, v); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        return _mm_set_ps(ch[3][offset], ch[2][offset], ch[1][offset], ch[0][offset]);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, v);
+        for (int c = 0; c < 4; c++) ch[c][offset] = lanes[c];
+    }
+};
+
+// Two channels in the low half of an SSE register (upper lanes stay zero)
+struct Sse2Float2 {
+    typedef float T;
+    typedef __m128 Vec;
+    static const int WIDTH = 2;
+
+    static inline Vec set1(float v) { return _mm_set1_ps(v); }
+    static inline Vec load(const float* p) {
+        return _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+    }
+    static inline void store(float* p, Vec v) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_castps_si128(v));
+    }
+    static inline Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return _mm_max_ps(_mm_min_ps(v, hi), lo); }
+    static inline Vec max(Vec a, Vec b) { return _mm_max_ps(b, a); }
+    static inline Vec abs(Vec v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+    static inline Vec div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+    static inline T sum(Vec v) { return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1))); }
+
+    static inline Vec loadFloats(const float* p) { return load(p); }
+    static inline void storeFloats(float* p, Vec v) { store(p, v); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        return _mm_set_ps(0.0f, 0.0f, ch[1][offset], ch[0][offset]);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        ch[0][offset] = _mm_cvtss_f32(v);
+        ch[1][offset] = _mm_cvtss_f32(_mm_shuffle_ps(v, v, 1));
+    }
+};
+#endif
+
+#ifdef EQ_HAVE_AVX
+// Four channels in one AVX register
+struct AvxDouble4 {
+    typedef double T;
+    typedef __m256d Vec;
+    static const int WIDTH = 4;
+
+    static inline Vec set1(double v) { return _mm256_set1_pd(v); }
+    static inline Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    static inline void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return _mm256_max_pd(_mm256_min_pd(v, hi), lo); }
+    static inline Vec max(Vec a, Vec b) { return _mm256_max_pd(b, a); }
+    static inline Vec abs(Vec v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+    static inline Vec div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+    static inline T sum(Vec v) {
+        __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+    }
+
+    static inline Vec loadFloats(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+    static inline void storeFloats(float* p, Vec v) { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        return _mm256_set_pd(ch[3][offset], ch[2][offset], ch[1][offset], ch[0][offset]);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, _mm256_cvtpd_ps(v));
+        for (int c = 0; c < 4; c++) ch[c][offset] = lanes[c];
+    }
+};
+
+// Eight channels in one AVX register, single precision
+struct AvxFloat8 {
+    typedef float T;
+    typedef __m256 Vec;
+    static const int WIDTH = 8;
+
+    static inline Vec set1(float v) { return _mm256_set1_ps(v); }
+    static inline Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return _mm256_max_ps(_mm256_min_ps(v, hi), lo); }
+    static inline Vec max(Vec a, Vec b) { return _mm256_max_ps(b, a); }
+    static inline Vec abs(Vec v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+    static inline Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+    static inline T sum(Vec v) {
+        __m128 quad = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        __m128 pairs = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    }
+
+    static inline Vec loadFloats(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void storeFloats(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        return _mm256_set_ps(ch[7][offset], ch[6][offset], ch[5][offset], ch[4][offset],
+                             ch[3][offset], ch[2][offset], ch[1][offset], ch[0][offset]);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, v);
+        for (int c = 0; c < 8; c++) ch[c][offset] = lanes[c];
+    }
+};
+#endif
+
+#ifdef EQ_HAVE_AVX512
+// Eight channels in one AVX-512 register
+struct Avx512Double8 {
+    typedef double T;
+    typedef __m512d Vec;
+    static const int WIDTH = 8;
+
+    static inline Vec set1(double v) { return _mm512_set1_pd(v); }
+    static inline Vec load(const double* p) { return _mm512_loadu_pd(p); }
+    static inline void store(double* p, Vec v) { _mm512_storeu_pd(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) { return _mm512_max_pd(_mm512_min_pd(v, hi), lo); }
+    static inline Vec max(Vec a, Vec b) { return _mm512_max_pd(b, a); }
+    static inline Vec abs(Vec v) { return _mm512_abs_pd(v); }
+    static inline Vec div(Vec a, Vec b) { return _mm512_div_pd(a, b); }
+    static inline T sum(Vec v) {
+        __m256d quad = _mm256_add_pd(_mm512_castpd512_pd256(v), _mm512_extractf64x4_pd(v, 1));
+        __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(quad), _mm256_extractf128_pd(quad, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+    }
+
+    static inline Vec loadFloats(const float* p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+    static inline void storeFloats(float* p, Vec v) { _mm256_storeu_ps(p, _mm512_cvtpd_ps(v)); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        return _mm512_set_pd(ch[7][offset], ch[6][offset], ch[5][offset], ch[4][offset],
+                             ch[3][offset], ch[2][offset], ch[1][offset], ch[0][offset]);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, _mm512_cvtpd_ps(v));
+        for (int c = 0; c < 8; c++) ch[c][offset] = lanes[c];
+    }
+};
+#endif
+
+#ifdef EQ_HAVE_NEON
+// Two channels in one NEON register (AArch64 only - ARMv7 has no f64 lanes)
+struct NeonDouble2 {
+    typedef double T;
+    typedef float64x2_t Vec;
+    static const int WIDTH = 2;
+
+    static inline Vec set1(double v) { return vdupq_n_f64(v); }
+    static inline Vec load(const double* p) { return vld1q_f64(p); }
+    static inline void store(double* p, Vec v) { vst1q_f64(p, v); }
+    static inline Vec add(Vec a, Vec b) { return vaddq_f64(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return vsubq_f64(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return vmulq_f64(a, b); }
+
+    // fmin/fmax propagate NaN, so select explicitly to match std::min/std::max
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) {
+        Vec m = vbslq_f64(vcltq_f64(v, hi), v, hi);
+        return vbslq_f64(vcltq_f64(lo, m), m, lo);
+    }
+    static inline Vec max(Vec a, Vec b) { return vbslq_f64(vcltq_f64(a, b), b, a); }
+    static inline Vec abs(Vec v) { return vabsq_f64(v); }
+    static inline Vec div(Vec a, Vec b) { return vdivq_f64(a, b); }
+    static inline T sum(Vec v) { return vaddvq_f64(v); }
+
+    static inline Vec loadFloats(const float* p) { return vcvt_f64_f32(vld1_f32(p)); }
+    static inline void storeFloats(float* p, Vec v) { vst1_f32(p, vcvt_f32_f64(v)); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        double lanes[2] = { ch[0][offset], ch[1][offset] };
+        return vld1q_f64(lanes);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        float32x2_t f = vcvt_f32_f64(v);
+        ch[0][offset] = vget_lane_f32(f, 0);
+        ch[1][offset] = vget_lane_f32(f, 1);
+    }
+};
+
+// Four channels in one NEON register, single precision
+struct NeonFloat4 {
+    typedef float T;
+    typedef float32x4_t Vec;
+    static const int WIDTH = 4;
+
+    static inline Vec set1(float v) { return vdupq_n_f32(v); }
+    static inline Vec load(const float* p) { return vld1q_f32(p); }
+    static inline void store(float* p, Vec v) { vst1q_f32(p, v); }
+    static inline Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) {
+        Vec m = vbslq_f32(vcltq_f32(v, hi), v, hi);
+        return vbslq_f32(vcltq_f32(lo, m), m, lo);
+    }
+    static inline Vec max(Vec a, Vec b) { return vbslq_f32(vcltq_f32(a, b), b, a); }
+    static inline Vec abs(Vec v) { return vabsq_f32(v); }
+    static inline Vec div(Vec a, Vec b) { return vdivq_f32(a, b); }
+    static inline T sum(Vec v) { return vaddvq_f32(v); }
+
+    static inline Vec loadFloats(const float* p) { return vld1q_f32(p); }
+    static inline void storeFloats(float* p, Vec v) { vst1q_f32(p, v); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        float lanes[4] = { ch[0][offset], ch[1][offset], ch[2][offset], ch[3][offset] };
+        return vld1q_f32(lanes);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        float lanes[4];
+        vst1q_f32(lanes, v);
+        for (int c = 0; c < 4; c++) ch[c][offset] = lanes[c];
+    }
+};
+
+// Two channels in a 64-bit NEON register, single precision
+struct NeonFloat2 {
+    typedef float T;
+    typedef float32x2_t Vec;
+    static const int WIDTH = 2;
+
+    static inline Vec set1(float v) { return vdup_n_f32(v); }
+    static inline Vec load(const float* p) { return vld1_f32(p); }
+    static inline void store(float* p, Vec v) { vst1_f32(p, v); }
+    static inline Vec add(Vec a, Vec b) { return vadd_f32(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return vsub_f32(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return vmul_f32(a, b); }
+    static inline Vec clamp(Vec v, Vec lo, Vec hi) {
+        Vec m = vbsl_f32(vclt_f32(v, hi), v, hi);
+        return vbsl_f32(vclt_f32(lo, m), m, lo);
+    }
+    static inline Vec max(Vec a, Vec b) { return vbsl_f32(vclt_f32(a, b), b, a); }
+    static inline Vec abs(Vec v) { return vabs_f32(v); }
+    static inline Vec div(Vec a, Vec b) { return vdiv_f32(a, b); }
+    static inline T sum(Vec v) { return vaddv_f32(v); }
+
+    static inline Vec loadFloats(const float* p) { return vld1_f32(p); }
+    static inline void storeFloats(float* p, Vec v) { vst1_f32(p, v); }
+
+    static inline Vec gather(const float* const* ch, ptrdiff_t offset) {
+        float lanes[2] = { ch[0][offset], ch[1][offset] };
+        return vld1_f32(lanes);
+    }
+    static inline void scatter(float* const* ch, ptrdiff_t offset, Vec v) {
+        ch[0][offset] = vget_lane_f32(v, 0);
+        ch[1][offset] = vget_lane_f32(v, 1);
+    }
+};
+#endif
+
+// Wrappers available per precision: Pair carries 2 channels, Quad 4, Oct 8.
+// Missing widths alias the scalar wrapper and have their HAS_ flag cleared.
+template <typename T> struct SimdLanes;
+
+template <> struct SimdLanes<double> {
+    typedef ScalarDouble Scalar;
+#if defined(EQ_HAVE_SSE2)
+    typedef Sse2Double2 Pair;
+    static const bool HAS_PAIR = true;
+#elif defined(EQ_HAVE_NEON)
+    typedef NeonDouble2 Pair;
+    static const bool HAS_PAIR = true;
+#else
+    typedef ScalarDouble Pair;
+    static const bool HAS_PAIR = false;
+#endif
+#if defined(EQ_HAVE_AVX)
+    typedef AvxDouble4 Quad;
+    static const bool HAS_QUAD = true;
+#else
+    typedef ScalarDouble Quad;
+    static const bool HAS_QUAD = false;
+#endif
+#if defined(EQ_HAVE_AVX512)
+    typedef Avx512Double8 Oct;
+    static const bool HAS_OCT = true;
+#else
+    typedef ScalarDouble Oct;
+    static const bool HAS_OCT = false;
+#endif
+};
+
+template <> struct SimdLanes<float> {
+    typedef ScalarFloat Scalar;
+#if defined(EQ_HAVE_SSE2)
+    typedef Sse2Float2 Pair;
+    typedef Sse2Float4 Quad;
+    static const bool HAS_PAIR = true;
+    static const bool HAS_QUAD = true;
+#elif defined(EQ_HAVE_NEON)
+    typedef NeonFloat2 Pair;
+    typedef NeonFloat4 Quad;
+    static const bool HAS_PAIR = true;
+    static const bool HAS_QUAD = true;
+#else
+    typedef ScalarFloat Pair;
+    typedef ScalarFloat Quad;
+    static const bool HAS_PAIR = false;
+    static const bool HAS_QUAD = false;
+#endif
+#if defined(EQ_HAVE_AVX)
+    typedef AvxFloat8 Oct;
+    static const bool HAS_OCT = true;
+#else
+    typedef ScalarFloat Oct;
+    static const bool HAS_OCT = false;
+#endif
+};
+
+#if defined(EQ_SIMD_PRIVATE)
+}
+#endif
+
+#endif // SIMD_H
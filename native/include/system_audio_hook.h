@@ -11,6 +11,7 @@
 #include <atomic>
 #include <memory>
 #include "equalizer.h"
+#include "capture_pipeline.h"
 
 /**
  * System-wide Audio Hook using Windows WASAPI
@@ -52,9 +53,8 @@ private:
     UINT32 bufferFrameCount;
     
     // Processing
-    std::shared_ptr<Equalizer> equalizer;
+    CapturePipeline pipeline;
     std::atomic<bool> capturing;
-    std::atomic<bool> enabled;
     std::thread captureThread;
     
     // Audio processing loop
@@ -64,9 +64,6 @@ private:
     bool initializeAudioDevice();
     bool initializeAudioClient();
     void cleanup();
-    
-    // Process audio buffer
-    void processAudioBuffer(float* buffer, UINT32 numFrames, int channels);
 };
 
 #endif // SYSTEM_AUDIO_HOOK_H
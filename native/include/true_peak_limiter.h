@@ -0,0 +1,114 @@
+#ifndef TRUE_PEAK_LIMITER_H
+#define TRUE_PEAK_LIMITER_H
+
+#include <atomic>
+
+/**
+ * Lookahead true-peak limiter (stereo-linked)
+ * Replaces the hard [-1, 1] clamp at the end of the chain: instead of
+ * flattening the waveform it turns the gain down just before a peak and
+ * back up afterwards, so boosted curves stay clean and the result stays
+ * below the ceiling between samples too (what a DAC reconstructs).
+ *
+ * Detector: 4x polyphase interpolation (48-tap windowed sinc, 12 taps per
+ * phase) gives the true peak of each sample interval; both channels and
+ * all phases are reduced to one required gain per frame, four frames at
+ * a time on SSE2/NEON. Gain: the required gain is held (sliding minimum
+ * over the attack window, van Herk/Gil-Werman), released exponentially
+ * and smoothed with a box average over the attack window, so the gain
+ * reaches its minimum by the time the peak leaves the delay line. The
+ * output is the input delayed by getLatency() frames times the gain.
+ *
+ * Signals below the ceiling come out as an exact delayed copy (gain
+ * 1.0f). Chunks whose sample peak bounds the interpolated peak below the
+ * ceiling skip the interpolation, and with the gain at rest they skip
+ * the gain stage too. All storage is fixed-size; nothing allocates after
+ * prepare().
+ */
+class TruePeakLimiter {
+public:
+    static const int MIN_LOOKAHEAD = 16;       // Covers the detector's taps
+    static const int MAX_LOOKAHEAD = 1024;
+    static const int CHUNK = 256;               // Frames per detector pass
+    static const int PHASES = 4;
+    static const int PHASE_TAPS = 12;
+    static const int DETECTOR_DELAY = 6;       // Newest frame to the sample it rates
+
+    TruePeakLimiter();
+
+    // Control thread: pick the lookahead (~1.5 ms) for a sample rate and
+    // clear all state; must not run concurrently with process()
+    void prepare(double sampleRate);
+
+    // Any thread: the same for a new sample rate, applied (with a clear)
+    // at the next block, so it may run while audio is processing
+    void setSampleRate(double sampleRate);
+
+    // Control thread: clear the delay line and gain at the next block
+    void clear();
+
+    // Control thread: default ceiling and release (a recycled limiter)
+    void restoreDefaults();
+
+    // Any thread: ceiling in dBTP, release time, gain applied ahead of the
+    // detector (ramped over one block)
+    void setCeiling(double dBTP);
+    void setRelease(double milliseconds);
+    void setInputGain(double gain);
+    double getCeiling() const;
+    double getInputGain() const;
+
+    // Audio thread: limit interleaved stereo or separate channels in place
+    void processInterleaved(float* buffer, int numFrames);
+    void processStereo(float* leftChannel, float* rightChannel, int numFrames);
+
+    int getLatency() const;
+
+private:
+    double sampleRate;
+    int lookahead;
+    int attack;                                 // Smoothing window
+    int hold;                                   // attack + 1: both ends of every interval
+    std::atomic<int> latency;                   // Lookahead for the latest rate
+
+    std::atomic<double> requestedRate;
+    std::atomic<bool> rateRequested;
+
+    std::atomic<float> ceiling;                 // Linear
+    std::atomic<float> releaseMs;
+    std::atomic<float> targetGain;
+    std::atomic<bool> clearRequested;
+
+    // Interpolation phases 1..3 (phase 0 is the sample itself)
+    alignas(16) float phaseTaps[PHASES - 1][PHASE_TAPS];
+    float tapBound;                             // Largest interpolated / sample peak ratio
+
+    // Audio thread: per channel, lookahead frames of history then the chunk
+    alignas(16) float delayLine[2][MAX_LOOKAHEAD + CHUNK + 4];
+    alignas(16) float required[CHUNK + 4];
+
+    // Sliding minimum: the current block's values and prefix minimum, the
+    // previous block's suffix minima
+    float holdValues[MAX_LOOKAHEAD];
+    float holdSuffix[MAX_LOOKAHEAD + 1];
+    float holdPrefix;
+    int holdPos;
+
+    // Box average of the released gain
+    float boxValues[MAX_LOOKAHEAD];
+    double boxSum;
+    int boxPos;
+
+    float reduction;                            // 1 - released gain
+    float inputGain;
+
+    static int lookaheadFor(double sampleRate);
+    void configure(double sampleRate);
+    void reset();
+    void process(float* left, float* right, int stride, int numFrames);
+    void processChunk(float* left, float* right, int stride, int numFrames, float decay);
+    bool detect(int numFrames);
+    void applyGain(float* left, float* right, int stride, int numFrames, float decay);
+};
+
+#endif // TRUE_PEAK_LIMITER_H
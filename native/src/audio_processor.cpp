@@ -1,48 +1,294 @@
 #include "audio_processor.h"
+#include "denormals.h"
+#include "realtime_check.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 AudioProcessor::AudioProcessor()
-    : sampleRate(44100.0), initialized(false) {
-    equalizer = std::make_unique<Equalizer>(sampleRate);
+    : sampleRate(44100.0), maxBlockSize(DEFAULT_MAX_BLOCK_SIZE), layout(Equalizer::DEFAULT_BANDS), initialized(false),
+      framePosition(0), stage(STAGE_EQ), linearPhaseDelay(0), compressing(false), limiting(false),
+      autoPreGain(true), preGainStale(false), stream(nullptr), streamInputRate(44100.0), streamOutputRate(44100.0),
+      streamQuality(SampleRateConverter::QUALITY_MEDIUM) {
+    equalizer = Equalizer::create(Equalizer::DEFAULT_BANDS, getSampleRate());
 }
 
 AudioProcessor::~AudioProcessor() {}
 
-void AudioProcessor::initialize(double sr) {
-    sampleRate = sr;
-    equalizer = std::make_unique<Equalizer>(sampleRate);
+void AudioProcessor::initialize(double sr, int maxBlock, int numBands) {
+    sampleRate.store(sr, std::memory_order_relaxed);
+    maxBlockSize.store(std::max(1, maxBlock));
+    if (!Equalizer::isSupportedBandCount(numBands)) {
+        numBands = Equalizer::DEFAULT_BANDS;
+    }
+    layout = numBands;
+    equalizer = Equalizer::create(numBands, sr);
+    automation.clear();
+    framePosition.store(0);
+    stage.store(STAGE_EQ);
+    convolution.clear();
+    compressor.prepare(sr);
+    limiter.prepare(sr);
+    updateOutputClamps(isCompressorEnabled(), isLimiterEnabled());
+    updatePreGain();
+    setStreamRates(sr, sr);
     initialized = true;
 }
 
+int AudioProcessor::getMaxBlockSize() const {
+    return maxBlockSize.load(std::memory_order_relaxed);
+}
+
+int AudioProcessor::getLayout() const {
+    return layout;
+}
+
+void AudioProcessor::reset(double sr, int maxBlock, int numBands) {
+    // What initialize keeps goes back to its defaults first
+    compressing.store(false);
+    limiting.store(false);
+    autoPreGain = true;
+    linearPhaseDelay = 0;
+    compressor.restoreDefaults();
+    limiter.restoreDefaults();
+    convolution.restoreDefaults();
+    initialize(sr, maxBlock, numBands);
+}
+
+bool AudioProcessor::reconfigure(double sr, int maxBlock) {
+    if (!(sr > 0.0)) return false;
+    if (!initialized) {
+        initialize(sr, maxBlock > 0 ? maxBlock : getMaxBlockSize(), Equalizer::DEFAULT_BANDS);
+        return true;
+    }
+    
+    // Later processing calls chunk to the new size; nothing is sized by it
+    // except the stream buffer, rebuilt below
+    if (maxBlock > 0) maxBlockSize.store(maxBlock, std::memory_order_relaxed);
+    
+    if (sr != getSampleRate()) {
+        // Each stage keeps its settings, redesigns at the new rate and
+        // clears its state at its next block
+        sampleRate.store(sr, std::memory_order_relaxed);
+        equalizer->setSampleRate(sr);
+        compressor.prepare(sr);
+        limiter.setSampleRate(sr);
+        convolution.clear();
+        
+        // Same length as before, so the engine keeps its layout and only
+        // a new kernel is published
+        if (linearPhaseDelay > 0) {
+            assert(linearPhaseDelay * 2 <= convolution.getMaxTaps());
+            loadLinearPhaseEQ(linearPhaseDelay * 2);
+        }
+        updatePreGain();
+    }
+    
+    // Same stream rates around the new processing rate where possible
+    if (!SampleRateConverter::isSupported(streamInputRate, sr)) streamInputRate = sr;
+    if (!SampleRateConverter::isSupported(sr, streamOutputRate)) streamOutputRate = sr;
+    publishStream();
+    return true;
+}
+
+double AudioProcessor::getSampleRate() const {
+    return sampleRate.load(std::memory_order_relaxed);
+}
+
 void AudioProcessor::processInterleavedStereo(float* buffer, int numSamples) {
-    if (!initialized || !equalizer->isEnabled()) return;
+    if (!initialized) return;
+    DenormalGuard denormals;
+    RealtimeScope realtime;
     
-    // De-interleave stereo buffer
-    int numFrames = numSamples / 2;
-    leftBuffer.resize(numFrames);
-    rightBuffer.resize(numFrames);
+    // Filter frames in place - no de-interleave copy, no allocation
+    Stage current = (Stage)stage.load(std::memory_order_acquire);
+    bool compressed = compressing.load(std::memory_order_acquire);
+    bool limited = limiting.load(std::memory_order_acquire);
+    processTimeline(numSamples / 2, [&](int offset, int frames) {
+        float* block = buffer + offset * 2;
+        if (current != STAGE_CONVOLUTION) equalizer->processInterleaved(block, 2, frames);
+        if (current != STAGE_EQ) convolution.processInterleaved(block, frames);
+        if (compressed) compressor.processInterleaved(block, frames);
+        if (limited) limiter.processInterleaved(block, frames);
+    });
+}
+
+void AudioProcessor::processSeparateChannels(float* leftChannel, float* rightChannel, int numSamples) {
+    if (!initialized) return;
+    DenormalGuard denormals;
+    RealtimeScope realtime;
+    Stage current = (Stage)stage.load(std::memory_order_acquire);
+    bool compressed = compressing.load(std::memory_order_acquire);
+    bool limited = limiting.load(std::memory_order_acquire);
+    processTimeline(numSamples, [&](int offset, int frames) {
+        float* left = leftChannel + offset;
+        float* right = rightChannel + offset;
+        if (current != STAGE_CONVOLUTION) equalizer->processStereo(left, right, frames);
+        if (current != STAGE_EQ) convolution.processStereo(left, right, frames);
+        if (compressed) compressor.processStereo(left, right, frames);
+        if (limited) limiter.processStereo(left, right, frames);
+    });
+}
+
+bool AudioProcessor::setStreamRates(double inputRate, double outputRate, SampleRateConverter::Quality quality) {
+    double rate = getSampleRate();
+    if (!SampleRateConverter::isSupported(inputRate, rate) ||
+        !SampleRateConverter::isSupported(rate, outputRate)) {
+        return false;
+    }
     
-    for (int i = 0; i < numFrames; i++) {
-        leftBuffer[i] = buffer[i * 2];
-        rightBuffer[i] = buffer[i * 2 + 1];
+    streamInputRate = inputRate;
+    streamOutputRate = outputRate;
+    streamQuality = quality;
+    publishStream();
+    return true;
+}
+
+void AudioProcessor::publishStream() {
+    std::unique_ptr<Stream> next = std::make_unique<Stream>();
+    int blockSize = getMaxBlockSize();
+    double rate = getSampleRate();
+    next->rate = rate;
+    next->convertingInput = streamInputRate != rate;
+    next->convertingOutput = streamOutputRate != rate;
+    if (next->convertingInput) next->input.prepare(streamInputRate, rate, 2, streamQuality);
+    if (next->convertingOutput) next->output.prepare(rate, streamOutputRate, 2, streamQuality);
+    
+    // Largest input pass whose converted frames fit one processing block
+    next->chunk = blockSize;
+    if (next->convertingInput) {
+        int chunk = (int)((blockSize - 2) * streamInputRate / rate);
+        next->chunk = std::max(1, std::min(blockSize, chunk));
+        while (next->chunk > 1 && next->input.getMaxOutputFrames(next->chunk) > blockSize) next->chunk--;
     }
+    next->buffer.assign((size_t)blockSize * 2, 0.0f);
     
-    // Process with EQ
-    equalizer->processStereo(leftBuffer.data(), rightBuffer.data(), numFrames);
+    // The slot being written is never the audio thread's, so the Stream
+    // it held (if any) can go here
+    stream = next.get();
+    streams.write() = std::move(next);
+    streams.publish();
+}
+
+int AudioProcessor::processStream(const float* input, int numFrames, float* output) {
+    if (!initialized) return 0;
+    DenormalGuard denormals;
+    RealtimeScope realtime;
+    
+    streams.pull();
+    Stream* s = streams.read().get();
+    if (!s) return 0;
     
-    // Re-interleave
-    for (int i = 0; i < numFrames; i++) {
-        buffer[i * 2] = leftBuffer[i];
-        buffer[i * 2 + 1] = rightBuffer[i];
+    int written = 0;
+    for (int frame = 0; frame < numFrames; frame += s->chunk) {
+        int count = std::min(s->chunk, numFrames - frame);
+        const float* source = input + (ptrdiff_t)frame * 2;
+        
+        // Processing-rate frames go straight to the output when nothing
+        // follows, else to the stream buffer
+        float* work = s->convertingOutput ? s->buffer.data() : output + (ptrdiff_t)written * 2;
+        int frames = count;
+        if (s->convertingInput) {
+            frames = s->input.process(source, count, work);
+        } else {
+            std::memcpy(work, source, (size_t)count * 2 * sizeof(float));
+        }
+        
+        processInterleavedStereo(work, frames * 2);
+        
+        if (s->convertingOutput) {
+            written += s->output.process(work, frames, output + (ptrdiff_t)written * 2);
+        } else {
+            written += frames;
+        }
     }
+    return written;
 }
 
-void AudioProcessor::processSeparateChannels(float* leftChannel, float* rightChannel, int numSamples) {
-    if (!initialized || !equalizer->isEnabled()) return;
-    equalizer->processStereo(leftChannel, rightChannel, numSamples);
+int AudioProcessor::getMaxStreamFrames(int numFrames) const {
+    if (!stream) return numFrames;
+    
+    // Each converter call may produce two frames beyond the rate ratio
+    long long passes = (numFrames + stream->chunk - 1) / stream->chunk;
+    double frames = numFrames;
+    if (stream->convertingInput) {
+        frames = std::ceil(frames * stream->rate / stream->input.getInputRate()) + 2 * passes;
+    }
+    if (stream->convertingOutput) {
+        frames = std::ceil(frames * stream->output.getOutputRate() / stream->rate) + 2 * passes;
+    }
+    return (int)frames;
+}
+
+double AudioProcessor::getStreamLatency() const {
+    double latency = getLatency();
+    if (!stream) return latency;
+    if (stream->convertingInput) latency += stream->input.getLatency();
+    if (stream->convertingOutput) {
+        latency = latency * stream->output.getOutputRate() / stream->rate + stream->output.getLatency();
+    }
+    return latency;
+}
+
+template <typename Process>
+void AudioProcessor::processTimeline(int numFrames, Process process) {
+    automation.collect();
+    long long position = framePosition.load(std::memory_order_relaxed);
+    int blockSize = maxBlockSize.load(std::memory_order_relaxed);
+    
+    int offset = 0;
+    while (offset < numFrames) {
+        AutomationEvent event;
+        bool deferred = false;
+        while (!deferred && automation.nextDue(position, event)) {
+            if (!applyAutomation(event)) {
+                automation.restore(event);
+                deferred = true;
+            }
+        }
+        
+        // Up to the next event; the equalizer picks the change up at the
+        // start of the following chunk. A deferred event is retried after
+        // one smoothing interval.
+        int limit = std::min(blockSize, numFrames - offset);
+        int frames = deferred ? std::min(limit, (int)Equalizer::SMOOTHING_INTERVAL)
+                              : automation.framesUntilNext(position, limit);
+        process(offset, frames);
+        offset += frames;
+        position += frames;
+    }
+    
+    framePosition.store(position, std::memory_order_relaxed);
+}
+
+bool AudioProcessor::applyAutomation(const AutomationEvent& event) {
+    bool applied = true;
+    switch (event.type) {
+        case AutomationEvent::BAND_GAIN:
+            applied = equalizer->trySetBandGain(event.band, event.value);
+            break;
+        case AutomationEvent::ENABLED:
+            applied = equalizer->trySetEnabled(event.value != 0.0);
+            break;
+        case AutomationEvent::PRESET:
+            applied = equalizer->tryApplyPreset((int)event.value);
+            break;
+    }
+    
+    // The curve changed; the control thread recomputes the pre-gain
+    if (applied) preGainStale.store(true, std::memory_order_relaxed);
+    return applied;
 }
 
 void AudioProcessor::setEQBandGain(int bandIndex, double gainDB) {
     equalizer->setBandGain(bandIndex, gainDB);
+    updatePreGain();
 }
 
 double AudioProcessor::getEQBandGain(int bandIndex) {
@@ -51,25 +297,292 @@ double AudioProcessor::getEQBandGain(int bandIndex) {
 
 void AudioProcessor::applyEQPreset(const std::string& presetName) {
     equalizer->applyPreset(presetName);
+    updatePreGain();
+}
+
+void AudioProcessor::applyEQPreset(int presetId) {
+    equalizer->applyPreset(presetId);
+    updatePreGain();
+}
+
+void AudioProcessor::morphEQToPreset(int presetId, double milliseconds) {
+    equalizer->morphToPreset(presetId, milliseconds);
+    updatePreGain();
+}
+
+void AudioProcessor::morphEQPresets(int fromPresetId, int toPresetId, double amount, double milliseconds) {
+    equalizer->morphPresets(fromPresetId, toPresetId, amount, milliseconds);
+    updatePreGain();
+}
+
+void AudioProcessor::morphEQToCurve(const double* gainsDB, int numGains, double milliseconds) {
+    equalizer->morphToCurve(gainsDB, numGains, milliseconds);
+    updatePreGain();
 }
 
 void AudioProcessor::resetEQ() {
     equalizer->reset();
+    updatePreGain();
 }
 
 void AudioProcessor::setEQEnabled(bool enabled) {
     equalizer->setEnabled(enabled);
+    updatePreGain();
 }
 
 bool AudioProcessor::isEQEnabled() {
     return equalizer->isEnabled();
 }
 
+void AudioProcessor::setEQSmoothingTime(double milliseconds) {
+    equalizer->setSmoothingTime(milliseconds);
+}
+
+int AudioProcessor::addEQBand(const BiquadFilter::Design& design) {
+    int result = equalizer->addBand(design);
+    updatePreGain();
+    return result;
+}
+
+bool AudioProcessor::removeEQBand(int bandIndex) {
+    bool result = equalizer->removeBand(bandIndex);
+    updatePreGain();
+    return result;
+}
+
+bool AudioProcessor::setEQBand(int bandIndex, const BiquadFilter::Design& design) {
+    bool result = equalizer->setBand(bandIndex, design);
+    updatePreGain();
+    return result;
+}
+
+bool AudioProcessor::getEQBand(int bandIndex, BiquadFilter::Design& design) {
+    return equalizer->getBand(bandIndex, design);
+}
+
 std::vector<double> AudioProcessor::getBandFrequencies() {
     std::vector<double> frequencies;
-    const double* freqs = Equalizer::getBandFrequencies();
-    for (int i = 0; i < Equalizer::NUM_BANDS; i++) {
+    const double* freqs = equalizer->getBandFrequencies();
+    for (int i = 0; i < equalizer->getNumBands(); i++) {
         frequencies.push_back(freqs[i]);
     }
     return frequencies;
 }
+
+bool AudioProcessor::scheduleAutomation(const AutomationEvent& event) {
+    refreshPreGain();
+    return automation.schedule(event);
+}
+
+int AudioProcessor::getAutomationSpace() const {
+    return automation.getSpace();
+}
+
+long long AudioProcessor::getFramePosition() const {
+    return framePosition.load(std::memory_order_relaxed);
+}
+
+bool AudioProcessor::setConvolutionLatency(int latency) {
+    return convolution.configure(latency, convolution.getMaxTaps());
+}
+
+bool AudioProcessor::loadImpulseResponse(const float* left, const float* right, int numTaps) {
+    if (numTaps < 1 || numTaps > ConvolutionEngine::MAX_TAPS) return false;
+    if (numTaps > convolution.getMaxTaps() &&
+        !convolution.configure(convolution.getLatency(), numTaps)) {
+        return false;
+    }
+    linearPhaseDelay = 0;
+    return convolution.setImpulseResponse(left, right, numTaps);
+}
+
+// |H(e^jw)| of one biquad
+static double magnitudeAt(const BiquadFilter::Coefficients& c, double omega) {
+    std::complex<double> z1 = std::polar(1.0, -omega);
+    std::complex<double> z2 = z1 * z1;
+    return std::abs(c.b0 + c.b1 * z1 + c.b2 * z2) / std::abs(1.0 + c.a1 * z1 + c.a2 * z2);
+}
+
+bool AudioProcessor::useLinearPhaseEQ(int numTaps) {
+    return loadLinearPhaseEQ(numTaps) && setStage(STAGE_CONVOLUTION);
+}
+
+bool AudioProcessor::loadLinearPhaseEQ(int numTaps) {
+    if (!FFT::isPowerOfTwo(numTaps) || numTaps < FFT::MIN_SIZE || numTaps > ConvolutionEngine::MAX_TAPS) {
+        return false;
+    }
+    
+    // Magnitude of the whole cascade at the target gains (flat when the
+    // EQ is disabled)
+    std::vector<double> magnitude(numTaps / 2 + 1, 1.0);
+    if (equalizer->isEnabled()) {
+        for (int band = 0; band < equalizer->getNumBands(); band++) {
+            BiquadFilter::Design design;
+            if (!equalizer->getBand(band, design)) continue;
+            BiquadFilter::Coefficients c = BiquadFilter::calculateCoefficients(design);
+            for (size_t k = 0; k < magnitude.size(); k++) {
+                magnitude[k] *= magnitudeAt(c, 2.0 * M_PI * k / numTaps);
+            }
+        }
+    }
+    
+    std::vector<float> impulse(numTaps);
+    ConvolutionEngine::designLinearPhase(magnitude.data(), numTaps, impulse.data());
+    if (!loadImpulseResponse(impulse.data(), nullptr, numTaps)) return false;
+    linearPhaseDelay = numTaps / 2;
+    return true;
+}
+
+bool AudioProcessor::setStage(Stage newStage) {
+    if (newStage != STAGE_EQ && !convolution.hasImpulseResponse()) return false;
+    Stage previous = (Stage)stage.exchange(newStage, std::memory_order_acq_rel);
+    
+    // Don't replay a stale tail when convolution comes back in
+    if (previous == STAGE_EQ && newStage != STAGE_EQ) convolution.clear();
+    return true;
+}
+
+AudioProcessor::Stage AudioProcessor::getStage() const {
+    return (Stage)stage.load(std::memory_order_relaxed);
+}
+
+int AudioProcessor::getLatency() const {
+    int latency = isLimiterEnabled() ? limiter.getLatency() : 0;
+    if (getStage() == STAGE_EQ) return latency;
+    return latency + convolution.getLatency() + linearPhaseDelay;
+}
+
+void AudioProcessor::setLimiterEnabled(bool enabled) {
+    if (enabled == isLimiterEnabled()) return;
+    
+    // Start from an empty delay line and a current pre-gain; the stages
+    // are unclamped once the limiter runs and clamped again before it stops
+    if (enabled) {
+        limiter.clear();
+        if (preGainStale.load(std::memory_order_relaxed)) computePreGain();
+        limiting.store(true, std::memory_order_release);
+        updateOutputClamps(isCompressorEnabled(), true);
+    } else {
+        updateOutputClamps(isCompressorEnabled(), false);
+        limiting.store(false, std::memory_order_release);
+    }
+}
+
+bool AudioProcessor::isLimiterEnabled() const {
+    return limiting.load(std::memory_order_relaxed);
+}
+
+void AudioProcessor::setLimiterCeiling(double dBTP) {
+    limiter.setCeiling(dBTP);
+}
+
+void AudioProcessor::setLimiterRelease(double milliseconds) {
+    limiter.setRelease(milliseconds);
+}
+
+void AudioProcessor::setCompressorEnabled(bool enabled) {
+    if (enabled == isCompressorEnabled()) return;
+    
+    // Same order as the limiter: the stage that clamps is always last
+    if (enabled) {
+        compressor.clear();
+        compressing.store(true, std::memory_order_release);
+        updateOutputClamps(true, isLimiterEnabled());
+    } else {
+        updateOutputClamps(false, isLimiterEnabled());
+        compressing.store(false, std::memory_order_release);
+    }
+}
+
+bool AudioProcessor::isCompressorEnabled() const {
+    return compressing.load(std::memory_order_relaxed);
+}
+
+bool AudioProcessor::setCompressorBands(int numBands, const double* crossovers) {
+    return compressor.setBands(numBands, crossovers);
+}
+
+bool AudioProcessor::setCompressorBand(int band, const MultibandCompressor::BandSettings& settings) {
+    return compressor.setBand(band, settings);
+}
+
+bool AudioProcessor::getCompressorBand(int band, MultibandCompressor::BandSettings& settings) const {
+    return compressor.getBand(band, settings);
+}
+
+int AudioProcessor::getCompressorBandCount() const {
+    return compressor.getNumBands();
+}
+
+double AudioProcessor::getCompressorGainReduction(int band) const {
+    return compressor.getGainReduction(band);
+}
+
+void AudioProcessor::updateOutputClamps(bool compressed, bool limited) {
+    equalizer->setOutputClamp(!limited && !compressed);
+    convolution.setOutputClamp(!limited && !compressed);
+    compressor.setOutputClamp(!limited);
+}
+
+void AudioProcessor::setAutoPreGain(bool enabled) {
+    autoPreGain = enabled;
+    updatePreGain();
+}
+
+double AudioProcessor::getPreGainDB() {
+    if (preGainStale.load(std::memory_order_relaxed)) computePreGain();
+    return 20.0 * std::log10(limiter.getInputGain());
+}
+
+void AudioProcessor::refreshPreGain() {
+    if (isLimiterEnabled() && preGainStale.load(std::memory_order_relaxed)) computePreGain();
+}
+
+double AudioProcessor::peakMagnitude() {
+    if (!equalizer->isEnabled()) return 1.0;
+    double rate = getSampleRate();
+    
+    // Bands at 0 dB are unity everywhere; a flat curve needs no grid
+    std::vector<BiquadFilter::Coefficients> sections;
+    std::vector<double> centres;
+    for (int band = 0; band < equalizer->getNumBands(); band++) {
+        BiquadFilter::Design design;
+        if (!equalizer->getBand(band, design)) continue;
+        if (design.frequency < 0.5 * rate) centres.push_back(2.0 * M_PI * design.frequency / rate);
+        if (BiquadFilter::hasGain(design.type) && design.gainDB == 0.0) continue;
+        sections.push_back(BiquadFilter::calculateCoefficients(design));
+    }
+    if (sections.empty()) return 1.0;
+    
+    // Log grid from 20 Hz to just below Nyquist, plus every band centre
+    // (where peaking bands have their maximum)
+    static const int GRID_POINTS = 256;
+    std::vector<double> omegas;
+    double top = std::min(20000.0, 0.49 * rate);
+    for (int i = 0; i < GRID_POINTS; i++) {
+        double frequency = 20.0 * std::pow(top / 20.0, (double)i / (GRID_POINTS - 1));
+        omegas.push_back(2.0 * M_PI * frequency / rate);
+    }
+    omegas.insert(omegas.end(), centres.begin(), centres.end());
+    
+    double peak = 1.0;
+    for (double omega : omegas) {
+        double magnitude = 1.0;
+        for (const BiquadFilter::Coefficients& c : sections) magnitude *= magnitudeAt(c, omega);
+        peak = std::max(peak, magnitude);
+    }
+    return peak;
+}
+
+// Only the limiter applies the pre-gain, so with it off a curve change
+// just marks it stale: EQ setters stay as cheap as the equalizer's own
+void AudioProcessor::updatePreGain() {
+    preGainStale.store(true, std::memory_order_relaxed);
+    refreshPreGain();
+}
+
+void AudioProcessor::computePreGain() {
+    // Cleared first, so a change landing meanwhile marks it again
+    preGainStale.store(false, std::memory_order_relaxed);
+    limiter.setInputGain(autoPreGain ? 1.0 / peakMagnitude() : 1.0);
+}
@@ -0,0 +1,62 @@
+#include "automation_timeline.h"
+#include <algorithm>
+
+AutomationTimeline::AutomationTimeline() : first(0), last(0) {}
+
+bool AutomationTimeline::schedule(const AutomationEvent& event) {
+    return queue.push(event);
+}
+
+int AutomationTimeline::getSpace() const {
+    return queue.space();
+}
+
+void AutomationTimeline::collect() {
+    // Move the pending range to the front when the tail runs out of room
+    if (last == CAPACITY && first > 0) {
+        std::copy(pending + first, pending + last, pending);
+        last -= first;
+        first = 0;
+    }
+
+    AutomationEvent event;
+    while (last < CAPACITY && queue.pop(event)) {
+        // Batches arrive sorted, so this rarely moves anything
+        int i = last;
+        while (i > first && pending[i - 1].frame > event.frame) {
+            pending[i] = pending[i - 1];
+            i--;
+        }
+        pending[i] = event;
+        last++;
+    }
+}
+
+bool AutomationTimeline::nextDue(long long position, AutomationEvent& event) {
+    if (first == last || pending[first].frame > position) return false;
+    event = pending[first++];
+    if (first == last) first = last = 0;
+    return true;
+}
+
+void AutomationTimeline::restore(const AutomationEvent& event) {
+    // nextDue left first past the event, or reset both ends when it was
+    // the last one
+    if (first > 0) {
+        pending[--first] = event;
+    } else {
+        pending[0] = event;
+        last = 1;
+    }
+}
+
+int AutomationTimeline::framesUntilNext(long long position, int limit) const {
+    if (first == last) return limit;
+    return (int)std::min<long long>(limit, pending[first].frame - position);
+}
+
+void AutomationTimeline::clear() {
+    AutomationEvent event;
+    while (queue.pop(event)) {}
+    first = last = 0;
+}
@@ -0,0 +1,546 @@
+#include "band_equalizer.h"
+#include <algorithm>
+#include <cmath>
+
+// True if no sample reaches the silence threshold. An OR of comparisons
+// rather than a running max, so the compiler vectorizes it.
+static bool isSilent(const float* samples, int count) {
+    const float threshold = static_cast<float>(Equalizer::SILENCE_THRESHOLD);
+    int loud = 0;
+    for (int i = 0; i < count; i++) {
+        loud |= std::fabs(samples[i]) >= threshold;
+    }
+    return !loud;
+}
+
+template <int MaxBands>
+BandEqualizer<MaxBands>::BandEqualizer(double sr)
+    : sampleRate(sr), numBands(0), cascade(0), audioEnabled(false), audioResetCount(0),
+      ramping(false), samplesToUpdate(0) {
+    for (int i = 0; i < MaxBands; i++) {
+        tables[i] = nullptr;
+        used[i] = false;
+        requestedFrequencies[i] = designs[i].frequency;
+        frequencies[i] = 0.0;
+
+        SlotParams& slot = staging.slots[i];
+        slot.coefficients[0] = 1.0;
+        slot.coefficients[1] = slot.coefficients[2] = 0.0;
+        slot.coefficients[3] = slot.coefficients[4] = 0.0;
+        slot.prototype = BiquadFilter::prepare(designs[i]);
+        slot.gainDB = 0.0;
+        slot.rampMs = -1.0;
+        slot.mode = SLOT_EMPTY;
+        for (int p = 0; p < NUM_PRESETS; p++) presetGains[p][i] = 0.0;
+
+        Ramp& ramp = ramps[i];
+        ramp.gainDB = ramp.targetDB = ramp.stepDB = 0.0;
+        ramp.amplitude = ramp.ratio = 1.0;
+        ramp.stepsLeft = 0;
+        positions[i] = -1;
+    }
+    staging.sampleRate = sampleRate;
+    staging.smoothingMs = DEFAULT_SMOOTHING_MS;
+    staging.enabled = true;
+    staging.clamp = true;
+    staging.resetCount = 0;
+}
+
+template <int MaxBands>
+BandEqualizer<MaxBands>::~BandEqualizer() {}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::processStereo(float* leftChannel, float* rightChannel, int numSamples) {
+    pullParameters();
+
+    // Disabled, flat, or silent input after the tail has died away: no work
+    // beyond keeping the filter history current. The input is only scanned
+    // once the history is quiet, so audible playback never pays for it.
+    if (!audioEnabled || cascade.getNumSections() == 0 ||
+        (cascade.isQuiet(SILENCE_THRESHOLD) && isSilent(leftChannel, numSamples) &&
+         isSilent(rightChannel, numSamples))) {
+        settleRamps();
+        cascade.bypassStereo(leftChannel, rightChannel, numSamples);
+        return;
+    }
+
+    // Both channels run through all active sections as one block, in parallel SIMD lanes
+    processSmoothed(numSamples, [&](int offset, int count) {
+        cascade.processStereo(leftChannel + offset, rightChannel + offset, count);
+    });
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::processInterleaved(float* buffer, int numChannels, int numFrames) {
+    pullParameters();
+    if (!audioEnabled || cascade.getNumSections() == 0 ||
+        (cascade.isQuiet(SILENCE_THRESHOLD) && isSilent(buffer, numFrames * numChannels))) {
+        settleRamps();
+        cascade.bypassInterleaved(buffer, numChannels, numFrames);
+        return;
+    }
+
+    processSmoothed(numFrames, [&](int offset, int count) {
+        cascade.processInterleaved(buffer + (size_t)offset * numChannels, numChannels, count);
+    });
+}
+
+template <int MaxBands>
+template <typename Process>
+void BandEqualizer<MaxBands>::processSmoothed(int numFrames, Process process) {
+    int offset = 0;
+    while (offset < numFrames) {
+        int count = numFrames - offset;
+        if (ramping) {
+            if (samplesToUpdate == 0) {
+                advanceRamps();
+                samplesToUpdate = SMOOTHING_INTERVAL;
+            }
+            count = std::min(count, samplesToUpdate);
+            samplesToUpdate -= count;
+        }
+        process(offset, count);
+        offset += count;
+    }
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::pullParameters() {
+    // Block boundary: adopt the newest complete snapshot, if any
+    if (!parameters.pull()) return;
+
+    const Snapshot& p = parameters.read();
+    bool reset = p.resetCount != audioResetCount;
+
+    // Nothing audible to ramp from while disabled or after a reset
+    bool jump = !audioEnabled || reset;
+
+    for (int i = 0; i < MaxBands; i++) {
+        const SlotParams& slot = p.slots[i];
+        Ramp& ramp = ramps[i];
+        double target = slot.mode == SLOT_GAIN ? slot.gainDB : 0.0;
+        double rampMs = slot.rampMs >= 0.0 ? slot.rampMs : p.smoothingMs;
+
+        if (jump || rampMs <= 0.0 || slot.mode != SLOT_GAIN) {
+            ramp.gainDB = ramp.targetDB = target;
+            ramp.stepsLeft = 0;
+        } else if (target != ramp.targetDB) {
+            // Continue from wherever the band is now, mid-ramp or settled
+            int steps = (int)std::lround(rampMs * 0.001 * p.sampleRate / SMOOTHING_INTERVAL);
+            steps = std::max(1, steps);
+            ramp.targetDB = target;
+            ramp.stepDB = (target - ramp.gainDB) / steps;
+            ramp.amplitude = BiquadFilter::amplitude(ramp.gainDB);
+            ramp.ratio = BiquadFilter::amplitude(ramp.stepDB);
+            ramp.stepsLeft = steps;
+        }
+    }
+
+    updatePlan();
+    for (int i = 0; i < MaxBands; i++) {
+        if (positions[i] >= 0) loadSection(i);
+    }
+    if (reset) {
+        cascade.reset();
+        audioResetCount = p.resetCount;
+    }
+
+    ramping = false;
+    for (int i = 0; i < MaxBands; i++) {
+        if (ramps[i].stepsLeft > 0) ramping = true;
+    }
+    samplesToUpdate = 0;
+    audioEnabled = p.enabled;
+    cascade.setClampEnabled(p.clamp);
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::updatePlan() {
+    const Snapshot& p = parameters.read();
+    int position = 0;
+
+    for (int i = 0; i < MaxBands; i++) {
+        const Ramp& ramp = ramps[i];
+        int mode = p.slots[i].mode;
+        bool needed = mode == SLOT_FIXED ||
+                      (mode == SLOT_GAIN && (ramp.gainDB != 0.0 || ramp.targetDB != 0.0));
+
+        if (needed && positions[i] < 0) {
+            // Starts as identity; loadSection or the ramp sets the real design
+            cascade.insertSection(position);
+        } else if (!needed && positions[i] >= 0) {
+            cascade.removeSection(position);
+            positions[i] = -1;
+        }
+        if (needed) positions[i] = position++;
+    }
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::loadSection(int slot) {
+    const SlotParams& s = parameters.read().slots[slot];
+    const Ramp& ramp = ramps[slot];
+
+    if (ramp.stepsLeft == 0) {
+        // Settled: exactly the published design
+        const double* c = s.coefficients;
+        cascade.setSection(positions[slot], c[0], c[1], c[2], c[3], c[4]);
+    } else {
+        BiquadFilter::Coefficients c = BiquadFilter::calculateCoefficients(s.prototype, ramp.amplitude);
+        cascade.setSection(positions[slot], c.b0, c.b1, c.b2, c.a1, c.a2);
+    }
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::advanceRamps() {
+    bool active = false;
+    bool pruned = false;
+
+    for (int i = 0; i < MaxBands; i++) {
+        Ramp& ramp = ramps[i];
+        if (ramp.stepsLeft == 0) continue;
+
+        if (--ramp.stepsLeft == 0) {
+            // Land exactly on the published design; a band back at 0 dB leaves the plan
+            ramp.gainDB = ramp.targetDB;
+            loadSection(i);
+            pruned = pruned || ramp.gainDB == 0.0;
+            continue;
+        }
+
+        ramp.gainDB += ramp.stepDB;
+        ramp.amplitude *= ramp.ratio;
+        loadSection(i);
+        active = true;
+    }
+
+    if (pruned) updatePlan();
+    ramping = active;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::settleRamps() {
+    if (!ramping) return;
+
+    // Nothing audible to ramp: land every band on its target now
+    for (int i = 0; i < MaxBands; i++) {
+        Ramp& ramp = ramps[i];
+        if (ramp.stepsLeft == 0) continue;
+        ramp.gainDB = ramp.targetDB;
+        ramp.stepsLeft = 0;
+    }
+    updatePlan();
+    for (int i = 0; i < MaxBands; i++) {
+        if (positions[i] >= 0) loadSection(i);
+    }
+    ramping = false;
+    samplesToUpdate = 0;
+}
+
+template <int MaxBands>
+int BandEqualizer<MaxBands>::getActiveSectionCount() const {
+    return cascade.getNumSections();
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::publish() {
+    parameters.write() = staging;
+    parameters.publish();
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::assignBand(int slot, const BiquadFilter::Design& design) {
+    BiquadFilter::Design& d = designs[slot];
+    d = design;
+    requestedFrequencies[slot] = design.frequency;
+
+    // Keep every design stable and below Nyquist
+    d.sampleRate = sampleRate;
+    d.frequency = std::max(1.0, std::min(sampleRate * 0.499, d.frequency));
+    d.Q = std::max(0.05, std::min(50.0, d.Q));
+    d.gainDB = BiquadFilter::hasGain(d.type) ? std::max(-12.0, std::min(12.0, d.gainDB)) : 0.0;
+
+    // Gain-less designs have one coefficient set; no table needed
+    tables[slot] = BiquadFilter::hasGain(d.type) ? CoefficientTable::find(d) : nullptr;
+    used[slot] = true;
+
+    SlotParams& s = staging.slots[slot];
+    s.prototype = tables[slot] ? tables[slot]->getPrototype() : BiquadFilter::prepare(d);
+    s.gainDB = d.gainDB;
+    s.rampMs = -1.0;
+    s.mode = BiquadFilter::hasGain(d.type) ? SLOT_GAIN : SLOT_FIXED;
+    updateCoefficients(slot);
+    updateFrequencies();
+
+    for (int p = 0; p < NUM_PRESETS; p++) {
+        presetGains[p][slot] = getPresetGain(p, d.frequency);
+    }
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::releaseBand(int slot) {
+    used[slot] = false;
+
+    // Shelves and peaks fade out to 0 dB and are pruned there
+    SlotParams& s = staging.slots[slot];
+    if (s.mode == SLOT_GAIN) {
+        designs[slot].gainDB = 0.0;
+        s.gainDB = 0.0;
+        s.rampMs = -1.0;
+        updateCoefficients(slot);
+    } else {
+        s.mode = SLOT_EMPTY;
+    }
+    updateFrequencies();
+}
+
+template <int MaxBands>
+bool BandEqualizer<MaxBands>::setSlotGain(int slot, double gainDB, double rampMs) {
+    if (staging.slots[slot].mode != SLOT_GAIN) return false;
+
+    // Clamp gain between -12 and +12 dB
+    gainDB = std::max(-12.0, std::min(12.0, gainDB));
+    if (staging.slots[slot].gainDB == gainDB) return false;
+
+    designs[slot].gainDB = gainDB;
+    staging.slots[slot].gainDB = gainDB;
+    staging.slots[slot].rampMs = rampMs;
+    updateCoefficients(slot);
+    return true;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::updateCoefficients(int slot) {
+    // Table lookup for grid gains (every preset and 0.5 dB slider step)
+    const BiquadFilter::Design& design = designs[slot];
+    const CoefficientTable* table = tables[slot];
+    BiquadFilter::Coefficients c = table ? table->lookup(design.gainDB)
+                                         : BiquadFilter::calculateCoefficients(design);
+    double* coeffs = staging.slots[slot].coefficients;
+    coeffs[0] = c.b0;
+    coeffs[1] = c.b1;
+    coeffs[2] = c.b2;
+    coeffs[3] = c.a1;
+    coeffs[4] = c.a2;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::updateFrequencies() {
+    numBands = 0;
+    for (int i = 0; i < MaxBands; i++) {
+        if (used[i]) frequencies[numBands++] = designs[i].frequency;
+    }
+}
+
+template <int MaxBands>
+int BandEqualizer<MaxBands>::slotOf(int bandIndex) const {
+    if (bandIndex < 0) return -1;
+    for (int i = 0; i < MaxBands; i++) {
+        if (used[i] && bandIndex-- == 0) return i;
+    }
+    return -1;
+}
+
+template <int MaxBands>
+bool BandEqualizer<MaxBands>::isSlotUsed(int slot) const {
+    return used[slot];
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::setBandGain(int bandIndex, double gainDB) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    changeBandGain(bandIndex, gainDB);
+}
+
+template <int MaxBands>
+bool BandEqualizer<MaxBands>::trySetBandGain(int bandIndex, double gainDB) {
+    std::unique_lock<std::mutex> lock(controlMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    changeBandGain(bandIndex, gainDB);
+    return true;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::changeBandGain(int bandIndex, double gainDB) {
+    int slot = slotOf(bandIndex);
+    if (slot < 0) return;
+    if (setSlotGain(slot, gainDB)) publish();
+}
+
+template <int MaxBands>
+double BandEqualizer<MaxBands>::getBandGain(int bandIndex) const {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    int slot = slotOf(bandIndex);
+    if (slot < 0) return 0.0;
+    return designs[slot].gainDB;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::applyPreset(int presetId) {
+    morphPresets(presetId, presetId, 0.0, -1.0);
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::morphToPreset(int presetId, double milliseconds) {
+    morphPresets(presetId, presetId, 0.0, std::max(0.0, milliseconds));
+}
+
+template <int MaxBands>
+bool BandEqualizer<MaxBands>::tryApplyPreset(int presetId) {
+    std::unique_lock<std::mutex> lock(controlMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    changePresets(presetId, presetId, 0.0, -1.0);
+    return true;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::morphPresets(int fromPresetId, int toPresetId, double amount,
+                                           double milliseconds) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    changePresets(fromPresetId, toPresetId, amount, milliseconds);
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::changePresets(int fromPresetId, int toPresetId, double amount,
+                                            double milliseconds) {
+    if (fromPresetId < 0 || fromPresetId >= NUM_PRESETS ||
+        toPresetId < 0 || toPresetId >= NUM_PRESETS) return;
+    amount = std::max(0.0, std::min(1.0, amount));
+    
+    // All bands change in one snapshot; blends snap to the 0.1 dB table grid
+    const double* from = presetGains[fromPresetId];
+    const double* to = presetGains[toPresetId];
+    const double steps = CoefficientTable::STEPS_PER_DB;
+    bool changed = false;
+    for (int i = 0; i < MaxBands; i++) {
+        if (!used[i]) continue;
+        double gainDB = std::round((from[i] + (to[i] - from[i]) * amount) * steps) / steps;
+        changed = setSlotGain(i, gainDB, milliseconds) || changed;
+    }
+    if (changed) publish();
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::morphToCurve(const double* gainsDB, int numGains, double milliseconds) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    bool changed = false;
+    for (int band = 0; band < numGains; band++) {
+        int slot = slotOf(band);
+        if (slot < 0) break;
+        changed = setSlotGain(slot, gainsDB[band], std::max(0.0, milliseconds)) || changed;
+    }
+    if (changed) publish();
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::reset() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    for (int i = 0; i < MaxBands; i++) {
+        if (used[i]) setSlotGain(i, 0.0);
+    }
+    staging.resetCount++;
+    publish();
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::setEnabled(bool en) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    changeEnabled(en);
+}
+
+template <int MaxBands>
+bool BandEqualizer<MaxBands>::trySetEnabled(bool en) {
+    std::unique_lock<std::mutex> lock(controlMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    changeEnabled(en);
+    return true;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::changeEnabled(bool en) {
+    staging.enabled = en;
+    if (!en) {
+        // Reset filter state when disabling
+        staging.resetCount++;
+    }
+    publish();
+}
+
+template <int MaxBands>
+bool BandEqualizer<MaxBands>::isEnabled() const {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    return staging.enabled;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::setOutputClamp(bool enabled) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    staging.clamp = enabled;
+    publish();
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::setSampleRate(double sr) {
+    if (!(sr > 0.0)) return;
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (sr == sampleRate) return;
+
+    // Same bands at the new rate: redesign each from what was asked for
+    // (preset gains are recomputed per band but come out the same)
+    sampleRate = sr;
+    for (int i = 0; i < MaxBands; i++) {
+        if (!used[i]) continue;
+        BiquadFilter::Design design = designs[i];
+        design.frequency = requestedFrequencies[i];
+        assignBand(i, design);
+    }
+    staging.sampleRate = sr;
+    staging.resetCount++;
+    publish();
+}
+
+template <int MaxBands>
+double BandEqualizer<MaxBands>::getSampleRate() const {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    return sampleRate;
+}
+
+template <int MaxBands>
+void BandEqualizer<MaxBands>::setSmoothingTime(double milliseconds) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    staging.smoothingMs = std::max(0.0, milliseconds);
+    publish();
+}
+
+template <int MaxBands>
+double BandEqualizer<MaxBands>::getSmoothingTime() const {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    return staging.smoothingMs;
+}
+
+template <int MaxBands>
+int BandEqualizer<MaxBands>::getNumBands() const {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    return numBands;
+}
+
+template <int MaxBands>
+const double* BandEqualizer<MaxBands>::getBandFrequencies() const {
+    // Only the blocking setters change the layout; the audio thread's
+    // try-setters touch gains and the enabled flag, never frequencies
+    return frequencies;
+}
+
+template <int MaxBands>
+bool BandEqualizer<MaxBands>::getBand(int bandIndex, BiquadFilter::Design& design) const {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    int slot = slotOf(bandIndex);
+    if (slot < 0) return false;
+    design = designs[slot];
+    return true;
+}
+
+template class BandEqualizer<5>;
+template class BandEqualizer<10>;
+template class BandEqualizer<31>;
+template class BandEqualizer<32>;
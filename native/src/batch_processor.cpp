@@ -0,0 +1,141 @@
+#include "batch_processor.h"
+#include "audio_processor.h"
+#include "denormals.h"
+#include <algorithm>
+#include <numeric>
+
+BatchProcessor::BatchProcessor(int numThreads) : generation(0), stopping(false) {
+    if (numThreads <= 0) numThreads = (int)std::thread::hardware_concurrency();
+    numThreads = std::max(1, numThreads);
+
+    for (int i = 0; i < numThreads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->equalizerBands = -1;
+    }
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(&BatchProcessor::threadMain, this, i);
+    }
+}
+
+BatchProcessor::~BatchProcessor() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) thread.join();
+}
+
+int BatchProcessor::getNumThreads() const {
+    return (int)workers.size();
+}
+
+void BatchProcessor::process(std::vector<Job>& jobs, double rate, int bands, int maxThreads) {
+    if (jobs.empty()) return;
+
+    int count = (int)workers.size();
+    if (maxThreads > 0) count = std::min(count, maxThreads);
+    count = std::min(count, (int)jobs.size());
+
+    Batch batch;
+    batch.jobs = &jobs;
+    batch.sampleRate = rate;
+    batch.numBands = bands;
+    batch.participants = count;
+    batch.remaining = (int)jobs.size();
+
+    // Longest first, dealt round robin: every deque gets a fair share and
+    // ends with the short jobs thieves take
+    std::vector<int> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return jobs[a].numFrames > jobs[b].numFrames;
+    });
+    for (int w = 0; w < count; w++) {
+        Worker& worker = *workers[w];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        for (size_t i = w; i < order.size(); i += count) {
+            worker.queue.push_back({ &batch, order[i] });
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    generation++;
+    wake.notify_all();
+    batch.finished.wait(lock, [&] { return batch.remaining == 0; });
+}
+
+void BatchProcessor::threadMain(int index) {
+    Worker& worker = *workers[index];
+    DenormalGuard denormals;
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        // A batch queued from here on bumps generation again, so nothing
+        // is missed between the last take and the next wait
+        Task task;
+        while (take(index, task)) {
+            run(worker, task);
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--task.batch->remaining == 0) task.batch->finished.notify_all();
+        }
+    }
+}
+
+// Own deque from the front, then the others' from the back, skipping jobs
+// of batches limited to fewer threads
+bool BatchProcessor::take(int index, Task& task) {
+    int count = (int)workers.size();
+    for (int i = 0; i < count; i++) {
+        Worker& victim = *workers[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.queue.empty()) continue;
+        if (i == 0) {
+            task = victim.queue.front();
+            victim.queue.pop_front();
+            return true;
+        }
+        auto found = std::find_if(victim.queue.rbegin(), victim.queue.rend(), [&](const Task& queued) {
+            return index < queued.batch->participants;
+        });
+        if (found == victim.queue.rend()) continue;
+        task = *found;
+        victim.queue.erase(std::next(found).base());
+        return true;
+    }
+    return false;
+}
+
+void BatchProcessor::run(Worker& worker, const Task& task) {
+    const Batch& batch = *task.batch;
+    if (!worker.equalizer || worker.equalizerBands != batch.numBands) {
+        worker.equalizer = Equalizer::create(batch.numBands, batch.sampleRate);
+        worker.equalizerBands = batch.numBands;
+    } else {
+        worker.equalizer->setSampleRate(batch.sampleRate);
+    }
+
+    // reset() clears the filter history, and the settings after it land
+    // with it, without a ramp
+    Job& job = (*batch.jobs)[task.job];
+    Equalizer* equalizer = worker.equalizer.get();
+    equalizer->reset();
+    if (job.presetId >= 0) {
+        equalizer->applyPreset(job.presetId);
+    } else {
+        equalizer->morphToCurve(job.gains.data(), (int)job.gains.size(), 0.0);
+    }
+
+    // In processBuffer's blocks, so silence is detected (and the result
+    // comes out) the same way
+    for (int offset = 0; offset < job.numFrames; offset += AudioProcessor::DEFAULT_MAX_BLOCK_SIZE) {
+        int frames = std::min((int)AudioProcessor::DEFAULT_MAX_BLOCK_SIZE, job.numFrames - offset);
+        equalizer->processInterleaved(job.buffer + (size_t)offset * 2, 2, frames);
+    }
+}
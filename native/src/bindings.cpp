@@ -1,33 +1,810 @@
 #include <napi.h>
 #include "audio_processor.h"
+#include "batch_processor.h"
+#include "dsp_kernels.h"
+#include "processor_pool.h"
 #include "system_audio_hook.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
-// Global audio processor instance
-static std::unique_ptr<AudioProcessor> processor;
+class ProcessBufferWorker;
 
-// Global system audio hook instance
-static std::unique_ptr<SystemAudioHook> systemHook;
+// Per-environment state, set as instance data in Init: the main thread and
+// every worker_thread that loads the module get their own, so workers never
+// share a processor
+struct AddonData {
+    // Audio processor behind the module-level functions; Processor objects
+    // each hold their own
+    std::unique_ptr<AudioProcessor> processor;
+    
+    // System audio hook
+    std::unique_ptr<SystemAudioHook> systemHook;
+    
+    // Released state for this environment's Processor objects
+    ProcessorPool pool;
+    
+    // processBufferAsync jobs in flight, at most one per processor
+    std::map<AudioProcessor*, ProcessBufferWorker*> pending;
+    
+    // Thread pool behind processBatch, started on first use; running
+    // BatchWorkers share it, so teardown never frees it under a batch
+    std::shared_ptr<BatchProcessor> batch;
+};
+
+static AddonData& addonData(Napi::Env env) {
+    return *env.GetInstanceData<AddonData>();
+}
+
+// Throws and returns true while a processBufferAsync job is using the
+// processor: processing or replacing it then would race with the job
+static bool throwIfBusy(Napi::Env env, AudioProcessor* processor) {
+    if (!processor || addonData(env).pending.count(processor) == 0) return false;
+    Napi::Error::New(env, "Processor busy: processBufferAsync is pending").ThrowAsJavaScriptException();
+    return true;
+}
+
+// Filter type names accepted by the band editing functions
+static const char* const FILTER_TYPE_NAMES[] = {
+    "lowshelf", "highshelf", "peaking", "lowpass", "highpass", "notch", "allpass"
+};
+static const int NUM_FILTER_TYPES = 7;
+
+// Processing stage names, in AudioProcessor::Stage order
+static const char* const STAGE_NAMES[] = {
+    "eq", "convolution", "eq+convolution"
+};
+static const int NUM_STAGES = 3;
+
+// Read { type, frequency, gain, q } into a design; missing fields keep
+// their current values. Throws and returns false on a bad type name.
+static bool readDesign(Napi::Env env, Napi::Object object, BiquadFilter::Design& design) {
+    if (object.Has("type")) {
+        std::string name = object.Get("type").ToString().Utf8Value();
+        int type = -1;
+        for (int i = 0; i < NUM_FILTER_TYPES; i++) {
+            if (name == FILTER_TYPE_NAMES[i]) type = i;
+        }
+        if (type < 0) {
+            Napi::TypeError::New(env, "Unknown filter type: " + name).ThrowAsJavaScriptException();
+            return false;
+        }
+        design.type = (BiquadFilter::FilterType)type;
+    }
+    if (object.Has("frequency")) design.frequency = object.Get("frequency").ToNumber().DoubleValue();
+    if (object.Has("gain")) design.gainDB = object.Get("gain").ToNumber().DoubleValue();
+    if (object.Has("q")) design.Q = object.Get("q").ToNumber().DoubleValue();
+    return true;
+}
+
+static Napi::Object writeDesign(Napi::Env env, const BiquadFilter::Design& design) {
+    Napi::Object object = Napi::Object::New(env);
+    object.Set("type", FILTER_TYPE_NAMES[design.type]);
+    object.Set("frequency", design.frequency);
+    object.Set("gain", design.gainDB);
+    object.Set("q", design.Q);
+    return object;
+}
+
+// Audio buffers must be Float32Arrays: As<Float32Array>() does not check,
+// and any other typed array would be read and written past its end
+static bool isFloat32Array(Napi::Value value) {
+    return value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == napi_float32_array;
+}
+
+// Binding bodies take the processor they act on: the module-level
+// functions pass the global one, Processor methods their own
+typedef Napi::Value (*ProcessorFunction)(const Napi::CallbackInfo& info, AudioProcessor* processor);
+
+template <ProcessorFunction F>
+Napi::Value WithGlobalProcessor(const Napi::CallbackInfo& info) {
+    return F(info, addonData(info.Env()).processor.get());
+}
+
+// Read an EQ layout: 5, 10 or 31 graphic bands, or 'parametric'. Throws
+// and returns false on anything else.
+static bool readLayout(Napi::Env env, Napi::Value value, int& numBands) {
+    if (value.IsString() && value.As<Napi::String>().Utf8Value() == "parametric") {
+        numBands = Equalizer::PARAMETRIC;
+        return true;
+    }
+    if (value.IsNumber()) {
+        numBands = value.As<Napi::Number>().Int32Value();
+        if (numBands != Equalizer::PARAMETRIC && Equalizer::isSupportedBandCount(numBands)) return true;
+    }
+    Napi::RangeError::New(env, "Layout must be 5, 10, 31 or 'parametric'").ThrowAsJavaScriptException();
+    return false;
+}
+
+// Read initialize's (sampleRate, maxBlockSize?, layout?). Throws and
+// returns false on bad arguments.
+static bool readConfig(const Napi::CallbackInfo& info, int first, double& sampleRate, int& maxBlockSize,
+                       int& numBands) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < (size_t)first + 1 || !info[first].IsNumber()) {
+        Napi::TypeError::New(env, "Sample rate (number) expected").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    sampleRate = info[first].As<Napi::Number>().DoubleValue();
+    
+    // Optional largest block (frames) processBuffer will be given
+    maxBlockSize = AudioProcessor::DEFAULT_MAX_BLOCK_SIZE;
+    if (info.Length() >= (size_t)first + 2 && info[first + 1].IsNumber()) {
+        maxBlockSize = info[first + 1].As<Napi::Number>().Int32Value();
+    }
+    
+    // Optional EQ layout
+    numBands = Equalizer::DEFAULT_BANDS;
+    if (info.Length() >= (size_t)first + 3 && (info[first + 2].IsString() || info[first + 2].IsNumber())) {
+        return readLayout(env, info[first + 2], numBands);
+    }
+    return true;
+}
+
+// Initialize the audio processor
+Napi::Value Initialize(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    double sampleRate;
+    int maxBlockSize, numBands;
+    if (!readConfig(info, 0, sampleRate, maxBlockSize, numBands)) {
+        return env.Null();
+    }
+    
+    std::unique_ptr<AudioProcessor>& processor = addonData(env).processor;
+    if (throwIfBusy(env, processor.get())) {
+        return env.Null();
+    }
+    
+    processor = std::make_unique<AudioProcessor>();
+    processor->initialize(sampleRate, maxBlockSize, numBands);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Move to another sample rate (and optionally block size) keeping every
+// setting; unlike initialize, bands, gains and presets carry over
+Napi::Value Reconfigure(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber() || (info.Length() > 1 && !info[1].IsNumber())) {
+        Napi::TypeError::New(env, "Sample rate and optional max block size expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    double sampleRate = info[0].As<Napi::Number>().DoubleValue();
+    int maxBlockSize = info.Length() > 1 ? info[1].As<Napi::Number>().Int32Value() : 0;
+    if (!(sampleRate > 0.0) || maxBlockSize < 0) {
+        Napi::RangeError::New(env, "Sample rate must be positive and block size non-negative").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Boolean::New(env, processor->reconfigure(sampleRate, maxBlockSize));
+}
+
+// Set EQ band gain
+Napi::Value SetBandGain(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Band index and gain expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int bandIndex = info[0].As<Napi::Number>().Int32Value();
+    double gain = info[1].As<Napi::Number>().DoubleValue();
+    
+    processor->setEQBandGain(bandIndex, gain);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Get EQ band gain
+Napi::Value GetBandGain(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Band index expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int bandIndex = info[0].As<Napi::Number>().Int32Value();
+    double gain = processor->getEQBandGain(bandIndex);
+    
+    return Napi::Number::New(env, gain);
+}
+
+// Apply preset
+Napi::Value ApplyPreset(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !(info[0].IsString() || info[0].IsNumber())) {
+        Napi::TypeError::New(env, "Preset name or ID expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info[0].IsNumber()) {
+        processor->applyEQPreset(info[0].As<Napi::Number>().Int32Value());
+    } else {
+        std::string presetName = info[0].As<Napi::String>().Utf8Value();
+        processor->applyEQPreset(presetName);
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Resolve a preset name to its ID once; -1 if unknown
+Napi::Value GetPresetId(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Preset name (string) expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string presetName = info[0].As<Napi::String>().Utf8Value();
+    return Napi::Number::New(env, Equalizer::findPreset(presetName));
+}
+
+// Morph to a preset over the given milliseconds
+Napi::Value MorphToPreset(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Preset ID and time (ms) expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int presetId = info[0].As<Napi::Number>().Int32Value();
+    double milliseconds = info[1].As<Napi::Number>().DoubleValue();
+    processor->morphEQToPreset(presetId, milliseconds);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Crossfade between two presets: amount 0 = from, 1 = to
+Napi::Value MorphPresets(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsNumber()) {
+        Napi::TypeError::New(env, "Two preset IDs and an amount expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int fromPresetId = info[0].As<Napi::Number>().Int32Value();
+    int toPresetId = info[1].As<Napi::Number>().Int32Value();
+    double amount = info[2].As<Napi::Number>().DoubleValue();
+    double milliseconds = -1.0;  // Smoothing time
+    if (info.Length() >= 4 && info[3].IsNumber()) {
+        milliseconds = info[3].As<Napi::Number>().DoubleValue();
+    }
+    processor->morphEQPresets(fromPresetId, toPresetId, amount, milliseconds);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Morph to a user curve (one gain per band) over the given milliseconds
+Napi::Value MorphToCurve(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Gain array and time (ms) expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Array list = info[0].As<Napi::Array>();
+    std::vector<double> gains(list.Length());
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        gains[i] = list.Get(i).ToNumber().DoubleValue();
+    }
+    double milliseconds = info[1].As<Napi::Number>().DoubleValue();
+    processor->morphEQToCurve(gains.data(), (int)gains.size(), milliseconds);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Reset EQ
+Napi::Value ResetEQ(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    processor->resetEQ();
+    return Napi::Boolean::New(env, true);
+}
+
+// Enable/Disable EQ
+Napi::Value SetEnabled(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsBoolean()) {
+        Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    bool enabled = info[0].As<Napi::Boolean>().Value();
+    processor->setEQEnabled(enabled);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Check if EQ is enabled
+Napi::Value IsEnabled(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        return Napi::Boolean::New(env, false);
+    }
+    
+    return Napi::Boolean::New(env, processor->isEQEnabled());
+}
+
+// Set gain ramp time in milliseconds (0 = jump)
+Napi::Value SetSmoothingTime(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Smoothing time (number) expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    double milliseconds = info[0].As<Napi::Number>().DoubleValue();
+    processor->setEQSmoothingTime(milliseconds);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Get band frequencies
+Napi::Value GetBandFrequencies(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::vector<double> frequencies = processor->getBandFrequencies();
+    Napi::Array result = Napi::Array::New(env, frequencies.size());
+    
+    for (size_t i = 0; i < frequencies.size(); i++) {
+        result[i] = Napi::Number::New(env, frequencies[i]);
+    }
+    
+    return result;
+}
+
+// Add a parametric band; returns its index, -1 if the EQ is graphic or full
+Napi::Value AddBand(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Band object expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    BiquadFilter::Design design;
+    if (!readDesign(env, info[0].As<Napi::Object>(), design)) {
+        return env.Null();
+    }
+    
+    return Napi::Number::New(env, processor->addEQBand(design));
+}
+
+// Remove a parametric band; later bands move down one index
+Napi::Value RemoveBand(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Band index expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int bandIndex = info[0].As<Napi::Number>().Int32Value();
+    return Napi::Boolean::New(env, processor->removeEQBand(bandIndex));
+}
+
+// Change a parametric band's type, frequency, gain or Q
+Napi::Value SetBand(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "Band index and band object expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int bandIndex = info[0].As<Napi::Number>().Int32Value();
+    BiquadFilter::Design design;
+    if (!processor->getEQBand(bandIndex, design)) {
+        return Napi::Boolean::New(env, false);
+    }
+    if (!readDesign(env, info[1].As<Napi::Object>(), design)) {
+        return env.Null();
+    }
+    
+    return Napi::Boolean::New(env, processor->setEQBand(bandIndex, design));
+}
+
+// Get every band as { type, frequency, gain, q }
+Napi::Value GetBands(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::vector<double> frequencies = processor->getBandFrequencies();
+    Napi::Array result = Napi::Array::New(env, frequencies.size());
+    
+    for (size_t i = 0; i < frequencies.size(); i++) {
+        BiquadFilter::Design design;
+        processor->getEQBand((int)i, design);
+        result[i] = writeDesign(env, design);
+    }
+    
+    return result;
+}
+
+// Schedule a batch of automation events:
+// [{ frame, type: 'gain', band, gain } | { frame, type: 'enabled', enabled }
+//  | { frame, type: 'preset', preset }]
+// Frames count from initialize (see getFramePosition). All or nothing.
+Napi::Value ScheduleAutomation(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Array of automation events expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Array list = info[0].As<Napi::Array>();
+    std::vector<AutomationEvent> events(list.Length());
+    
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        Napi::Value item = list[i];
+        if (!item.IsObject()) {
+            Napi::TypeError::New(env, "Automation event object expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object object = item.As<Napi::Object>();
+        AutomationEvent& event = events[i];
+        event.frame = (long long)object.Get("frame").ToNumber().Int64Value();
+        event.band = 0;
+        event.value = 0.0;
+        
+        std::string type = object.Get("type").ToString().Utf8Value();
+        if (type == "gain") {
+            event.type = AutomationEvent::BAND_GAIN;
+            event.band = object.Get("band").ToNumber().Int32Value();
+            event.value = object.Get("gain").ToNumber().DoubleValue();
+        } else if (type == "enabled") {
+            event.type = AutomationEvent::ENABLED;
+            event.value = object.Get("enabled").ToBoolean().Value() ? 1.0 : 0.0;
+        } else if (type == "preset") {
+            std::string name = object.Get("preset").ToString().Utf8Value();
+            int presetId = Equalizer::findPreset(name);
+            if (presetId < 0) {
+                Napi::TypeError::New(env, "Unknown preset: " + name).ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            event.type = AutomationEvent::PRESET;
+            event.value = presetId;
+        } else {
+            Napi::TypeError::New(env, "Unknown automation event type: " + type).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    
+    if ((int)events.size() > processor->getAutomationSpace()) {
+        Napi::RangeError::New(env, "Automation queue full").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Sorted batches insert on the audio side without moving anything
+    std::stable_sort(events.begin(), events.end(),
+                     [](const AutomationEvent& a, const AutomationEvent& b) { return a.frame < b.frame; });
+    for (const AutomationEvent& event : events) {
+        processor->scheduleAutomation(event);
+    }
+    
+    return Napi::Number::New(env, (double)events.size());
+}
+
+// Frames processed since initialize (the automation timeline)
+Napi::Value GetFramePosition(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        return Napi::Number::New(env, 0.0);
+    }
+    
+    return Napi::Number::New(env, (double)processor->getFramePosition());
+}
+
+// Load a convolution IR: left Float32Array, optional right
+Napi::Value LoadImpulseResponse(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !isFloat32Array(info[0]) ||
+        (info.Length() >= 2 && !info[1].IsUndefined() && !isFloat32Array(info[1]))) {
+        Napi::TypeError::New(env, "Float32Array impulse response expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Float32Array left = info[0].As<Napi::Float32Array>();
+    int numTaps = (int)left.ElementLength();
+    const float* right = nullptr;
+    if (info.Length() >= 2 && isFloat32Array(info[1])) {
+        Napi::Float32Array rightArray = info[1].As<Napi::Float32Array>();
+        if ((int)rightArray.ElementLength() != numTaps) {
+            Napi::RangeError::New(env, "Left and right impulse responses must have the same length").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        right = rightArray.Data();
+    }
+    
+    if (numTaps < 1 || numTaps > ConvolutionEngine::MAX_TAPS) {
+        Napi::RangeError::New(env, "Impulse response must have 1 to 65536 taps").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    bool success = processor->loadImpulseResponse(left.Data(), right, numTaps);
+    return Napi::Boolean::New(env, success);
+}
+
+// Convolution latency in frames (power of two, 64 - 1024)
+Napi::Value SetConvolutionLatency(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Latency in frames expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!processor->setConvolutionLatency(info[0].As<Napi::Number>().Int32Value())) {
+        Napi::RangeError::New(env, "Latency must be a power of two from 64 to 1024").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Run the current EQ curve as a linear-phase FIR (optional tap count)
+Napi::Value UseLinearPhaseEQ(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int numTaps = AudioProcessor::DEFAULT_LINEAR_PHASE_TAPS;
+    if (info.Length() >= 1 && info[0].IsNumber()) {
+        numTaps = info[0].As<Napi::Number>().Int32Value();
+    }
+    
+    if (!processor->useLinearPhaseEQ(numTaps)) {
+        Napi::RangeError::New(env, "Tap count must be a power of two up to 65536").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Number::New(env, processor->getLatency());
+}
+
+// Select the processing stage: 'eq', 'convolution' or 'eq+convolution'
+Napi::Value SetProcessingStage(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Stage name expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string name = info[0].As<Napi::String>().Utf8Value();
+    int stage = 0;
+    while (stage < NUM_STAGES && name != STAGE_NAMES[stage]) stage++;
+    if (stage == NUM_STAGES) {
+        Napi::RangeError::New(env, "Stage must be 'eq', 'convolution' or 'eq+convolution'").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!processor->setStage((AudioProcessor::Stage)stage)) {
+        Napi::Error::New(env, "No impulse response loaded").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Frames of delay added by the current stage
+Napi::Value GetLatency(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        return Napi::Number::New(env, 0);
+    }
+    
+    return Napi::Number::New(env, processor->getLatency());
+}
+
+// Replace the output clamp with the true-peak limiter (adds its lookahead to getLatency)
+Napi::Value SetLimiterEnabled(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsBoolean()) {
+        Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    processor->setLimiterEnabled(info[0].As<Napi::Boolean>().Value());
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Limiter ceiling in dBTP (-24 to 0)
+Napi::Value SetLimiterCeiling(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Ceiling in dBTP expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    processor->setLimiterCeiling(info[0].As<Napi::Number>().DoubleValue());
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Limiter release time in milliseconds
+Napi::Value SetLimiterRelease(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Release time in milliseconds expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    processor->setLimiterRelease(info[0].As<Napi::Number>().DoubleValue());
+    
+    return Napi::Boolean::New(env, true);
+}
 
-// Initialize the audio processor
-Napi::Value Initialize(const Napi::CallbackInfo& info) {
+// Lower the limiter input by the EQ curve's peak boost
+Napi::Value SetAutoPreGain(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1 || !info[0].IsNumber()) {
-        Napi::TypeError::New(env, "Sample rate (number) expected").ThrowAsJavaScriptException();
+    if (!processor) {
+        Napi::Error::New(env, "Processor not initialized").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    double sampleRate = info[0].As<Napi::Number>().DoubleValue();
+    if (info.Length() < 1 || !info[0].IsBoolean()) {
+        Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
     
-    processor = std::make_unique<AudioProcessor>();
-    processor->initialize(sampleRate);
+    processor->setAutoPreGain(info[0].As<Napi::Boolean>().Value());
     
     return Napi::Boolean::New(env, true);
 }
 
-// Set EQ band gain
-Napi::Value SetBandGain(const Napi::CallbackInfo& info) {
+// Pre-gain ahead of the limiter in dB
+Napi::Value GetPreGain(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        return Napi::Number::New(env, 0);
+    }
+    
+    return Napi::Number::New(env, processor->getPreGainDB());
+}
+
+// Multiband compressor between the EQ/convolution stages and the output stage
+Napi::Value SetCompressorEnabled(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
     if (!processor) {
@@ -35,21 +812,18 @@ Napi::Value SetBandGain(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
-        Napi::TypeError::New(env, "Band index and gain expected").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsBoolean()) {
+        Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    int bandIndex = info[0].As<Napi::Number>().Int32Value();
-    double gain = info[1].As<Napi::Number>().DoubleValue();
-    
-    processor->setEQBandGain(bandIndex, gain);
+    processor->setCompressorEnabled(info[0].As<Napi::Boolean>().Value());
     
     return Napi::Boolean::New(env, true);
 }
 
-// Get EQ band gain
-Napi::Value GetBandGain(const Napi::CallbackInfo& info) {
+// Compressor band count (3 to 5) and optional ascending crossover frequencies
+Napi::Value SetCompressorBands(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
     if (!processor) {
@@ -57,19 +831,32 @@ Napi::Value GetBandGain(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    if (info.Length() < 1 || !info[0].IsNumber()) {
-        Napi::TypeError::New(env, "Band index expected").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsNumber() || (info.Length() > 1 && !info[1].IsArray())) {
+        Napi::TypeError::New(env, "Band count and optional crossover array expected").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    int bandIndex = info[0].As<Napi::Number>().Int32Value();
-    double gain = processor->getEQBandGain(bandIndex);
+    int numBands = info[0].As<Napi::Number>().Int32Value();
+    if (info.Length() < 2) {
+        return Napi::Boolean::New(env, processor->setCompressorBands(numBands));
+    }
     
-    return Napi::Number::New(env, gain);
+    Napi::Array list = info[1].As<Napi::Array>();
+    if ((int)list.Length() != numBands - 1) {
+        Napi::RangeError::New(env, "Expected one crossover fewer than bands").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::vector<double> crossovers(list.Length());
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        crossovers[i] = list.Get(i).ToNumber().DoubleValue();
+    }
+    
+    return Napi::Boolean::New(env, processor->setCompressorBands(numBands, crossovers.data()));
 }
 
-// Apply preset
-Napi::Value ApplyPreset(const Napi::CallbackInfo& info) {
+// Set one compressor band from { threshold, ratio, knee, attack, release, makeup }
+// (dB, x:1, dB, ms, ms, dB); missing fields keep their current values
+Napi::Value SetCompressorBand(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
     if (!processor) {
@@ -77,19 +864,67 @@ Napi::Value ApplyPreset(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Preset name (string) expected").ThrowAsJavaScriptException();
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "Band index and band object expected").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string presetName = info[0].As<Napi::String>().Utf8Value();
-    processor->applyEQPreset(presetName);
+    int band = info[0].As<Napi::Number>().Int32Value();
+    MultibandCompressor::BandSettings settings;
+    if (!processor->getCompressorBand(band, settings)) {
+        return Napi::Boolean::New(env, false);
+    }
     
-    return Napi::Boolean::New(env, true);
+    Napi::Object object = info[1].As<Napi::Object>();
+    if (object.Has("threshold")) settings.thresholdDB = object.Get("threshold").ToNumber().DoubleValue();
+    if (object.Has("ratio")) settings.ratio = object.Get("ratio").ToNumber().DoubleValue();
+    if (object.Has("knee")) settings.kneeDB = object.Get("knee").ToNumber().DoubleValue();
+    if (object.Has("attack")) settings.attackMs = object.Get("attack").ToNumber().DoubleValue();
+    if (object.Has("release")) settings.releaseMs = object.Get("release").ToNumber().DoubleValue();
+    if (object.Has("makeup")) settings.makeupDB = object.Get("makeup").ToNumber().DoubleValue();
+    
+    return Napi::Boolean::New(env, processor->setCompressorBand(band, settings));
 }
 
-// Reset EQ
-Napi::Value ResetEQ(const Napi::CallbackInfo& info) {
+// Current gain reduction per compressor band in dB (<= 0), for metering
+Napi::Value GetCompressorGainReduction(const Napi::CallbackInfo& info, AudioProcessor* processor) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        return Napi::Array::New(env, 0);
+    }
+    
+    int numBands = processor->getCompressorBandCount();
+    Napi::Array result = Napi::Array::New(env, numBands);
+    for (int i = 0; i < numBands; i++) {
+        result[(uint32_t)i] = Napi::Number::New(env, processor->getCompressorGainReduction(i));
+    }
+    
+    return result;
+}
+
+// DSP kernel variants: { active, detected, available: [...] } (EQ_KERNEL_ISA
+// overrides the detected one when the module loads)
+Napi::Value GetDspKernels(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    Napi::Array available = Napi::Array::New(env);
+    for (int i = 0; i < DspKernels::NUM_ISAS; i++) {
+        if (DspKernels::isSupported((DspKernels::Isa)i)) {
+            available[available.Length()] = Napi::String::New(env, DspKernels::getIsaName((DspKernels::Isa)i));
+        }
+    }
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("active", DspKernels::getIsaName(DspKernels::getActiveIsa()));
+    result.Set("detected", DspKernels::getIsaName(DspKernels::detectIsa()));
+    result.Set("available", available);
+    
+    return result;
+}
+
+// Process audio buffer (for Web Audio integration)
+Napi::Value ProcessBuffer(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
     if (!processor) {
@@ -97,12 +932,136 @@ Napi::Value ResetEQ(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    processor->resetEQ();
+    if (info.Length() < 1 || !isFloat32Array(info[0])) {
+        Napi::TypeError::New(env, "Float32Array expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (throwIfBusy(env, processor)) {
+        return env.Null();
+    }
+    
+    Napi::Float32Array buffer = info[0].As<Napi::Float32Array>();
+    int numSamples = buffer.ElementLength();
+    
+    processor->processInterleavedStereo(buffer.Data(), numSamples);
+    processor->refreshPreGain();
+    
     return Napi::Boolean::New(env, true);
 }
 
-// Enable/Disable EQ
-Napi::Value SetEnabled(const Napi::CallbackInfo& info) {
+/**
+ * processBufferAsync job: processInterleavedStereo on a libuv pool thread,
+ * in slices of whole blocks (so the result matches processBuffer) with a
+ * cancel check between them. The Float32Array - and the Processor object,
+ * for instance calls - is referenced rather than copied; the caller leaves
+ * it alone until the promise settles.
+ */
+class ProcessBufferWorker : public Napi::AsyncWorker {
+public:
+    // Frames per slice, rounded down to whole blocks: a few milliseconds
+    // of work between cancel checks
+    static const int SLICE_FRAMES = 16384;
+    
+    ProcessBufferWorker(Napi::Env env, AudioProcessor* processor, Napi::Float32Array buffer, Napi::Value owner)
+        : Napi::AsyncWorker(env, "processBufferAsync"),
+          processor(processor),
+          data(buffer.Data()),
+          numSamples((int)buffer.ElementLength()),
+          deferred(Napi::Promise::Deferred::New(env)),
+          cancelled(false),
+          running(false),
+          released(false) {
+        bufferReference = Napi::Persistent(Napi::Object(buffer));
+        if (owner.IsObject()) ownerReference = Napi::Persistent(owner.As<Napi::Object>());
+    }
+    
+    Napi::Promise getPromise() const { return deferred.Promise(); }
+    
+    // Stop at the next slice; the promise rejects with the buffer partly
+    // processed
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    
+    // Environment teardown: cancel, and return once Execute no longer uses
+    // the processor. A job that has not started yet never will.
+    void release() {
+        cancel();
+        std::unique_lock<std::mutex> lock(stateMutex);
+        released = true;
+        stopped.wait(lock, [&] { return !running; });
+    }
+    
+protected:
+    void Execute() override {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (released) {
+                SetError("Processing cancelled");
+                return;
+            }
+            running = true;
+        }
+        
+        int blockSize = processor->getMaxBlockSize();
+        int sliceSamples = 2 * blockSize * std::max(1, SLICE_FRAMES / blockSize);
+        for (int offset = 0; offset < numSamples; offset += sliceSamples) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                SetError("Processing cancelled");
+                break;
+            }
+            processor->processInterleavedStereo(data + offset, std::min(sliceSamples, numSamples - offset));
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            running = false;
+        }
+        stopped.notify_all();
+    }
+    
+    void OnOK() override {
+        addonData(Env()).pending.erase(processor);
+        processor->refreshPreGain();
+        deferred.Resolve(bufferReference.Value());
+    }
+    
+    void OnError(const Napi::Error& error) override {
+        addonData(Env()).pending.erase(processor);
+        processor->refreshPreGain();
+        deferred.Reject(error.Value());
+    }
+    
+private:
+    AudioProcessor* processor;
+    float* data;
+    int numSamples;
+    Napi::ObjectReference bufferReference;
+    Napi::ObjectReference ownerReference;
+    Napi::Promise::Deferred deferred;
+    std::atomic<bool> cancelled;
+    
+    // Execute's progress, for release()
+    std::mutex stateMutex;
+    std::condition_variable stopped;
+    bool running;
+    bool released;
+};
+
+// Environment teardown (a worker exiting, or the main thread): stop the
+// capture, wait out async jobs still using a processor, then free the
+// processors on the environment's own thread, before any finalizers run.
+// The AddonData itself goes with the instance data.
+static void ReleaseAddonData(AddonData* data) {
+    data->systemHook.reset();
+    for (auto& job : data->pending) job.second->release();
+    data->processor.reset();
+    data->batch.reset();
+}
+
+// Process a buffer off the JS thread: resolves with the same Float32Array,
+// filtered in place. One at a time per processor; processBuffer,
+// processStream and initialize throw until it settles.
+Napi::Value ProcessBufferAsync(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
     if (!processor) {
@@ -110,30 +1069,197 @@ Napi::Value SetEnabled(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    if (info.Length() < 1 || !info[0].IsBoolean()) {
-        Napi::TypeError::New(env, "Boolean expected").ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !isFloat32Array(info[0])) {
+        Napi::TypeError::New(env, "Float32Array expected").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    bool enabled = info[0].As<Napi::Boolean>().Value();
-    processor->setEQEnabled(enabled);
+    if (throwIfBusy(env, processor)) {
+        return env.Null();
+    }
     
-    return Napi::Boolean::New(env, true);
+    ProcessBufferWorker* worker = new ProcessBufferWorker(env, processor, info[0].As<Napi::Float32Array>(), info.This());
+    addonData(env).pending[processor] = worker;
+    worker->Queue();
+    
+    return worker->getPromise();
 }
 
-// Check if EQ is enabled
-Napi::Value IsEnabled(const Napi::CallbackInfo& info) {
+// Cancel the pending processBufferAsync job, if any; returns whether there
+// was one
+Napi::Value CancelProcessing(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
-    if (!processor) {
+    std::map<AudioProcessor*, ProcessBufferWorker*>& pending = addonData(env).pending;
+    auto job = pending.find(processor);
+    if (job == pending.end()) {
         return Napi::Boolean::New(env, false);
     }
     
-    return Napi::Boolean::New(env, processor->isEQEnabled());
+    job->second->cancel();
+    
+    return Napi::Boolean::New(env, true);
 }
 
-// Get band frequencies
-Napi::Value GetBandFrequencies(const Napi::CallbackInfo& info) {
+/**
+ * processBatch job: the whole batch queued on the BatchProcessor pool, with
+ * the libuv thread running Execute waiting for this batch only, so batches
+ * started together overlap. Holds every job's Float32Array by reference
+ * until the promise settles.
+ */
+class BatchWorker : public Napi::AsyncWorker {
+public:
+    BatchWorker(Napi::Env env, std::shared_ptr<BatchProcessor> batch, Napi::Array list, double sampleRate,
+                int numBands, int maxThreads)
+        : Napi::AsyncWorker(env, "processBatch"),
+          batch(batch),
+          sampleRate(sampleRate),
+          numBands(numBands),
+          maxThreads(maxThreads),
+          deferred(Napi::Promise::Deferred::New(env)) {
+        listReference = Napi::Persistent(Napi::Object(list));
+    }
+    
+    std::vector<BatchProcessor::Job> jobs;
+    std::vector<Napi::ObjectReference> buffers;
+    
+    Napi::Promise getPromise() const { return deferred.Promise(); }
+    
+protected:
+    void Execute() override {
+        batch->process(jobs, sampleRate, numBands, maxThreads);
+    }
+    
+    void OnOK() override {
+        deferred.Resolve(listReference.Value());
+    }
+    
+    void OnError(const Napi::Error& error) override {
+        deferred.Reject(error.Value());
+    }
+    
+private:
+    std::shared_ptr<BatchProcessor> batch;
+    double sampleRate;
+    int numBands;
+    int maxThreads;
+    Napi::ObjectReference listReference;
+    Napi::Promise::Deferred deferred;
+};
+
+// Read one processBatch job: { buffer, presetId } or { buffer, gains }.
+// Throws and returns false on a bad one.
+static bool readBatchJob(Napi::Env env, Napi::Value value, uint32_t index, BatchProcessor::Job& job,
+                         Napi::Float32Array& buffer) {
+    std::string prefix = "Job " + std::to_string(index) + ": ";
+    if (!value.IsObject() || !isFloat32Array(value.As<Napi::Object>().Get("buffer"))) {
+        Napi::TypeError::New(env, prefix + "{ buffer: Float32Array } expected").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    Napi::Object object = value.As<Napi::Object>();
+    buffer = object.Get("buffer").As<Napi::Float32Array>();
+    job.buffer = buffer.Data();
+    job.numFrames = (int)(buffer.ElementLength() / 2);
+    job.presetId = -1;
+    
+    Napi::Value preset = object.Get("presetId");
+    Napi::Value gains = object.Get("gains");
+    if (preset.IsNumber()) {
+        job.presetId = preset.As<Napi::Number>().Int32Value();
+        if (job.presetId < 0 || job.presetId >= Equalizer::NUM_PRESETS) {
+            Napi::RangeError::New(env, prefix + "unknown preset ID").ThrowAsJavaScriptException();
+            return false;
+        }
+    } else if (preset.IsString()) {
+        job.presetId = Equalizer::findPreset(preset.As<Napi::String>().Utf8Value());
+        if (job.presetId < 0) {
+            Napi::TypeError::New(env, prefix + "unknown preset " + preset.As<Napi::String>().Utf8Value())
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+    } else if (gains.IsArray()) {
+        Napi::Array list = gains.As<Napi::Array>();
+        job.gains.resize(list.Length());
+        for (uint32_t i = 0; i < list.Length(); i++) {
+            job.gains[i] = list.Get(i).ToNumber().DoubleValue();
+        }
+    } else {
+        Napi::TypeError::New(env, prefix + "presetId or gains expected").ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+// processBatch([{ buffer, presetId | gains }], { sampleRate, layout, threads }?):
+// EQ every buffer in place on a thread pool, each from clean filter state
+// with its own preset or curve. Resolves with the job array once all are
+// done. Independent of the module's processor and settings.
+Napi::Value ProcessBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsArray() || (info.Length() > 1 && !info[1].IsObject())) {
+        Napi::TypeError::New(env, "Job array and optional options expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    double sampleRate = 44100.0;
+    int numBands = Equalizer::DEFAULT_BANDS;
+    int maxThreads = 0;
+    if (info.Length() > 1) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Get("sampleRate").IsNumber()) {
+            sampleRate = options.Get("sampleRate").As<Napi::Number>().DoubleValue();
+        }
+        if (!(sampleRate > 0.0)) {
+            Napi::RangeError::New(env, "Sample rate must be positive").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (options.Has("layout") && !readLayout(env, options.Get("layout"), numBands)) {
+            return env.Null();
+        }
+        if (options.Get("threads").IsNumber()) {
+            maxThreads = std::max(1, options.Get("threads").As<Napi::Number>().Int32Value());
+        }
+    }
+    
+    AddonData& data = addonData(env);
+    if (!data.batch) data.batch = std::make_shared<BatchProcessor>();
+    
+    Napi::Array list = info[0].As<Napi::Array>();
+    BatchWorker* worker = new BatchWorker(env, data.batch, list, sampleRate, numBands, maxThreads);
+    worker->jobs.resize(list.Length());
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        Napi::Float32Array buffer;
+        if (!readBatchJob(env, list.Get(i), i, worker->jobs[i], buffer)) {
+            delete worker;
+            return env.Null();
+        }
+        worker->buffers.push_back(Napi::Persistent(Napi::Object(buffer)));
+    }
+    
+    // Jobs run in parallel: no two may share memory
+    std::vector<std::pair<float*, float*>> ranges;
+    for (const BatchProcessor::Job& job : worker->jobs) {
+        if (job.numFrames > 0) ranges.push_back(std::make_pair(job.buffer, job.buffer + (size_t)job.numFrames * 2));
+    }
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); i++) {
+        if (ranges[i].first < ranges[i - 1].second) {
+            delete worker;
+            Napi::RangeError::New(env, "Batch buffers must not overlap").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    
+    worker->Queue();
+    
+    return worker->getPromise();
+}
+
+// Convert sources at inputRate to the processing rate and the result to
+// outputRate: (inputRate, outputRate, quality = 'medium')
+Napi::Value SetStreamRates(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
     if (!processor) {
@@ -141,18 +1267,35 @@ Napi::Value GetBandFrequencies(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    std::vector<double> frequencies = processor->getBandFrequencies();
-    Napi::Array result = Napi::Array::New(env, frequencies.size());
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber() ||
+        (info.Length() > 2 && !info[2].IsString())) {
+        Napi::TypeError::New(env, "Input rate, output rate and optional quality expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
     
-    for (size_t i = 0; i < frequencies.size(); i++) {
-        result[i] = Napi::Number::New(env, frequencies[i]);
+    SampleRateConverter::Quality quality = SampleRateConverter::QUALITY_MEDIUM;
+    if (info.Length() > 2) {
+        std::string name = info[2].As<Napi::String>().Utf8Value();
+        int found = -1;
+        for (int q = SampleRateConverter::QUALITY_FAST; q <= SampleRateConverter::QUALITY_BEST; q++) {
+            if (name == SampleRateConverter::getQualityName((SampleRateConverter::Quality)q)) found = q;
+        }
+        if (found < 0) {
+            Napi::TypeError::New(env, "Unknown quality: " + name).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        quality = (SampleRateConverter::Quality)found;
     }
     
-    return result;
+    bool success = processor->setStreamRates(info[0].As<Napi::Number>().DoubleValue(),
+                                             info[1].As<Napi::Number>().DoubleValue(), quality);
+    
+    return Napi::Boolean::New(env, success);
 }
 
-// Process audio buffer (for Web Audio integration)
-Napi::Value ProcessBuffer(const Napi::CallbackInfo& info) {
+// Convert, process and convert an interleaved stereo Float32Array into
+// another; returns the frames written
+Napi::Value ProcessStream(const Napi::CallbackInfo& info, AudioProcessor* processor) {
     Napi::Env env = info.Env();
     
     if (!processor) {
@@ -160,22 +1303,33 @@ Napi::Value ProcessBuffer(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    if (info.Length() < 1 || !info[0].IsTypedArray()) {
-        Napi::TypeError::New(env, "Float32Array expected").ThrowAsJavaScriptException();
+    if (info.Length() < 2 || !isFloat32Array(info[0]) || !isFloat32Array(info[1])) {
+        Napi::TypeError::New(env, "Input and output Float32Array expected").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    Napi::Float32Array buffer = info[0].As<Napi::Float32Array>();
-    int numSamples = buffer.ElementLength();
+    if (throwIfBusy(env, processor)) {
+        return env.Null();
+    }
     
-    processor->processInterleavedStereo(buffer.Data(), numSamples);
+    Napi::Float32Array input = info[0].As<Napi::Float32Array>();
+    Napi::Float32Array output = info[1].As<Napi::Float32Array>();
+    int numFrames = (int)(input.ElementLength() / 2);
+    if ((int)(output.ElementLength() / 2) < processor->getMaxStreamFrames(numFrames)) {
+        Napi::RangeError::New(env, "Output buffer too small").ThrowAsJavaScriptException();
+        return env.Null();
+    }
     
-    return Napi::Boolean::New(env, true);
+    int written = processor->processStream(input.Data(), numFrames, output.Data());
+    processor->refreshPreGain();
+    
+    return Napi::Number::New(env, written);
 }
 
 // System-wide audio hook functions
 Napi::Value InitializeSystemHook(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     systemHook = std::make_unique<SystemAudioHook>();
     bool success = systemHook->initialize();
@@ -185,6 +1339,7 @@ Napi::Value InitializeSystemHook(const Napi::CallbackInfo& info) {
 
 Napi::Value StartSystemCapture(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     if (!systemHook) {
         Napi::Error::New(env, "System hook not initialized").ThrowAsJavaScriptException();
@@ -197,6 +1352,7 @@ Napi::Value StartSystemCapture(const Napi::CallbackInfo& info) {
 
 Napi::Value StopSystemCapture(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     if (!systemHook) {
         return Napi::Boolean::New(env, true);
@@ -208,6 +1364,7 @@ Napi::Value StopSystemCapture(const Napi::CallbackInfo& info) {
 
 Napi::Value IsSystemCapturing(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     if (!systemHook) {
         return Napi::Boolean::New(env, false);
@@ -218,6 +1375,7 @@ Napi::Value IsSystemCapturing(const Napi::CallbackInfo& info) {
 
 Napi::Value SetSystemEQBandGain(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     if (!systemHook) {
         Napi::Error::New(env, "System hook not initialized").ThrowAsJavaScriptException();
@@ -242,6 +1400,7 @@ Napi::Value SetSystemEQBandGain(const Napi::CallbackInfo& info) {
 
 Napi::Value GetSystemEQBandGain(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     if (!systemHook) {
         return Napi::Number::New(env, 0.0);
@@ -264,6 +1423,7 @@ Napi::Value GetSystemEQBandGain(const Napi::CallbackInfo& info) {
 
 Napi::Value ApplySystemEQPreset(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     if (!systemHook) {
         Napi::Error::New(env, "System hook not initialized").ThrowAsJavaScriptException();
@@ -287,6 +1447,7 @@ Napi::Value ApplySystemEQPreset(const Napi::CallbackInfo& info) {
 
 Napi::Value SetSystemEQEnabled(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
     
     if (!systemHook) {
         Napi::Error::New(env, "System hook not initialized").ThrowAsJavaScriptException();
@@ -304,18 +1465,253 @@ Napi::Value SetSystemEQEnabled(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(env, true);
 }
 
+Napi::Value SetSystemEQSmoothingTime(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::unique_ptr<SystemAudioHook>& systemHook = addonData(env).systemHook;
+    
+    if (!systemHook) {
+        Napi::Error::New(env, "System hook not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Smoothing time (number) expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    double milliseconds = info[0].As<Napi::Number>().DoubleValue();
+    
+    Equalizer* eq = systemHook->getEqualizer();
+    if (eq) {
+        eq->setSmoothingTime(milliseconds);
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Processor - an independent processing chain for JavaScript
+ * new Processor(sampleRate, maxBlockSize?, layout?) takes initialize()'s
+ * arguments and has the module's processor functions as methods, each
+ * instance with its own EQ, stages and sample rate, so several streams (a
+ * crossfade, a preview, an offline render) run side by side. The state
+ * comes from the environment's ProcessorPool and goes back to it on
+ * destroy() or when the object is collected.
+ */
+class Processor : public Napi::ObjectWrap<Processor> {
+public:
+    static Napi::Function Define(Napi::Env env);
+    
+    Processor(const Napi::CallbackInfo& info);
+    ~Processor();
+    
+private:
+    std::unique_ptr<AudioProcessor> processor;
+    ProcessorPool* pool;
+    
+    // A binding body on this instance's processor
+    template <ProcessorFunction F>
+    Napi::Value Call(const Napi::CallbackInfo& info);
+    
+    // Start over as a new processor would: initialize()'s arguments
+    Napi::Value Initialize(const Napi::CallbackInfo& info);
+    
+    // Hand the state back to the pool now rather than at collection
+    Napi::Value Destroy(const Napi::CallbackInfo& info);
+    
+    // Processor.reserve(count, sampleRate, maxBlockSize?, layout?): build
+    // pooled state ahead of time; returns the number pooled
+    static Napi::Value Reserve(const Napi::CallbackInfo& info);
+    
+    // Processor.setPoolCapacity(count): most kept for reuse (default 16)
+    static Napi::Value SetPoolCapacity(const Napi::CallbackInfo& info);
+};
+
+Napi::Function Processor::Define(Napi::Env env) {
+    return DefineClass(env, "Processor", {
+        InstanceMethod("initialize", &Processor::Initialize),
+        InstanceMethod("reconfigure", &Processor::Call<Reconfigure>),
+        InstanceMethod("setBandGain", &Processor::Call<SetBandGain>),
+        InstanceMethod("getBandGain", &Processor::Call<GetBandGain>),
+        InstanceMethod("applyPreset", &Processor::Call<ApplyPreset>),
+        InstanceMethod("morphToPreset", &Processor::Call<MorphToPreset>),
+        InstanceMethod("morphPresets", &Processor::Call<MorphPresets>),
+        InstanceMethod("morphToCurve", &Processor::Call<MorphToCurve>),
+        InstanceMethod("resetEQ", &Processor::Call<ResetEQ>),
+        InstanceMethod("setEnabled", &Processor::Call<SetEnabled>),
+        InstanceMethod("isEnabled", &Processor::Call<IsEnabled>),
+        InstanceMethod("setSmoothingTime", &Processor::Call<SetSmoothingTime>),
+        InstanceMethod("getBandFrequencies", &Processor::Call<GetBandFrequencies>),
+        InstanceMethod("addBand", &Processor::Call<AddBand>),
+        InstanceMethod("removeBand", &Processor::Call<RemoveBand>),
+        InstanceMethod("setBand", &Processor::Call<SetBand>),
+        InstanceMethod("getBands", &Processor::Call<GetBands>),
+        InstanceMethod("processBuffer", &Processor::Call<ProcessBuffer>),
+        InstanceMethod("processBufferAsync", &Processor::Call<ProcessBufferAsync>),
+        InstanceMethod("cancelProcessing", &Processor::Call<CancelProcessing>),
+        InstanceMethod("setStreamRates", &Processor::Call<SetStreamRates>),
+        InstanceMethod("processStream", &Processor::Call<ProcessStream>),
+        InstanceMethod("scheduleAutomation", &Processor::Call<ScheduleAutomation>),
+        InstanceMethod("getFramePosition", &Processor::Call<GetFramePosition>),
+        InstanceMethod("loadImpulseResponse", &Processor::Call<LoadImpulseResponse>),
+        InstanceMethod("setConvolutionLatency", &Processor::Call<SetConvolutionLatency>),
+        InstanceMethod("useLinearPhaseEQ", &Processor::Call<UseLinearPhaseEQ>),
+        InstanceMethod("setProcessingStage", &Processor::Call<SetProcessingStage>),
+        InstanceMethod("getLatency", &Processor::Call<GetLatency>),
+        InstanceMethod("setLimiterEnabled", &Processor::Call<SetLimiterEnabled>),
+        InstanceMethod("setLimiterCeiling", &Processor::Call<SetLimiterCeiling>),
+        InstanceMethod("setLimiterRelease", &Processor::Call<SetLimiterRelease>),
+        InstanceMethod("setAutoPreGain", &Processor::Call<SetAutoPreGain>),
+        InstanceMethod("getPreGain", &Processor::Call<GetPreGain>),
+        InstanceMethod("setCompressorEnabled", &Processor::Call<SetCompressorEnabled>),
+        InstanceMethod("setCompressorBands", &Processor::Call<SetCompressorBands>),
+        InstanceMethod("setCompressorBand", &Processor::Call<SetCompressorBand>),
+        InstanceMethod("getCompressorGainReduction", &Processor::Call<GetCompressorGainReduction>),
+        InstanceMethod("destroy", &Processor::Destroy),
+        StaticMethod("reserve", &Processor::Reserve),
+        StaticMethod("setPoolCapacity", &Processor::SetPoolCapacity)
+    });
+}
+
+Processor::Processor(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Processor>(info), pool(&addonData(info.Env()).pool) {
+    double sampleRate;
+    int maxBlockSize, numBands;
+    if (!readConfig(info, 0, sampleRate, maxBlockSize, numBands)) {
+        return;
+    }
+    
+    processor = pool->acquire(sampleRate, maxBlockSize, numBands);
+}
+
+Processor::~Processor() {
+    pool->release(std::move(processor));
+}
+
+template <ProcessorFunction F>
+Napi::Value Processor::Call(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor destroyed").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return F(info, processor.get());
+}
+
+Napi::Value Processor::Initialize(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!processor) {
+        Napi::Error::New(env, "Processor destroyed").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    double sampleRate;
+    int maxBlockSize, numBands;
+    if (!readConfig(info, 0, sampleRate, maxBlockSize, numBands) || throwIfBusy(env, processor.get())) {
+        return env.Null();
+    }
+    
+    processor->reset(sampleRate, maxBlockSize, numBands);
+    
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value Processor::Destroy(const Napi::CallbackInfo& info) {
+    if (throwIfBusy(info.Env(), processor.get())) {
+        return info.Env().Null();
+    }
+    
+    pool->release(std::move(processor));
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+Napi::Value Processor::Reserve(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Count and sample rate expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    double sampleRate;
+    int maxBlockSize, numBands;
+    if (!readConfig(info, 1, sampleRate, maxBlockSize, numBands)) {
+        return env.Null();
+    }
+    
+    int count = info[0].As<Napi::Number>().Int32Value();
+    return Napi::Number::New(env, addonData(env).pool.reserve(count, sampleRate, maxBlockSize, numBands));
+}
+
+Napi::Value Processor::SetPoolCapacity(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Capacity (number) expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    addonData(env).pool.setCapacity(info[0].As<Napi::Number>().Int32Value());
+    
+    return Napi::Boolean::New(env, true);
+}
+
 // Module initialization
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    // Called once per environment (main thread or worker); the instance
+    // data is deleted when the environment goes away
+    AddonData* data = new AddonData();
+    env.SetInstanceData(data);
+    env.AddCleanupHook(ReleaseAddonData, data);
+    
     // Local file EQ functions
     exports.Set("initialize", Napi::Function::New(env, Initialize));
-    exports.Set("setBandGain", Napi::Function::New(env, SetBandGain));
-    exports.Set("getBandGain", Napi::Function::New(env, GetBandGain));
-    exports.Set("applyPreset", Napi::Function::New(env, ApplyPreset));
-    exports.Set("resetEQ", Napi::Function::New(env, ResetEQ));
-    exports.Set("setEnabled", Napi::Function::New(env, SetEnabled));
-    exports.Set("isEnabled", Napi::Function::New(env, IsEnabled));
-    exports.Set("getBandFrequencies", Napi::Function::New(env, GetBandFrequencies));
-    exports.Set("processBuffer", Napi::Function::New(env, ProcessBuffer));
+    exports.Set("reconfigure", Napi::Function::New(env, WithGlobalProcessor<Reconfigure>));
+    exports.Set("setBandGain", Napi::Function::New(env, WithGlobalProcessor<SetBandGain>));
+    exports.Set("getBandGain", Napi::Function::New(env, WithGlobalProcessor<GetBandGain>));
+    exports.Set("applyPreset", Napi::Function::New(env, WithGlobalProcessor<ApplyPreset>));
+    exports.Set("getPresetId", Napi::Function::New(env, GetPresetId));
+    exports.Set("morphToPreset", Napi::Function::New(env, WithGlobalProcessor<MorphToPreset>));
+    exports.Set("morphPresets", Napi::Function::New(env, WithGlobalProcessor<MorphPresets>));
+    exports.Set("morphToCurve", Napi::Function::New(env, WithGlobalProcessor<MorphToCurve>));
+    exports.Set("resetEQ", Napi::Function::New(env, WithGlobalProcessor<ResetEQ>));
+    exports.Set("setEnabled", Napi::Function::New(env, WithGlobalProcessor<SetEnabled>));
+    exports.Set("isEnabled", Napi::Function::New(env, WithGlobalProcessor<IsEnabled>));
+    exports.Set("setSmoothingTime", Napi::Function::New(env, WithGlobalProcessor<SetSmoothingTime>));
+    exports.Set("getBandFrequencies", Napi::Function::New(env, WithGlobalProcessor<GetBandFrequencies>));
+    exports.Set("addBand", Napi::Function::New(env, WithGlobalProcessor<AddBand>));
+    exports.Set("removeBand", Napi::Function::New(env, WithGlobalProcessor<RemoveBand>));
+    exports.Set("setBand", Napi::Function::New(env, WithGlobalProcessor<SetBand>));
+    exports.Set("getBands", Napi::Function::New(env, WithGlobalProcessor<GetBands>));
+    exports.Set("processBuffer", Napi::Function::New(env, WithGlobalProcessor<ProcessBuffer>));
+    exports.Set("processBufferAsync", Napi::Function::New(env, WithGlobalProcessor<ProcessBufferAsync>));
+    exports.Set("cancelProcessing", Napi::Function::New(env, WithGlobalProcessor<CancelProcessing>));
+    exports.Set("setStreamRates", Napi::Function::New(env, WithGlobalProcessor<SetStreamRates>));
+    exports.Set("processStream", Napi::Function::New(env, WithGlobalProcessor<ProcessStream>));
+    exports.Set("scheduleAutomation", Napi::Function::New(env, WithGlobalProcessor<ScheduleAutomation>));
+    exports.Set("getFramePosition", Napi::Function::New(env, WithGlobalProcessor<GetFramePosition>));
+    exports.Set("loadImpulseResponse", Napi::Function::New(env, WithGlobalProcessor<LoadImpulseResponse>));
+    exports.Set("setConvolutionLatency", Napi::Function::New(env, WithGlobalProcessor<SetConvolutionLatency>));
+    exports.Set("useLinearPhaseEQ", Napi::Function::New(env, WithGlobalProcessor<UseLinearPhaseEQ>));
+    exports.Set("setProcessingStage", Napi::Function::New(env, WithGlobalProcessor<SetProcessingStage>));
+    exports.Set("getLatency", Napi::Function::New(env, WithGlobalProcessor<GetLatency>));
+    exports.Set("setLimiterEnabled", Napi::Function::New(env, WithGlobalProcessor<SetLimiterEnabled>));
+    exports.Set("setLimiterCeiling", Napi::Function::New(env, WithGlobalProcessor<SetLimiterCeiling>));
+    exports.Set("setLimiterRelease", Napi::Function::New(env, WithGlobalProcessor<SetLimiterRelease>));
+    exports.Set("setAutoPreGain", Napi::Function::New(env, WithGlobalProcessor<SetAutoPreGain>));
+    exports.Set("getPreGain", Napi::Function::New(env, WithGlobalProcessor<GetPreGain>));
+    exports.Set("setCompressorEnabled", Napi::Function::New(env, WithGlobalProcessor<SetCompressorEnabled>));
+    exports.Set("setCompressorBands", Napi::Function::New(env, WithGlobalProcessor<SetCompressorBands>));
+    exports.Set("setCompressorBand", Napi::Function::New(env, WithGlobalProcessor<SetCompressorBand>));
+    exports.Set("getCompressorGainReduction", Napi::Function::New(env, WithGlobalProcessor<GetCompressorGainReduction>));
+    exports.Set("getDspKernels", Napi::Function::New(env, GetDspKernels));
+    exports.Set("processBatch", Napi::Function::New(env, ProcessBatch));
+    
+    // Independent processors: new Processor(sampleRate, maxBlockSize?, layout?)
+    exports.Set("Processor", Processor::Define(env));
     
     // System-wide EQ functions
     exports.Set("initializeSystemHook", Napi::Function::New(env, InitializeSystemHook));
@@ -326,6 +1722,7 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("getSystemEQBandGain", Napi::Function::New(env, GetSystemEQBandGain));
     exports.Set("applySystemEQPreset", Napi::Function::New(env, ApplySystemEQPreset));
     exports.Set("setSystemEQEnabled", Napi::Function::New(env, SetSystemEQEnabled));
+    exports.Set("setSystemEQSmoothingTime", Napi::Function::New(env, SetSystemEQSmoothingTime));
     
     return exports;
 }
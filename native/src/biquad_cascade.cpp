@@ -0,0 +1,249 @@
+#include "biquad_cascade.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+static const DspKernels::CascadeKernels<float>& cascadeKernels(const DspKernels::Table& table, float) {
+    return table.cascadeFloat;
+}
+
+static const DspKernels::CascadeKernels<double>& cascadeKernels(const DspKernels::Table& table, double) {
+    return table.cascadeDouble;
+}
+
+template <typename T, int NSections>
+BiquadCascade<T, NSections>::BiquadCascade(int n)
+    : numSections(0), simdEnabled(true), widestIsa(DspKernels::AVX512), outputLimit(1) {
+    setNumSections(n);
+}
+
+template <typename T, int NSections>
+BiquadCascade<T, NSections>::~BiquadCascade() {}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::setNumSections(int n) {
+    numSections = std::max(0, std::min(MAX_SECTIONS, n));
+    for (int s = 0; s < MAX_SECTIONS; s++) {
+        setSection(s, 1.0, 0.0, 0.0, 0.0, 0.0);
+    }
+    reset();
+}
+
+template <typename T, int NSections>
+int BiquadCascade<T, NSections>::getNumSections() const {
+    return numSections;
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::setSection(int index, double b0, double b1, double b2, double a1, double a2) {
+    if (index < 0 || index >= MAX_SECTIONS) return;
+
+    T* c = &coefficients[index * 5];
+    c[0] = static_cast<T>(b0);
+    c[1] = static_cast<T>(b1);
+    c[2] = static_cast<T>(b2);
+    c[3] = static_cast<T>(a1);
+    c[4] = static_cast<T>(a2);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::insertSection(int index) {
+    if (numSections >= MAX_SECTIONS || index < 0 || index > numSections) return;
+
+    // Node n (history pair feeding section n) spans NODE values
+    const int NODE = 2 * MAX_CHANNELS;
+    std::memmove(&coefficients[(index + 1) * 5], &coefficients[index * 5],
+                 (numSections - index) * 5 * sizeof(T));
+    std::memmove(&history[(index + 2) * NODE], &history[(index + 1) * NODE],
+                 (numSections - index) * NODE * sizeof(T));
+    std::memcpy(&history[(index + 1) * NODE], &history[index * NODE], NODE * sizeof(T));
+    numSections++;
+    setSection(index, 1.0, 0.0, 0.0, 0.0, 0.0);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::removeSection(int index) {
+    if (index < 0 || index >= numSections) return;
+
+    // The next section now reads the removed section's input history
+    const int NODE = 2 * MAX_CHANNELS;
+    std::memmove(&coefficients[index * 5], &coefficients[(index + 1) * 5],
+                 (numSections - index - 1) * 5 * sizeof(T));
+    std::memmove(&history[(index + 1) * NODE], &history[(index + 2) * NODE],
+                 (numSections - index - 1) * NODE * sizeof(T));
+    numSections--;
+    setSection(numSections, 1.0, 0.0, 0.0, 0.0, 0.0);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::processStereo(float* leftChannel, float* rightChannel, int numSamples) {
+    float* channels[2] = { leftChannel, rightChannel };
+    processBlock(channels, channels, 2, numSamples);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::process(float* const* channels, int numChannels, int numSamples) {
+    processBlock(channels, channels, numChannels, numSamples);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::processBlock(const float* const* input, float* const* output,
+                                               int numChannels, int numSamples) {
+    if (numSamples <= 0) return;
+    numChannels = std::min(numChannels, MAX_CHANNELS);
+
+    DspKernels::CascadeArgs<T> args = {};
+    args.numChannels = numChannels;
+    args.numSamples = numSamples;
+    args.input = input;
+    args.output = output;
+    run(DspKernels::PLANAR, args);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::processInterleaved(float* buffer, int numChannels, int numFrames) {
+    if (numFrames <= 0 || numChannels <= 0) return;
+    int stride = numChannels;
+    numChannels = std::min(numChannels, MAX_CHANNELS);
+
+    DspKernels::CascadeArgs<T> args = {};
+    args.numChannels = numChannels;
+    args.numSamples = numFrames;
+    args.frames = buffer;
+    args.frameStride = stride;
+    run(DspKernels::INTERLEAVED, args);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::processInterleavedTo(const float* buffer, int numChannels,
+                                                       float* const* output, int numOutputs, int numFrames) {
+    if (numFrames <= 0 || numOutputs <= 0) return;
+    int stride = numChannels;
+    numOutputs = std::min(std::min(numOutputs, numChannels), MAX_CHANNELS);
+
+    DspKernels::CascadeArgs<T> args = {};
+    args.numChannels = numOutputs;
+    args.numSamples = numFrames;
+    args.output = output;
+    args.frames = const_cast<float*>(buffer);      // Read only in SPLIT
+    args.frameStride = stride;
+    run(DspKernels::SPLIT, args);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::bypassStereo(const float* leftChannel, const float* rightChannel,
+                                               int numSamples) {
+    if (numSamples <= 0) return;
+    trackInput(0, leftChannel, 1, numSamples);
+    trackInput(1, rightChannel, 1, numSamples);
+    copyInputHistory();
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::bypassInterleaved(const float* buffer, int numChannels, int numFrames) {
+    if (numFrames <= 0 || numChannels <= 0) return;
+    for (int c = 0; c < std::min(numChannels, MAX_CHANNELS); c++) {
+        trackInput(c, buffer + c, numChannels, numFrames);
+    }
+    copyInputHistory();
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::trackInput(int channel, const float* samples, int stride, int numSamples) {
+    // Node 0 holds x[n-1], x[n-2]; only the last two samples matter
+    T& z1 = history[0 * MAX_CHANNELS + channel];
+    T& z2 = history[1 * MAX_CHANNELS + channel];
+    if (numSamples >= 2) {
+        z2 = static_cast<T>(samples[(ptrdiff_t)(numSamples - 2) * stride]);
+    } else {
+        z2 = z1;
+    }
+    z1 = static_cast<T>(samples[(ptrdiff_t)(numSamples - 1) * stride]);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::copyInputHistory() {
+    const int NODE = 2 * MAX_CHANNELS;
+    for (int n = 1; n <= numSections; n++) {
+        std::memcpy(&history[n * NODE], &history[0], NODE * sizeof(T));
+    }
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::run(DspKernels::Layout layout, DspKernels::CascadeArgs<T>& args) {
+    args.coefficients = coefficients;
+    args.numSections = numSections;
+    args.history = history;
+    args.limit = outputLimit;
+
+    const DspKernels::Table& kernels = simdEnabled ? DspKernels::getCapped(widestIsa) : DspKernels::getReference();
+    int fixed = NSections > 0 ? DspKernels::getFixedIndex(numSections) : 0;
+    cascadeKernels(kernels, T()).run[layout][fixed](args);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::reset() {
+    std::memset(history, 0, sizeof(history));
+}
+
+template <typename T, int NSections>
+bool BiquadCascade<T, NSections>::isQuiet(double threshold) const {
+    const T limit = static_cast<T>(threshold);
+    const int count = (numSections + 1) * 2 * MAX_CHANNELS;
+    for (int i = 0; i < count; i++) {
+        if (std::abs(history[i]) >= limit) return false;
+    }
+    return true;
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::setClampEnabled(bool enabled) {
+    outputLimit = enabled ? T(1) : std::numeric_limits<T>::max();
+}
+
+template <typename T, int NSections>
+bool BiquadCascade<T, NSections>::isClampEnabled() const {
+    return outputLimit == T(1);
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::setSimdEnabled(bool enabled) {
+    simdEnabled = enabled;
+}
+
+template <typename T, int NSections>
+bool BiquadCascade<T, NSections>::isSimdEnabled() const {
+    return simdEnabled;
+}
+
+template <typename T, int NSections>
+void BiquadCascade<T, NSections>::setWidestIsa(DspKernels::Isa isa) {
+    widestIsa = isa;
+}
+
+template <typename T, int NSections>
+DspKernels::Isa BiquadCascade<T, NSections>::getWidestIsa() const {
+    return widestIsa;
+}
+
+template <typename T, int NSections>
+const char* BiquadCascade<T, NSections>::getKernelName() {
+    return DspKernels::getIsaName(DspKernels::getActiveIsa());
+}
+
+// Runtime section count, the Linkwitz-Riley crossover halves and the
+// fixed graphic EQ layouts
+template class BiquadCascade<float>;
+template class BiquadCascade<double>;
+template class BiquadCascade<float, 2>;
+template class BiquadCascade<double, 2>;
+template class BiquadCascade<float, 5>;
+template class BiquadCascade<double, 5>;
+template class BiquadCascade<float, 10>;
+template class BiquadCascade<double, 10>;
+template class BiquadCascade<float, 31>;
+template class BiquadCascade<double, 31>;
+template class BiquadCascade<float, 32>;
+template class BiquadCascade<double, 32>;
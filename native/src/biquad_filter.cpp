@@ -5,47 +5,80 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-BiquadFilter::BiquadFilter()
-    : a0(1.0), a1(0.0), a2(0.0), b0(1.0), b1(0.0), b2(0.0),
-      x1(0.0), x2(0.0), y1(0.0), y2(0.0),
-      type(PEAKING), frequency(1000.0), sampleRate(44100.0),
-      gainDB(0.0), Q(1.0) {
+BiquadFilter::Design::Design()
+    : type(PEAKING), frequency(1000.0), sampleRate(44100.0),
+      gainDB(0.0), Q(1.0) {}
+
+BiquadFilter::BiquadFilter() {
     calculateCoefficients();
 }
 
 BiquadFilter::~BiquadFilter() {}
 
 void BiquadFilter::setType(FilterType t) {
-    type = t;
+    design.type = t;
     calculateCoefficients();
 }
 
 void BiquadFilter::setFrequency(double freq, double sr) {
-    frequency = freq;
-    sampleRate = sr;
+    design.frequency = freq;
+    design.sampleRate = sr;
     calculateCoefficients();
 }
 
 void BiquadFilter::setGain(double gain) {
-    gainDB = gain;
+    design.gainDB = gain;
     calculateCoefficients();
 }
 
 void BiquadFilter::setQ(double q) {
-    Q = q;
+    design.Q = q;
+    calculateCoefficients();
+}
+
+void BiquadFilter::setDesign(const Design& d) {
+    design = d;
     calculateCoefficients();
 }
 
 void BiquadFilter::calculateCoefficients() {
-    double A = std::pow(10.0, gainDB / 40.0);  // Amplitude
-    double omega = 2.0 * M_PI * frequency / sampleRate;
-    double sn = std::sin(omega);
-    double cs = std::cos(omega);
-    double alpha = sn / (2.0 * Q);
+    Coefficients c = calculateCoefficients(design);
+    section.setCoefficients(c.b0, c.b1, c.b2, c.a1, c.a2);
+}
+
+BiquadFilter::Coefficients BiquadFilter::calculateCoefficients(const Design& d) {
+    return calculateCoefficients(prepare(d), amplitude(d.gainDB));
+}
+
+BiquadFilter::Prototype BiquadFilter::prepare(const Design& d) {
+    double omega = 2.0 * M_PI * d.frequency / d.sampleRate;
+    
+    Prototype p;
+    p.type = d.type;
+    p.sn = std::sin(omega);
+    p.cs = std::cos(omega);
+    p.alpha = p.sn / (2.0 * d.Q);
+    p.Q = d.Q;
+    return p;
+}
+
+double BiquadFilter::amplitude(double gainDB) {
+    return std::pow(10.0, gainDB / 40.0);
+}
+
+bool BiquadFilter::hasGain(FilterType type) {
+    return type == LOWSHELF || type == HIGHSHELF || type == PEAKING;
+}
+
+BiquadFilter::Coefficients BiquadFilter::calculateCoefficients(const Prototype& p, double A) {
+    double sn = p.sn;
+    double cs = p.cs;
+    double alpha = p.alpha;
+    double a0, a1, a2, b0, b1, b2;
 
-    switch (type) {
+    switch (p.type) {
         case LOWSHELF: {
-            double beta = std::sqrt(A) / Q;
+            double beta = std::sqrt(A) / p.Q;
             b0 = A * ((A + 1) - (A - 1) * cs + beta * sn);
             b1 = 2 * A * ((A - 1) - (A + 1) * cs);
             b2 = A * ((A + 1) - (A - 1) * cs - beta * sn);
@@ -55,7 +88,7 @@ void BiquadFilter::calculateCoefficients() {
             break;
         }
         case HIGHSHELF: {
-            double beta = std::sqrt(A) / Q;
+            double beta = std::sqrt(A) / p.Q;
             b0 = A * ((A + 1) + (A - 1) * cs + beta * sn);
             b1 = -2 * A * ((A - 1) + (A + 1) * cs);
             b2 = A * ((A + 1) + (A - 1) * cs - beta * sn);
@@ -64,7 +97,44 @@ void BiquadFilter::calculateCoefficients() {
             a2 = (A + 1) - (A - 1) * cs - beta * sn;
             break;
         }
-        case PEAKING: {
+        case LOWPASS: {
+            b0 = (1 - cs) / 2;
+            b1 = 1 - cs;
+            b2 = (1 - cs) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        }
+        case HIGHPASS: {
+            b0 = (1 + cs) / 2;
+            b1 = -(1 + cs);
+            b2 = (1 + cs) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        }
+        case NOTCH: {
+            b0 = 1;
+            b1 = -2 * cs;
+            b2 = 1;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        }
+        case ALLPASS: {
+            b0 = 1 - alpha;
+            b1 = -2 * cs;
+            b2 = 1 + alpha;
+            a0 = 1 + alpha;
+            a1 = -2 * cs;
+            a2 = 1 - alpha;
+            break;
+        }
+        case PEAKING:
+        default: {
             b0 = 1 + alpha * A;
             b1 = -2 * cs;
             b2 = 1 - alpha * A;
@@ -76,27 +146,36 @@ void BiquadFilter::calculateCoefficients() {
     }
 
     // Normalize coefficients
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-    a0 = 1.0;
+    Coefficients c;
+    c.b0 = b0 / a0;
+    c.b1 = b1 / a0;
+    c.b2 = b2 / a0;
+    c.a1 = a1 / a0;
+    c.a2 = a2 / a0;
+    return c;
 }
 
 double BiquadFilter::process(double input) {
-    // Direct Form II Transposed implementation
-    double output = b0 * input + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+    return section.process(input);
+}
+
+void BiquadFilter::processBlock(const float* input, float* output, int numSamples) {
+    section.processBlock(input, output, numSamples);
+}
 
-    // Update state
-    x2 = x1;
-    x1 = input;
-    y2 = y1;
-    y1 = output;
+void BiquadFilter::getCoefficients(double& b0, double& b1, double& b2,
+                                   double& a1, double& a2) const {
+    b0 = section.b0;
+    b1 = section.b1;
+    b2 = section.b2;
+    a1 = section.a1;
+    a2 = section.a2;
+}
 
-    return output;
+const BiquadFilter::Design& BiquadFilter::getDesign() const {
+    return design;
 }
 
 void BiquadFilter::reset() {
-    x1 = x2 = y1 = y2 = 0.0;
+    section.reset();
 }
@@ -0,0 +1,104 @@
+#include "capture_pipeline.h"
+#include "dsp_kernels.h"
+#include "realtime_check.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+CapturePipeline::CapturePipeline()
+    : activeEqualizer(nullptr), capturingEqualizer(nullptr), enabled(true), format(FORMAT_FLOAT32) {}
+
+CapturePipeline::~CapturePipeline() {}
+
+Equalizer* CapturePipeline::getEqualizer() {
+    return equalizer.get();
+}
+
+void CapturePipeline::setEqualizer(std::shared_ptr<Equalizer> eq) {
+    Equalizer* previous = activeEqualizer.load();
+    activeEqualizer.store(eq.get());
+
+    // Grace period: the old equalizer may still be mid-packet on the capture
+    // thread. Only the control thread waits here; the capture thread never does.
+    while (previous && capturingEqualizer.load() == previous) {
+        std::this_thread::yield();
+    }
+
+    equalizer = eq;
+}
+
+void CapturePipeline::setEnabled(bool en) {
+    enabled.store(en);
+}
+
+bool CapturePipeline::isEnabled() const {
+    return enabled.load();
+}
+
+void CapturePipeline::setSampleFormat(SampleFormat fmt, int maxFrames, int numChannels) {
+    format = fmt;
+    bool integer = fmt == FORMAT_INT16 || fmt == FORMAT_INT32;
+    scratch.assign(integer ? (size_t)std::max(0, maxFrames) * std::max(0, numChannels) : 0, 0.0f);
+}
+
+CapturePipeline::SampleFormat CapturePipeline::getSampleFormat() const {
+    return format;
+}
+
+void CapturePipeline::processPacket(void* data, int numFrames, int numChannels) {
+    RealtimeScope realtime;
+    if (!enabled.load() || !data || numFrames <= 0 || format == FORMAT_UNSUPPORTED) return;
+
+    // One call per packet: the equalizer filters the interleaved frames in
+    // place, one channel per SIMD lane. Mono gets a single filter chain and
+    // 5.1/7.1 mix formats run every channel (up to Equalizer::MAX_CHANNELS).
+    Equalizer* eq = acquireEqualizer();
+    if (eq) {
+        if (format == FORMAT_FLOAT32) {
+            eq->processInterleaved(static_cast<float*>(data), numChannels, numFrames);
+        } else {
+            processConverted(eq, data, numFrames, numChannels);
+        }
+    }
+    releaseEqualizer();
+}
+
+void CapturePipeline::processConverted(Equalizer* eq, void* data, int numFrames, int numChannels) {
+    const DspKernels::Table& kernels = DspKernels::get();
+    int chunk = numChannels > 0 ? (int)(scratch.size() / numChannels) : 0;
+    if (chunk == 0) return;
+
+    float* samples = scratch.data();
+    for (int frame = 0; frame < numFrames; frame += chunk) {
+        int frames = std::min(chunk, numFrames - frame);
+        int count = frames * numChannels;
+        size_t offset = (size_t)frame * numChannels;
+        if (format == FORMAT_INT16) {
+            int16_t* pcm = static_cast<int16_t*>(data) + offset;
+            kernels.int16ToFloat(pcm, samples, count);
+            eq->processInterleaved(samples, numChannels, frames);
+            kernels.floatToInt16(samples, pcm, count);
+        } else {
+            int32_t* pcm = static_cast<int32_t*>(data) + offset;
+            kernels.int32ToFloat(pcm, samples, count);
+            eq->processInterleaved(samples, numChannels, frames);
+            kernels.floatToInt32(samples, pcm, count);
+        }
+    }
+}
+
+Equalizer* CapturePipeline::acquireEqualizer() {
+    // Announce the pointer, then re-check it is still the active one; if
+    // setEqualizer swapped in between, retry with the new pointer
+    Equalizer* eq = activeEqualizer.load();
+    for (;;) {
+        capturingEqualizer.store(eq);
+        Equalizer* current = activeEqualizer.load();
+        if (current == eq) return eq;
+        eq = current;
+    }
+}
+
+void CapturePipeline::releaseEqualizer() {
+    capturingEqualizer.store(nullptr);
+}
@@ -0,0 +1,47 @@
+#include "coefficient_table.h"
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+// Sample rate, frequency, type, Q
+typedef std::tuple<double, double, int, double> TableKey;
+
+// Tables live until process exit
+static std::mutex registryMutex;
+static std::map<TableKey, std::unique_ptr<CoefficientTable>> registry;
+
+CoefficientTable::CoefficientTable(const BiquadFilter::Design& design)
+    : prototype(BiquadFilter::prepare(design)) {
+    for (int i = 0; i < GRID_SIZE; i++) {
+        double gainDB = (double)(i - MAX_GAIN_DB * STEPS_PER_DB) / STEPS_PER_DB;
+        entries[i] = BiquadFilter::calculateCoefficients(prototype, BiquadFilter::amplitude(gainDB));
+    }
+}
+
+const CoefficientTable* CoefficientTable::find(const BiquadFilter::Design& design) {
+    TableKey key(design.sampleRate, design.frequency, (int)design.type, design.Q);
+    
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry.find(key);
+    if (it != registry.end()) return it->second.get();
+    if ((int)registry.size() >= MAX_TABLES) return nullptr;
+    
+    CoefficientTable* table = new CoefficientTable(design);
+    registry[key].reset(table);
+    return table;
+}
+
+BiquadFilter::Coefficients CoefficientTable::lookup(double gainDB) const {
+    long step = std::lround(gainDB * STEPS_PER_DB);
+    if (step >= -MAX_GAIN_DB * STEPS_PER_DB && step <= MAX_GAIN_DB * STEPS_PER_DB &&
+        (double)step / STEPS_PER_DB == gainDB) {
+        return entries[step + MAX_GAIN_DB * STEPS_PER_DB];
+    }
+    return BiquadFilter::calculateCoefficients(prototype, BiquadFilter::amplitude(gainDB));
+}
+
+const BiquadFilter::Prototype& CoefficientTable::getPrototype() const {
+    return prototype;
+}
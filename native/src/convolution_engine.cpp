@@ -0,0 +1,431 @@
+#include "convolution_engine.h"
+#include "dsp_kernels.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef SimdLanes<float>::Quad FloatQuad;
+
+// y += x * h over n complex bins (split format, n a multiple of the width)
+static void multiplyAccumulate(const float* xRe, const float* xIm, const float* hRe, const float* hIm,
+                               float* yRe, float* yIm, int n) {
+    typedef FloatQuad S;
+    for (int k = 0; k < n; k += S::WIDTH) {
+        S::Vec ar = S::load(xRe + k), ai = S::load(xIm + k);
+        S::Vec br = S::load(hRe + k), bi = S::load(hIm + k);
+        S::store(yRe + k, S::add(S::load(yRe + k), S::sub(S::mul(ar, br), S::mul(ai, bi))));
+        S::store(yIm + k, S::add(S::load(yIm + k), S::add(S::mul(ar, bi), S::mul(ai, br))));
+    }
+}
+
+ConvolutionEngine::Tier::Tier(int size, int firstTap, int count, int offset, int blocks)
+    : blockSize(size), start(firstTap), partitions(count), kernelOffset(offset), fft(2 * size),
+      inputRe(2 * size, 0.0f), inputIm(2 * size, 0.0f), history((size_t)count * 8 * size, 0.0f),
+      workRe(2 * size, 0.0f), workIm(2 * size, 0.0f), mirror(2 * size), fill(0), newest(0),
+      spread(blocks), elapsed(0), outputStart(0) {
+    // Bit reversal is its own inverse, so binPosition also maps storage
+    // positions back to natural bins
+    int n = 2 * size;
+    for (int p = 0; p < n; p++) {
+        int k = fft.binPosition(p);
+        mirror[p] = fft.binPosition((n - k) & (n - 1));
+    }
+
+    // A pass can only be cut at its butterfly groups
+    const int chunk = STEP_POINTS;
+    int passes = fft.getNumPasses();
+    for (int p = 0; p < passes; p++) {
+        addSteps(Step::FORWARD, p, n, std::max(chunk, fft.getPassLength(p)));
+    }
+    addSteps(Step::PREPARE, 0, n, chunk);
+    for (int p = 0; p < count; p++) {
+        addSteps(Step::MULTIPLY, p, n, chunk);
+        addSteps(Step::MULTIPLY_MIRRORED, p, n, chunk);
+    }
+    for (int p = passes - 1; p >= 0; p--) {
+        addSteps(Step::INVERSE, p, n, std::max(chunk, fft.getPassLength(p)));
+    }
+    addSteps(Step::OUTPUT, 0, size, chunk);
+    step = getNumSteps();
+}
+
+void ConvolutionEngine::Tier::addSteps(Step::Kind kind, int index, int total, int chunk) {
+    for (int first = 0; first < total; first += chunk) {
+        Step s = { kind, index, first, std::min(chunk, total - first) };
+        plan.push_back(s);
+    }
+}
+
+int ConvolutionEngine::Tier::getNumSteps() const {
+    return (int)plan.size();
+}
+
+ConvolutionEngine::ConvolutionEngine()
+    : latency(0), maxTaps(0), partitioning(NON_UNIFORM), kernelSize(0), clearRequested(false), clamping(true) {
+    configure(DEFAULT_LATENCY, DEFAULT_MAX_TAPS);
+}
+
+ConvolutionEngine::~ConvolutionEngine() {}
+
+bool ConvolutionEngine::configure(int newLatency, int newMaxTaps, Partitioning newPartitioning) {
+    if (!FFT::isPowerOfTwo(newLatency) || newLatency < MIN_LATENCY || newLatency > MAX_LATENCY) return false;
+    if (newMaxTaps < 1 || newMaxTaps > MAX_TAPS) return false;
+
+    latency = newLatency;
+    maxTaps = newMaxTaps;
+    partitioning = newPartitioning;
+
+    // Tier i has blocks of latency * TIER_RATIO^i. Tier 0 starts at tap 0;
+    // tier i > 0 starts at tap 2 * blockSize - latency, which leaves it
+    // blockSize / latency blocks to finish. Every tier but the last holds
+    // the partitions up to where the next one starts (2 * TIER_RATIO - 1
+    // for tier 0, 2 * TIER_RATIO - 2 after it). A tier within TIER_RATIO
+    // partitions of the end takes them all, which is cheaper than a
+    // next tier holding only a few.
+    std::shared_ptr<Layout> next = std::make_shared<Layout>();
+    next->latency = latency;
+    int blockSize = latency;
+    int start = 0;
+    kernelSize = 0;
+    while (start < maxTaps) {
+        int remaining = (maxTaps - start + blockSize - 1) / blockSize;
+        int upToNext = (2 * blockSize * TIER_RATIO - latency - start) / blockSize;
+        bool last = partitioning == UNIFORM || blockSize * TIER_RATIO > MAX_TIER_BLOCK ||
+                    remaining <= upToNext + TIER_RATIO;
+        int partitions = last ? remaining : upToNext;
+        int spread = std::max(1, (start + latency - blockSize) / latency);
+        next->tiers.emplace_back(new Tier(blockSize, start, partitions, kernelSize, spread));
+        kernelSize += partitions * 8 * blockSize;
+        start += partitions * blockSize;
+        blockSize *= TIER_RATIO;
+    }
+
+    // Output ring: a tier adds up to two of its blocks ahead of the oldest
+    // frame not yet read out
+    int largest = next->tiers.back()->blockSize;
+    next->accLeft.assign(2 * largest, 0.0f);
+    next->accRight.assign(2 * largest, 0.0f);
+    next->accMask = 2 * largest - 1;
+    next->blockIn.assign(2 * latency, 0.0f);
+    next->blockOut.assign(2 * latency, 0.0f);
+    next->blockPos = 0;
+    next->clock = 0;
+    layout = next;
+
+    // The audio thread switches layouts with the kernel that carries it
+    buildKernel(kernels.write());
+    kernels.publish();
+    return true;
+}
+
+bool ConvolutionEngine::setImpulseResponse(const float* left, const float* right, int numTaps) {
+    if (!left || numTaps < 1) return false;
+    int taps = numTaps > MAX_TAPS ? MAX_TAPS : numTaps;
+    irLeft.assign(left, left + taps);
+    if (right) irRight.assign(right, right + taps);
+    else irRight.clear();
+
+    buildKernel(kernels.write());
+    kernels.publish();
+    return true;
+}
+
+void ConvolutionEngine::clear() {
+    clearRequested.store(true, std::memory_order_release);
+}
+
+void ConvolutionEngine::restoreDefaults() {
+    bool loaded = !irLeft.empty();
+    irLeft.clear();
+    irRight.clear();
+    if (latency != DEFAULT_LATENCY || maxTaps != DEFAULT_MAX_TAPS || partitioning != NON_UNIFORM) {
+        configure(DEFAULT_LATENCY, DEFAULT_MAX_TAPS);
+        return;
+    }
+    if (loaded) {
+        buildKernel(kernels.write());
+        kernels.publish();
+    }
+    clear();
+}
+
+void ConvolutionEngine::setOutputClamp(bool enabled) {
+    clamping.store(enabled, std::memory_order_relaxed);
+}
+
+void ConvolutionEngine::buildKernel(Kernel& kernel) {
+    kernel.layout = layout;
+    kernel.loaded = !irLeft.empty();
+    kernel.stereo = !irRight.empty();
+    kernel.spectra.assign(kernelSize, 0.0f);
+    if (!kernel.loaded) return;
+
+    int taps = std::min((int)irLeft.size(), maxTaps);
+    for (const std::unique_ptr<Tier>& tier : layout->tiers) {
+        int B = tier->blockSize;
+        int n = 2 * B;
+        float scale = 1.0f / n;
+        std::vector<float> leftRe(n), leftIm(n), rightRe(n), rightIm(n);
+
+        for (int p = 0; p < tier->partitions; p++) {
+            int first = tier->start + p * B;
+            int count = std::max(0, std::min(B, taps - first));
+
+            // Partition in the first half, zeros in the second (overlap-save)
+            std::fill(leftRe.begin(), leftRe.end(), 0.0f);
+            std::fill(leftIm.begin(), leftIm.end(), 0.0f);
+            std::copy(irLeft.begin() + first, irLeft.begin() + first + count, leftRe.begin());
+            tier->fft.forward(leftRe.data(), leftIm.data());
+
+            float* a = &kernel.spectra[tier->kernelOffset + (size_t)p * 4 * n];
+            if (!kernel.stereo) {
+                for (int k = 0; k < n; k++) {
+                    a[k] = leftRe[k] * scale;
+                    a[n + k] = leftIm[k] * scale;
+                }
+                continue;
+            }
+
+            std::fill(rightRe.begin(), rightRe.end(), 0.0f);
+            std::fill(rightIm.begin(), rightIm.end(), 0.0f);
+            std::copy(irRight.begin() + first, irRight.begin() + first + count, rightRe.begin());
+            tier->fft.forward(rightRe.data(), rightIm.data());
+
+            // With X = FFT(left + i right): Y = X (HL + HR) / 2 + conj(X[-k]) (HL - HR) / 2
+            float* b = a + 2 * n;
+            for (int k = 0; k < n; k++) {
+                a[k] = 0.5f * (leftRe[k] + rightRe[k]) * scale;
+                a[n + k] = 0.5f * (leftIm[k] + rightIm[k]) * scale;
+                b[k] = 0.5f * (leftRe[k] - rightRe[k]) * scale;
+                b[n + k] = 0.5f * (leftIm[k] - rightIm[k]) * scale;
+            }
+        }
+    }
+}
+
+void ConvolutionEngine::processInterleaved(float* buffer, int numFrames) {
+    process(buffer, buffer + 1, 2, numFrames);
+}
+
+void ConvolutionEngine::processStereo(float* leftChannel, float* rightChannel, int numFrames) {
+    process(leftChannel, rightChannel, 1, numFrames);
+}
+
+void ConvolutionEngine::process(float* left, float* right, int stride, int numFrames) {
+    kernels.pull();
+    const Kernel& kernel = kernels.read();
+    Layout& active = *kernel.layout;
+    if (clearRequested.load(std::memory_order_acquire)) {
+        clearRequested.store(false, std::memory_order_relaxed);
+        clearHistory(active);
+    }
+
+    // Frames go into a latency-sized block and come out of the previous
+    // block's result, so the delay is exactly latency for any call size
+    int frame = 0;
+    while (frame < numFrames) {
+        int count = std::min(active.latency - active.blockPos, numFrames - frame);
+        float* in = &active.blockIn[2 * active.blockPos];
+        const float* out = &active.blockOut[2 * active.blockPos];
+        for (int i = 0; i < count; i++) {
+            ptrdiff_t at = (ptrdiff_t)(frame + i) * stride;
+            in[2 * i] = left[at];
+            in[2 * i + 1] = right[at];
+            left[at] = out[2 * i];
+            right[at] = out[2 * i + 1];
+        }
+        active.blockPos += count;
+        frame += count;
+
+        if (active.blockPos == active.latency) {
+            processBlock(active, kernel);
+            active.blockPos = 0;
+        }
+    }
+}
+
+void ConvolutionEngine::processBlock(Layout& active, const Kernel& kernel) {
+    int latency = active.latency;
+    long long clock = active.clock += latency;
+
+    // Feed every tier; a completed block starts its work, and every tier
+    // with work pending runs its share for this block
+    for (const std::unique_ptr<Tier>& tier : active.tiers) {
+        float* re = &tier->inputRe[tier->blockSize + tier->fill];
+        float* im = &tier->inputIm[tier->blockSize + tier->fill];
+        for (int i = 0; i < latency; i++) {
+            re[i] = active.blockIn[2 * i];
+            im[i] = active.blockIn[2 * i + 1];
+        }
+        tier->fill += latency;
+        if (tier->fill == tier->blockSize) {
+            startTier(active, *tier, kernel);
+        }
+        int steps = tier->getNumSteps();
+        if (tier->step < steps) {
+            tier->elapsed++;
+            advanceTier(active, *tier, kernel, (tier->elapsed * steps + tier->spread - 1) / tier->spread);
+        }
+    }
+
+    // Every tier has now contributed to [clock - latency, clock)
+    // (one contiguous run of the accumulator ring, or two where it wraps)
+    float limit = clamping.load(std::memory_order_relaxed) ? 1.0f : std::numeric_limits<float>::max();
+    const DspKernels::Table& kernels = DspKernels::get();
+    int start = (int)((clock - latency) & active.accMask);
+    int run = std::min(latency, active.accMask + 1 - start);
+    float* left = active.accLeft.data();
+    float* right = active.accRight.data();
+    float* out = active.blockOut.data();
+    kernels.interleaveClamp(left + start, right + start, out, run, limit);
+    kernels.interleaveClamp(left, right, out + 2 * run, latency - run, limit);
+    std::fill(left + start, left + start + run, 0.0f);
+    std::fill(right + start, right + start + run, 0.0f);
+    std::fill(left, left + (latency - run), 0.0f);
+    std::fill(right, right + (latency - run), 0.0f);
+}
+
+void ConvolutionEngine::startTier(Layout& active, Tier& tier, const Kernel& kernel) {
+    int B = tier.blockSize;
+    int n = 2 * B;
+
+    // The previous block's work is always done by now; this only guards it
+    if (tier.step < tier.getNumSteps()) advanceTier(active, tier, kernel, tier.getNumSteps());
+
+    if (kernel.loaded) {
+        // Newest window into the delay line; it becomes output frames
+        // [clock - B + start, clock + start)
+        tier.newest = tier.newest + 1 == tier.partitions ? 0 : tier.newest + 1;
+        float* x = &tier.history[(size_t)tier.newest * 4 * n];
+        std::memcpy(x, tier.inputRe.data(), n * sizeof(float));
+        std::memcpy(x + n, tier.inputIm.data(), n * sizeof(float));
+        tier.outputStart = active.clock - B + tier.start;
+        tier.step = 0;
+        tier.elapsed = 0;
+    }
+
+    std::memcpy(tier.inputRe.data(), tier.inputRe.data() + B, B * sizeof(float));
+    std::memcpy(tier.inputIm.data(), tier.inputIm.data() + B, B * sizeof(float));
+    tier.fill = 0;
+}
+
+void ConvolutionEngine::advanceTier(Layout& active, Tier& tier, const Kernel& kernel, int until) {
+    int B = tier.blockSize;
+    int n = 2 * B;
+    float* x = &tier.history[(size_t)tier.newest * 4 * n];
+    float* workRe = tier.workRe.data();
+    float* workIm = tier.workIm.data();
+    int end = std::min(tier.getNumSteps(), until);
+
+    for (; tier.step < end; tier.step++) {
+        const Step& s = tier.plan[tier.step];
+        int first = s.first;
+        int count = s.count;
+        switch (s.kind) {
+            case Step::FORWARD:
+                // Spectrum of the newest window
+                tier.fft.forwardPass(x, x + n, s.index, first, count);
+                break;
+
+            case Step::PREPARE:
+                if (kernel.stereo) {
+                    float* mirrored = x + 2 * n;
+                    for (int p = first; p < first + count; p++) {
+                        mirrored[p] = x[tier.mirror[p]];
+                        mirrored[n + p] = -x[n + tier.mirror[p]];
+                    }
+                }
+                std::fill(workRe + first, workRe + first + count, 0.0f);
+                std::fill(workIm + first, workIm + first + count, 0.0f);
+                break;
+
+            case Step::MULTIPLY:
+            case Step::MULTIPLY_MIRRORED: {
+                // Delayed spectrum p times partition spectrum p (the
+                // mirrored term only for a stereo IR)
+                if (s.kind == Step::MULTIPLY_MIRRORED && !kernel.stereo) break;
+                int p = s.index;
+                int slot = tier.newest >= p ? tier.newest - p : tier.newest - p + tier.partitions;
+                const float* xp = &tier.history[(size_t)slot * 4 * n + first];
+                const float* h = &kernel.spectra[tier.kernelOffset + (size_t)p * 4 * n + first];
+                if (s.kind == Step::MULTIPLY_MIRRORED) {
+                    xp += 2 * n;
+                    h += 2 * n;
+                }
+                multiplyAccumulate(xp, xp + n, h, h + n, workRe + first, workIm + first, count);
+                break;
+            }
+
+            case Step::INVERSE:
+                tier.fft.inversePass(workRe, workIm, s.index, first, count);
+                break;
+
+            case Step::OUTPUT:
+                // Second half is the valid (non-circular) part
+                for (int i = first; i < first + count; i++) {
+                    int at = (int)((tier.outputStart + i) & active.accMask);
+                    active.accLeft[at] += workRe[B + i];
+                    active.accRight[at] += workIm[B + i];
+                }
+                break;
+        }
+    }
+}
+
+void ConvolutionEngine::clearHistory(Layout& active) {
+    for (const std::unique_ptr<Tier>& tier : active.tiers) {
+        std::fill(tier->inputRe.begin(), tier->inputRe.end(), 0.0f);
+        std::fill(tier->inputIm.begin(), tier->inputIm.end(), 0.0f);
+        std::fill(tier->history.begin(), tier->history.end(), 0.0f);
+        tier->fill = 0;
+        tier->newest = 0;
+        tier->step = tier->getNumSteps();
+    }
+    std::fill(active.accLeft.begin(), active.accLeft.end(), 0.0f);
+    std::fill(active.accRight.begin(), active.accRight.end(), 0.0f);
+    std::fill(active.blockIn.begin(), active.blockIn.end(), 0.0f);
+    std::fill(active.blockOut.begin(), active.blockOut.end(), 0.0f);
+    active.blockPos = 0;
+    active.clock = 0;
+}
+
+void ConvolutionEngine::designLinearPhase(const double* magnitude, int numTaps, float* impulse) {
+    // Real, even spectrum -> real, even impulse centred on sample 0
+    FFT fft(numTaps);
+    std::vector<float> re(numTaps, 0.0f), im(numTaps, 0.0f);
+    int half = numTaps / 2;
+    for (int k = 0; k <= half; k++) {
+        re[fft.binPosition(k)] = (float)magnitude[k];
+        if (k > 0 && k < half) re[fft.binPosition(numTaps - k)] = (float)magnitude[k];
+    }
+    fft.inverse(re.data(), im.data());
+
+    // Rotate the peak to numTaps / 2 and taper with a Blackman window
+    for (int i = 0; i < numTaps; i++) {
+        double phase = 2.0 * M_PI * i / numTaps;
+        double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        impulse[i] = (float)(re[(i + half) % numTaps] / numTaps * window);
+    }
+}
+
+int ConvolutionEngine::getLatency() const {
+    return latency;
+}
+
+int ConvolutionEngine::getMaxTaps() const {
+    return maxTaps;
+}
+
+int ConvolutionEngine::getNumTiers() const {
+    return (int)layout->tiers.size();
+}
+
+bool ConvolutionEngine::hasImpulseResponse() const {
+    return !irLeft.empty();
+}
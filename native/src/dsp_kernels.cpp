@@ -0,0 +1,181 @@
+#include "dsp_kernels.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define EQ_CPUID_X86 1
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+    int values[4];
+    __cpuidex(values, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (unsigned)values[i];
+}
+
+static unsigned long long readXcr0() {
+    return _xgetbv(0);
+}
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define EQ_CPUID_X86 1
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+}
+
+static unsigned long long readXcr0() {
+    unsigned low, high;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return ((unsigned long long)high << 32) | low;
+}
+#endif
+
+static const char* const ISA_NAMES[DspKernels::NUM_ISAS] = {
+    "scalar", "baseline", "sse4.1", "avx2", "avx512"
+};
+
+static std::atomic<const DspKernels::Table*> active(nullptr);
+
+// Widest supported variant at or below each instruction set
+static std::atomic<const DspKernels::Table*> capped[DspKernels::NUM_ISAS];
+
+// What the CPU and OS can run, from CPUID and XCR0: the OS must save the
+// YMM (and for AVX-512 the opmask and ZMM) state across context switches
+static bool cpuSupports(DspKernels::Isa isa) {
+    if (isa == DspKernels::SCALAR || isa == DspKernels::BASELINE) return true;
+#if defined(EQ_CPUID_X86)
+    unsigned leaf0[4], leaf1[4], leaf7[4] = { 0, 0, 0, 0 };
+    cpuid(0, 0, leaf0);
+    cpuid(1, 0, leaf1);
+    if (leaf0[0] >= 7) cpuid(7, 0, leaf7);
+
+    bool sse41 = (leaf1[2] >> 19) & 1;
+    bool osxsave = (leaf1[2] >> 27) & 1;
+    bool avx = (leaf1[2] >> 28) & 1;
+    unsigned long long xcr0 = osxsave ? readXcr0() : 0;
+    bool ymmState = (xcr0 & 0x6) == 0x6;
+    bool zmmState = (xcr0 & 0xe6) == 0xe6;
+    bool avx2 = sse41 && avx && ymmState && ((leaf7[1] >> 5) & 1);
+    bool avx512 = avx2 && zmmState && ((leaf7[1] >> 16) & 1);
+
+    switch (isa) {
+        case DspKernels::SSE41: return sse41;
+        case DspKernels::AVX2: return avx2;
+        case DspKernels::AVX512: return avx512;
+        default: return false;
+    }
+#else
+    return false;
+#endif
+}
+
+const DspKernels::Table* DspKernels::getVariant(Isa isa) {
+    const Table* table = nullptr;
+    switch (isa) {
+        case SCALAR: table = scalarVariant(); break;
+        case BASELINE: table = baselineVariant(); break;
+        case SSE41: table = sse41Variant(); break;
+        case AVX2: table = avx2Variant(); break;
+        case AVX512: table = avx512Variant(); break;
+        default: return nullptr;
+    }
+    return table && cpuSupports(isa) ? table : nullptr;
+}
+
+bool DspKernels::isSupported(Isa isa) {
+    return getVariant(isa) != nullptr;
+}
+
+DspKernels::Isa DspKernels::detectIsa() {
+    for (int isa = NUM_ISAS - 1; isa > BASELINE; isa--) {
+        if (isSupported((Isa)isa)) return (Isa)isa;
+    }
+    return BASELINE;
+}
+
+const DspKernels::Table* DspKernels::chooseVariant() {
+    Isa isa;
+    const char* requested = std::getenv("EQ_KERNEL_ISA");
+    if (requested && parseIsa(requested, isa) && isSupported(isa)) {
+        return getVariant(isa);
+    }
+    return getVariant(detectIsa());
+}
+
+const DspKernels::Table& DspKernels::get() {
+    const Table* table = active.load(std::memory_order_acquire);
+    if (!table) {
+        // Only before the load-time choice below has run
+        table = chooseVariant();
+        active.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+// Scalar when widest is below the baseline
+static const DspKernels::Table* findCapped(DspKernels::Isa widest) {
+    for (int isa = widest; isa >= DspKernels::BASELINE; isa--) {
+        if (const DspKernels::Table* table = DspKernels::getVariant((DspKernels::Isa)isa)) return table;
+    }
+    return &DspKernels::getReference();
+}
+
+const DspKernels::Table& DspKernels::getCapped(Isa widest) {
+    const Table& table = get();
+    if (table.isa <= widest) return table;
+    const Table* narrower = capped[widest].load(std::memory_order_acquire);
+    if (!narrower) {
+        // Only before the load-time fill below has run
+        narrower = findCapped(widest);
+        capped[widest].store(narrower, std::memory_order_release);
+    }
+    return *narrower;
+}
+
+const DspKernels::Table& DspKernels::getReference() {
+    return *scalarVariant();
+}
+
+bool DspKernels::setActiveIsa(Isa isa) {
+    const Table* table = getVariant(isa);
+    if (!table) return false;
+    active.store(table, std::memory_order_release);
+    return true;
+}
+
+DspKernels::Isa DspKernels::getActiveIsa() {
+    return get().isa;
+}
+
+const char* DspKernels::getIsaName(Isa isa) {
+    return isa >= 0 && isa < NUM_ISAS ? ISA_NAMES[isa] : "unknown";
+}
+
+bool DspKernels::parseIsa(const char* name, Isa& isa) {
+    for (int i = 0; i < NUM_ISAS; i++) {
+        if (std::strcmp(name, ISA_NAMES[i]) == 0) {
+            isa = (Isa)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int DspKernels::getFixedIndex(int numSections) {
+    for (int i = 1; i < NUM_FIXED; i++) {
+        if (FIXED_SECTIONS[i] == numSections) return i;
+    }
+    return 0;
+}
+
+// Choose once, when the module loads, so the audio thread never runs CPUID
+static bool chooseAtLoad() {
+    DspKernels::get();
+    for (int isa = 0; isa < DspKernels::NUM_ISAS; isa++) {
+        capped[isa].store(findCapped((DspKernels::Isa)isa), std::memory_order_release);
+    }
+    return true;
+}
+
+static const bool chosenAtLoad = chooseAtLoad();
@@ -0,0 +1,16 @@
+// AVX2 kernels: gyp target dsp_kernels_avx2 builds this with -mavx2
+// on x86 (elsewhere it compiles to an empty variant)
+#include "dsp_kernel_variant.h"
+
+#if defined(EQ_HAVE_AVX2)
+static constexpr DspKernels::Table TABLE =
+    makeKernelTable<SimdLanes<float>, SimdLanes<double>, true>(DspKernels::AVX2);
+#endif
+
+const DspKernels::Table* DspKernels::avx2Variant() {
+#if defined(EQ_HAVE_AVX2)
+    return &TABLE;
+#else
+    return nullptr;
+#endif
+}
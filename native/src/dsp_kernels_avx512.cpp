@@ -0,0 +1,22 @@
+// AVX-512 kernels: gyp target dsp_kernels_avx512 builds this with -mavx512f
+// on x86 (elsewhere it compiles to an empty variant)
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ == 12
+// GCC 12's AVX-512 headers trip this on their own _mm512_undefined_*
+// placeholders (GCC PR 105593)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "dsp_kernel_variant.h"
+
+#if defined(EQ_HAVE_AVX512)
+static constexpr DspKernels::Table TABLE =
+    makeKernelTable<SimdLanes<float>, SimdLanes<double>, true>(DspKernels::AVX512);
+#endif
+
+const DspKernels::Table* DspKernels::avx512Variant() {
+#if defined(EQ_HAVE_AVX512)
+    return &TABLE;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,15 @@
+// Scalar reference and baseline kernels, built with the module's own flags
+#include "dsp_kernel_variant.h"
+
+static constexpr DspKernels::Table SCALAR_TABLE =
+    makeKernelTable<ReferenceLanes<float>, ReferenceLanes<double>, false>(DspKernels::SCALAR);
+static constexpr DspKernels::Table BASELINE_TABLE =
+    makeKernelTable<SimdLanes<float>, SimdLanes<double>, true>(DspKernels::BASELINE);
+
+const DspKernels::Table* DspKernels::scalarVariant() {
+    return &SCALAR_TABLE;
+}
+
+const DspKernels::Table* DspKernels::baselineVariant() {
+    return &BASELINE_TABLE;
+}
@@ -0,0 +1,16 @@
+// SSE4.1 kernels: gyp target dsp_kernels_sse41 builds this with -msse4.1
+// on x86 (elsewhere it compiles to an empty variant)
+#include "dsp_kernel_variant.h"
+
+#if defined(EQ_HAVE_SSE41)
+static constexpr DspKernels::Table TABLE =
+    makeKernelTable<SimdLanes<float>, SimdLanes<double>, true>(DspKernels::SSE41);
+#endif
+
+const DspKernels::Table* DspKernels::sse41Variant() {
+#if defined(EQ_HAVE_SSE41)
+    return &TABLE;
+#else
+    return nullptr;
+#endif
+}
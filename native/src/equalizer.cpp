@@ -1,15 +1,19 @@
 #include "equalizer.h"
+#include "band_layout.h"
+#include "coefficient_table.h"
+#include "graphic_equalizer.h"
+#include "parametric_equalizer.h"
 #include <algorithm>
-#include <map>
+#include <cmath>
 
-// 10-band frequencies in Hz
-static const double BAND_FREQUENCIES[Equalizer::NUM_BANDS] = {
-    31.0, 62.0, 125.0, 250.0, 500.0,
-    1000.0, 2000.0, 4000.0, 8000.0, 16000.0
+// EQ Presets (gain values in dB for each band of the 10-band layout);
+// a preset's ID is its index here
+struct Preset {
+    const char* name;
+    double gains[10];
 };
 
-// EQ Presets (gain values in dB for each band)
-static const std::map<std::string, std::vector<double>> PRESETS = {
+static const Preset PRESETS[] = {
     {"flat",        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
     {"rock",        {5, 3, -2, -3, -1, 1, 3, 4, 5, 5}},
     {"pop",         {-1, 2, 4, 4, 2, 0, -1, -1, -1, -1}},
@@ -24,117 +28,57 @@ static const std::map<std::string, std::vector<double>> PRESETS = {
     {"dance",       {4, 3, 2, 0, 0, -1, 2, 3, 4, 4}}
 };
 
-Equalizer::Equalizer(double sr)
-    : sampleRate(sr), enabled(true), currentGains(NUM_BANDS, 0.0) {
-    initializeFilters();
-}
-
-Equalizer::~Equalizer() {}
-
-void Equalizer::initializeFilters() {
-    leftFilters.clear();
-    rightFilters.clear();
-    
-    for (int i = 0; i < NUM_BANDS; i++) {
-        BiquadFilter leftFilter, rightFilter;
-        
-        // Set filter type based on band position
-        BiquadFilter::FilterType type;
-        if (i == 0) {
-            type = BiquadFilter::LOWSHELF;
-        } else if (i == NUM_BANDS - 1) {
-            type = BiquadFilter::HIGHSHELF;
-        } else {
-            type = BiquadFilter::PEAKING;
-        }
-        
-        leftFilter.setType(type);
-        leftFilter.setFrequency(BAND_FREQUENCIES[i], sampleRate);
-        leftFilter.setQ(1.0);
-        leftFilter.setGain(0.0);
-        
-        rightFilter.setType(type);
-        rightFilter.setFrequency(BAND_FREQUENCIES[i], sampleRate);
-        rightFilter.setQ(1.0);
-        rightFilter.setGain(0.0);
-        
-        leftFilters.push_back(leftFilter);
-        rightFilters.push_back(rightFilter);
-    }
-}
-
-void Equalizer::processStereo(float* leftChannel, float* rightChannel, int numSamples) {
-    if (!enabled) return;
-    
-    for (int i = 0; i < numSamples; i++) {
-        double leftSample = leftChannel[i];
-        double rightSample = rightChannel[i];
-        
-        // Process through all filters
-        for (int band = 0; band < NUM_BANDS; band++) {
-            leftSample = leftFilters[band].process(leftSample);
-            rightSample = rightFilters[band].process(rightSample);
-        }
-        
-        // Clamp output to prevent clipping
-        leftChannel[i] = std::max(-1.0, std::min(1.0, leftSample));
-        rightChannel[i] = std::max(-1.0, std::min(1.0, rightSample));
-    }
-}
+static_assert(sizeof(PRESETS) / sizeof(PRESETS[0]) == Equalizer::NUM_PRESETS,
+              "NUM_PRESETS must match the preset table");
 
-void Equalizer::setBandGain(int bandIndex, double gainDB) {
-    if (bandIndex < 0 || bandIndex >= NUM_BANDS) return;
+// Preset gain at a frequency: the 10-band curve interpolated over log
+// frequency, rounded to 0.1 dB so other layouts stay table lookups
+static double presetGain(const double* gains, double frequency) {
+    const double* f = BandLayout<10>::FREQUENCIES;
+    const int last = 9;
+    if (frequency <= f[0]) return gains[0];
+    if (frequency >= f[last]) return gains[last];
     
-    // Clamp gain between -12 and +12 dB
-    gainDB = std::max(-12.0, std::min(12.0, gainDB));
+    int k = 0;
+    while (frequency > f[k + 1]) k++;
+    if (frequency == f[k + 1]) return gains[k + 1];
     
-    currentGains[bandIndex] = gainDB;
-    updateFilter(bandIndex);
+    double t = std::log(frequency / f[k]) / std::log(f[k + 1] / f[k]);
+    double gain = gains[k] + t * (gains[k + 1] - gains[k]);
+    return std::round(gain * CoefficientTable::STEPS_PER_DB) / CoefficientTable::STEPS_PER_DB;
 }
 
-double Equalizer::getBandGain(int bandIndex) const {
-    if (bandIndex < 0 || bandIndex >= NUM_BANDS) return 0.0;
-    return currentGains[bandIndex];
+std::unique_ptr<Equalizer> Equalizer::create(int numBands, double sampleRate) {
+    switch (numBands) {
+        case 5:  return std::make_unique<GraphicEqualizer<5>>(sampleRate);
+        case 10: return std::make_unique<GraphicEqualizer<10>>(sampleRate);
+        case 31: return std::make_unique<GraphicEqualizer<31>>(sampleRate);
+        case PARAMETRIC: return std::make_unique<ParametricEqualizer>(sampleRate);
+        default: return nullptr;
+    }
 }
 
-void Equalizer::updateFilter(int bandIndex) {
-    leftFilters[bandIndex].setGain(currentGains[bandIndex]);
-    rightFilters[bandIndex].setGain(currentGains[bandIndex]);
+bool Equalizer::isSupportedBandCount(int numBands) {
+    return numBands == 5 || numBands == 10 || numBands == 31 || numBands == PARAMETRIC;
 }
 
-void Equalizer::applyPreset(const std::string& presetName) {
-    auto it = PRESETS.find(presetName);
-    if (it == PRESETS.end()) return;
-    
-    const std::vector<double>& gains = it->second;
-    for (int i = 0; i < NUM_BANDS && i < gains.size(); i++) {
-        setBandGain(i, gains[i]);
+int Equalizer::findPreset(const std::string& presetName) {
+    for (int i = 0; i < NUM_PRESETS; i++) {
+        if (presetName == PRESETS[i].name) return i;
     }
+    return -1;
 }
 
-void Equalizer::reset() {
-    for (int i = 0; i < NUM_BANDS; i++) {
-        setBandGain(i, 0.0);
-        leftFilters[i].reset();
-        rightFilters[i].reset();
-    }
+const char* Equalizer::getPresetName(int presetId) {
+    if (presetId < 0 || presetId >= NUM_PRESETS) return nullptr;
+    return PRESETS[presetId].name;
 }
 
-void Equalizer::setEnabled(bool en) {
-    enabled = en;
-    if (!enabled) {
-        // Reset filter state when disabling
-        for (int i = 0; i < NUM_BANDS; i++) {
-            leftFilters[i].reset();
-            rightFilters[i].reset();
-        }
-    }
-}
-
-bool Equalizer::isEnabled() const {
-    return enabled;
+void Equalizer::applyPreset(const std::string& presetName) {
+    int presetId = findPreset(presetName);
+    if (presetId >= 0) applyPreset(presetId);
 }
 
-const double* Equalizer::getBandFrequencies() {
-    return BAND_FREQUENCIES;
+double Equalizer::getPresetGain(int presetId, double frequency) {
+    return presetGain(PRESETS[presetId].gains, frequency);
 }
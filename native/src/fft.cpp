@@ -0,0 +1,255 @@
+#include "fft.h"
+#include "simd.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef SimdLanes<float>::Quad FloatQuad;
+typedef SimdLanes<float>::Scalar FloatScalar;
+
+// (ar + i ai)(br + i bi), optionally with b conjugated
+template <typename S, bool Conjugate>
+static inline void complexMul(typename S::Vec ar, typename S::Vec ai,
+                              typename S::Vec br, typename S::Vec bi,
+                              typename S::Vec& outRe, typename S::Vec& outIm) {
+    if (Conjugate) {
+        outRe = S::add(S::mul(ar, br), S::mul(ai, bi));
+        outIm = S::sub(S::mul(ai, br), S::mul(ar, bi));
+    } else {
+        outRe = S::sub(S::mul(ar, br), S::mul(ai, bi));
+        outIm = S::add(S::mul(ar, bi), S::mul(ai, br));
+    }
+}
+
+// Radix-2 decimation-in-frequency pass: y0 = x0 + x1, y1 = (x0 - x1) W^j
+template <typename S>
+static void forwardRadix2(float* re, float* im, int n, int half, const float* w) {
+    typedef typename S::Vec Vec;
+    for (int base = 0; base < n; base += 2 * half) {
+        float* r0 = re + base;
+        float* i0 = im + base;
+        float* r1 = r0 + half;
+        float* i1 = i0 + half;
+        for (int j = 0; j < half; j += S::WIDTH) {
+            Vec ar = S::load(r0 + j), ai = S::load(i0 + j);
+            Vec br = S::load(r1 + j), bi = S::load(i1 + j);
+            S::store(r0 + j, S::add(ar, br));
+            S::store(i0 + j, S::add(ai, bi));
+            Vec dr, di;
+            complexMul<S, false>(S::sub(ar, br), S::sub(ai, bi), S::load(w + j), S::load(w + half + j), dr, di);
+            S::store(r1 + j, dr);
+            S::store(i1 + j, di);
+        }
+    }
+}
+
+// Inverse of forwardRadix2 (times 2): x0 = y0 + y1 W^-j, x1 = y0 - y1 W^-j
+template <typename S>
+static void inverseRadix2(float* re, float* im, int n, int half, const float* w) {
+    typedef typename S::Vec Vec;
+    for (int base = 0; base < n; base += 2 * half) {
+        float* r0 = re + base;
+        float* i0 = im + base;
+        float* r1 = r0 + half;
+        float* i1 = i0 + half;
+        for (int j = 0; j < half; j += S::WIDTH) {
+            Vec ar = S::load(r0 + j), ai = S::load(i0 + j);
+            Vec br, bi;
+            complexMul<S, true>(S::load(r1 + j), S::load(i1 + j), S::load(w + j), S::load(w + half + j), br, bi);
+            S::store(r0 + j, S::add(ar, br));
+            S::store(i0 + j, S::add(ai, bi));
+            S::store(r1 + j, S::sub(ar, br));
+            S::store(i1 + j, S::sub(ai, bi));
+        }
+    }
+}
+
+// Radix-4 decimation-in-frequency pass (two radix-2 passes fused, so the
+// output order stays plain bit reversal):
+//   y0 = (x0 + x2) + (x1 + x3)
+//   y1 = ((x0 + x2) - (x1 + x3)) W^2j
+//   y2 = ((x0 - x2) - i (x1 - x3)) W^j
+//   y3 = ((x0 - x2) + i (x1 - x3)) W^3j
+template <typename S>
+static void forwardRadix4(float* re, float* im, int n, int quarter, const float* w) {
+    typedef typename S::Vec Vec;
+    const float* w1 = w;
+    const float* w2 = w + 2 * quarter;
+    const float* w3 = w + 4 * quarter;
+    for (int base = 0; base < n; base += 4 * quarter) {
+        float* r = re + base;
+        float* i = im + base;
+        for (int j = 0; j < quarter; j += S::WIDTH) {
+            int k0 = j, k1 = j + quarter, k2 = j + 2 * quarter, k3 = j + 3 * quarter;
+            Vec x0r = S::load(r + k0), x0i = S::load(i + k0);
+            Vec x1r = S::load(r + k1), x1i = S::load(i + k1);
+            Vec x2r = S::load(r + k2), x2i = S::load(i + k2);
+            Vec x3r = S::load(r + k3), x3i = S::load(i + k3);
+
+            Vec s02r = S::add(x0r, x2r), s02i = S::add(x0i, x2i);
+            Vec d02r = S::sub(x0r, x2r), d02i = S::sub(x0i, x2i);
+            Vec s13r = S::add(x1r, x3r), s13i = S::add(x1i, x3i);
+            Vec d13r = S::sub(x1r, x3r), d13i = S::sub(x1i, x3i);
+
+            S::store(r + k0, S::add(s02r, s13r));
+            S::store(i + k0, S::add(s02i, s13i));
+
+            Vec yr, yi;
+            complexMul<S, false>(S::sub(s02r, s13r), S::sub(s02i, s13i),
+                                 S::load(w2 + j), S::load(w2 + quarter + j), yr, yi);
+            S::store(r + k1, yr);
+            S::store(i + k1, yi);
+
+            complexMul<S, false>(S::add(d02r, d13i), S::sub(d02i, d13r),
+                                 S::load(w1 + j), S::load(w1 + quarter + j), yr, yi);
+            S::store(r + k2, yr);
+            S::store(i + k2, yi);
+
+            complexMul<S, false>(S::sub(d02r, d13i), S::add(d02i, d13r),
+                                 S::load(w3 + j), S::load(w3 + quarter + j), yr, yi);
+            S::store(r + k3, yr);
+            S::store(i + k3, yi);
+        }
+    }
+}
+
+// Inverse of forwardRadix4 (times 4)
+template <typename S>
+static void inverseRadix4(float* re, float* im, int n, int quarter, const float* w) {
+    typedef typename S::Vec Vec;
+    const float* w1 = w;
+    const float* w2 = w + 2 * quarter;
+    const float* w3 = w + 4 * quarter;
+    for (int base = 0; base < n; base += 4 * quarter) {
+        float* r = re + base;
+        float* i = im + base;
+        for (int j = 0; j < quarter; j += S::WIDTH) {
+            int k0 = j, k1 = j + quarter, k2 = j + 2 * quarter, k3 = j + 3 * quarter;
+            Vec ar = S::load(r + k0), ai = S::load(i + k0);
+            Vec br, bi, cr, ci, dr, di;
+            complexMul<S, true>(S::load(r + k1), S::load(i + k1), S::load(w2 + j), S::load(w2 + quarter + j), br, bi);
+            complexMul<S, true>(S::load(r + k2), S::load(i + k2), S::load(w1 + j), S::load(w1 + quarter + j), cr, ci);
+            complexMul<S, true>(S::load(r + k3), S::load(i + k3), S::load(w3 + j), S::load(w3 + quarter + j), dr, di);
+
+            Vec s02r = S::add(ar, br), s02i = S::add(ai, bi);
+            Vec s13r = S::sub(ar, br), s13i = S::sub(ai, bi);
+            Vec d02r = S::add(cr, dr), d02i = S::add(ci, di);
+            // i (c - d)
+            Vec d13r = S::sub(di, ci), d13i = S::sub(cr, dr);
+
+            S::store(r + k0, S::add(s02r, d02r));
+            S::store(i + k0, S::add(s02i, d02i));
+            S::store(r + k2, S::sub(s02r, d02r));
+            S::store(i + k2, S::sub(s02i, d02i));
+            S::store(r + k1, S::add(s13r, d13r));
+            S::store(i + k1, S::add(s13i, d13i));
+            S::store(r + k3, S::sub(s13r, d13r));
+            S::store(i + k3, S::sub(s13i, d13i));
+        }
+    }
+}
+
+bool FFT::isPowerOfTwo(int n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+FFT::FFT(int n) : size(n) {
+    int bits = 0;
+    while ((1 << bits) < size) bits++;
+
+    // Odd power of two: one radix-2 pass up front, radix 4 after that
+    int length = size;
+    if (bits & 1) {
+        Pass pass = {length, 2, (int)twiddleTable.size()};
+        int half = length / 2;
+        twiddleTable.resize(twiddleTable.size() + 2 * half);
+        for (int j = 0; j < half; j++) {
+            double angle = -2.0 * M_PI * j / length;
+            twiddleTable[pass.twiddles + j] = (float)std::cos(angle);
+            twiddleTable[pass.twiddles + half + j] = (float)std::sin(angle);
+        }
+        passes.push_back(pass);
+        length = half;
+    }
+    for (; length >= 4; length /= 4) {
+        Pass pass = {length, 4, (int)twiddleTable.size()};
+        int quarter = length / 4;
+        twiddleTable.resize(twiddleTable.size() + 6 * quarter);
+        for (int m = 1; m <= 3; m++) {
+            float* w = &twiddleTable[pass.twiddles + 2 * (m - 1) * quarter];
+            for (int j = 0; j < quarter; j++) {
+                double angle = -2.0 * M_PI * m * j / length;
+                w[j] = (float)std::cos(angle);
+                w[quarter + j] = (float)std::sin(angle);
+            }
+        }
+        passes.push_back(pass);
+    }
+
+    bitReversed.resize(size);
+    for (int k = 0; k < size; k++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) {
+            if (k & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        bitReversed[k] = r;
+    }
+}
+
+int FFT::getSize() const {
+    return size;
+}
+
+void FFT::forward(float* re, float* im) const {
+    for (int p = 0; p < (int)passes.size(); p++) forwardPass(re, im, p, 0, size);
+}
+
+void FFT::inverse(float* re, float* im) const {
+    for (int p = (int)passes.size() - 1; p >= 0; p--) inversePass(re, im, p, 0, size);
+}
+
+int FFT::getNumPasses() const {
+    return (int)passes.size();
+}
+
+int FFT::getPassLength(int p) const {
+    return passes[p].length;
+}
+
+void FFT::forwardPass(float* re, float* im, int p, int first, int count) const {
+    const Pass& pass = passes[p];
+    const float* w = &twiddleTable[pass.twiddles];
+    re += first;
+    im += first;
+    if (pass.radix == 2) {
+        int half = pass.length / 2;
+        if (half >= FloatQuad::WIDTH) forwardRadix2<FloatQuad>(re, im, count, half, w);
+        else forwardRadix2<FloatScalar>(re, im, count, half, w);
+    } else {
+        int quarter = pass.length / 4;
+        if (quarter >= FloatQuad::WIDTH) forwardRadix4<FloatQuad>(re, im, count, quarter, w);
+        else forwardRadix4<FloatScalar>(re, im, count, quarter, w);
+    }
+}
+
+void FFT::inversePass(float* re, float* im, int p, int first, int count) const {
+    const Pass& pass = passes[p];
+    const float* w = &twiddleTable[pass.twiddles];
+    re += first;
+    im += first;
+    if (pass.radix == 2) {
+        int half = pass.length / 2;
+        if (half >= FloatQuad::WIDTH) inverseRadix2<FloatQuad>(re, im, count, half, w);
+        else inverseRadix2<FloatScalar>(re, im, count, half, w);
+    } else {
+        int quarter = pass.length / 4;
+        if (quarter >= FloatQuad::WIDTH) inverseRadix4<FloatQuad>(re, im, count, quarter, w);
+        else inverseRadix4<FloatScalar>(re, im, count, quarter, w);
+    }
+}
+
+int FFT::binPosition(int k) const {
+    return bitReversed[k];
+}
@@ -0,0 +1,24 @@
+#include "graphic_equalizer.h"
+
+template <int NBands>
+GraphicEqualizer<NBands>::GraphicEqualizer(double sr)
+    : BandEqualizer<NBands>(sr) {
+    std::lock_guard<std::mutex> lock(this->controlMutex);
+    for (int i = 0; i < NBands; i++) {
+        BiquadFilter::Design design;
+        design.type = bandType<NBands>(i);
+        design.frequency = Layout::FREQUENCIES[i];
+        design.sampleRate = sr;
+        design.Q = Layout::Q;
+        design.gainDB = 0.0;
+        this->assignBand(i, design);
+    }
+    this->publish();
+}
+
+template <int NBands>
+GraphicEqualizer<NBands>::~GraphicEqualizer() {}
+
+template class GraphicEqualizer<5>;
+template class GraphicEqualizer<10>;
+template class GraphicEqualizer<31>;
@@ -0,0 +1,344 @@
+#include "multiband_compressor.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+typedef SimdLanes<float>::Quad FloatQuad;
+
+// Crossovers per band count (3, 4, 5 bands)
+static const double DEFAULT_CROSSOVERS[3][MultibandCompressor::MAX_BANDS - 1] = {
+    { 200.0, 2000.0 },
+    { 120.0, 1000.0, 6000.0 },
+    { 100.0, 500.0, 2000.0, 8000.0 }
+};
+
+static const double BUTTERWORTH_Q = 0.70710678118654752;
+
+MultibandCompressor::BandSettings::BandSettings()
+    : thresholdDB(-18.0), ratio(3.0), kneeDB(6.0), attackMs(10.0), releaseMs(120.0), makeupDB(0.0) {}
+
+MultibandCompressor::MultibandCompressor()
+    : sampleRate(44100.0), intervalPos(0), numBands(0), limit(1.0f), audioResetCount(0),
+      clearRequested(false) {
+    std::memset(&staging, 0, sizeof(staging));
+    staging.numBands = DEFAULT_BANDS;
+    std::copy(DEFAULT_CROSSOVERS[0], DEFAULT_CROSSOVERS[0] + DEFAULT_BANDS - 1, staging.crossovers);
+    staging.clamp = true;
+    for (int b = 0; b < MAX_BANDS; b++) reduction[b].store(0.0f);
+
+    // Band signals overshoot before they are summed; the sum is clamped.
+    // Two channels use at most a lane pair, which AVX-512 builds cannot
+    // widen: on some parts that variant ran the split at twice the AVX2
+    // cost, so the crossovers stay on AVX2 at most.
+    for (int k = 0; k < MAX_BANDS - 1; k++) {
+        lowpass[k].setClampEnabled(false);
+        highpass[k].setClampEnabled(false);
+        lowpass[k].setWidestIsa(DspKernels::AVX2);
+        highpass[k].setWidestIsa(DspKernels::AVX2);
+    }
+
+    std::memset(bands, 0, sizeof(bands));
+    std::memset(levels, 0, sizeof(levels));
+    std::memset(gains, 0, sizeof(gains));
+    publish();
+}
+
+MultibandCompressor::~MultibandCompressor() {}
+
+void MultibandCompressor::prepare(double sr) {
+    sampleRate = sr;
+    staging.resetCount++;
+    clearRequested.store(false);
+    publish();
+}
+
+void MultibandCompressor::clear() {
+    clearRequested.store(true, std::memory_order_release);
+}
+
+void MultibandCompressor::restoreDefaults() {
+    for (int b = 0; b < MAX_BANDS; b++) settings[b] = BandSettings();
+    staging.numBands = DEFAULT_BANDS;
+    std::copy(DEFAULT_CROSSOVERS[0], DEFAULT_CROSSOVERS[0] + DEFAULT_BANDS - 1, staging.crossovers);
+    staging.resetCount++;
+    publish();
+}
+
+bool MultibandCompressor::setBands(int count, const double* crossovers) {
+    if (count < MIN_BANDS || count > MAX_BANDS) return false;
+    const double* frequencies = crossovers ? crossovers : DEFAULT_CROSSOVERS[count - MIN_BANDS];
+    for (int k = 0; k < count - 1; k++) {
+        if (frequencies[k] < 20.0 || frequencies[k] > 0.45 * sampleRate) return false;
+        if (k > 0 && frequencies[k] <= frequencies[k - 1]) return false;
+    }
+
+    staging.numBands = count;
+    std::copy(frequencies, frequencies + count - 1, staging.crossovers);
+    staging.resetCount++;
+    publish();
+    return true;
+}
+
+int MultibandCompressor::getNumBands() const {
+    return staging.numBands;
+}
+
+double MultibandCompressor::getCrossover(int index) const {
+    if (index < 0 || index >= staging.numBands - 1) return 0.0;
+    return staging.crossovers[index];
+}
+
+bool MultibandCompressor::setBand(int band, const BandSettings& s) {
+    if (band < 0 || band >= MAX_BANDS) return false;
+    BandSettings& t = settings[band];
+    t.thresholdDB = std::max(-60.0, std::min(0.0, s.thresholdDB));
+    t.ratio = std::max(1.0, std::min(20.0, s.ratio));
+    t.kneeDB = std::max(0.0, std::min(24.0, s.kneeDB));
+    t.attackMs = std::max(0.1, std::min(500.0, s.attackMs));
+    t.releaseMs = std::max(5.0, std::min(5000.0, s.releaseMs));
+    t.makeupDB = std::max(-24.0, std::min(24.0, s.makeupDB));
+    publish();
+    return true;
+}
+
+bool MultibandCompressor::getBand(int band, BandSettings& s) const {
+    if (band < 0 || band >= MAX_BANDS) return false;
+    s = settings[band];
+    return true;
+}
+
+void MultibandCompressor::setOutputClamp(bool enabled) {
+    staging.clamp = enabled;
+    publish();
+}
+
+double MultibandCompressor::getGainReduction(int band) const {
+    if (band < 0 || band >= MAX_BANDS) return 0.0;
+    return reduction[band].load(std::memory_order_relaxed);
+}
+
+void MultibandCompressor::publish() {
+    // Crossover sections: both halves of an LR4 filter are the same
+    // Butterworth biquad; low + high is the all-pass with the same Q
+    BiquadFilter::Design design;
+    design.sampleRate = sampleRate;
+    design.Q = BUTTERWORTH_Q;
+    for (int k = 0; k < staging.numBands - 1; k++) {
+        design.frequency = std::min(staging.crossovers[k], 0.45 * sampleRate);
+        const BiquadFilter::FilterType types[3] = { BiquadFilter::LOWPASS, BiquadFilter::HIGHPASS, BiquadFilter::ALLPASS };
+        double* targets[3] = { staging.lowpass[k], staging.highpass[k], staging.allpass[k] };
+        for (int t = 0; t < 3; t++) {
+            design.type = types[t];
+            BiquadFilter::Coefficients c = BiquadFilter::calculateCoefficients(design);
+            double values[5] = { c.b0, c.b1, c.b2, c.a1, c.a2 };
+            std::copy(values, values + 5, targets[t]);
+        }
+    }
+
+    // Envelope coefficients per GAIN_INTERVAL step
+    double intervalsPerMs = 0.001 * sampleRate / GAIN_INTERVAL;
+    for (int b = 0; b < MAX_BANDS; b++) {
+        const BandSettings& s = settings[b];
+        Dynamics& d = staging.dynamics[b];
+        d.threshold = (float)s.thresholdDB;
+        d.slope = (float)(1.0 / s.ratio - 1.0);
+        d.knee = (float)s.kneeDB;
+        d.kneeStart = (float)std::pow(10.0, (s.thresholdDB - 0.5 * s.kneeDB) / 20.0);
+        d.attack = (float)(1.0 - std::exp(-1.0 / (s.attackMs * intervalsPerMs)));
+        d.release = (float)std::exp(-1.0 / (s.releaseMs * intervalsPerMs));
+        d.makeup = (float)std::pow(10.0, s.makeupDB / 20.0);
+    }
+
+    parameters.write() = staging;
+    parameters.publish();
+}
+
+void MultibandCompressor::pullParameters() {
+    bool fresh = parameters.pull();
+    const Snapshot& p = parameters.read();
+    bool reset = false;
+    if (clearRequested.load(std::memory_order_acquire)) {
+        clearRequested.store(false, std::memory_order_relaxed);
+        reset = true;
+    }
+    if (!fresh) {
+        if (reset) resetState(p);
+        return;
+    }
+
+    // A new band layout starts from clear history; crossover and dynamics
+    // changes are picked up as they are
+    if (p.numBands != numBands || p.resetCount != audioResetCount) {
+        numBands = p.numBands;
+        audioResetCount = p.resetCount;
+        for (int k = 0; k < numBands - 1; k++) {
+            lowpass[k].setNumSections(numBands - k);
+        }
+        reset = true;
+    }
+    for (int k = 0; k < numBands - 1; k++) {
+        const double* low = p.lowpass[k];
+        const double* high = p.highpass[k];
+        for (int s = 0; s < 2; s++) {
+            lowpass[k].setSection(s, low[0], low[1], low[2], low[3], low[4]);
+            highpass[k].setSection(s, high[0], high[1], high[2], high[3], high[4]);
+        }
+
+        // Band k then passes through the all-pass of every crossover above
+        for (int s = 2; s < numBands - k; s++) {
+            const double* c = p.allpass[k + s - 1];
+            lowpass[k].setSection(s, c[0], c[1], c[2], c[3], c[4]);
+        }
+    }
+
+    for (int b = 0; b < LANES; b++) {
+        attack[b] = b < numBands ? p.dynamics[b].attack : 0.0f;
+        release[b] = b < numBands ? p.dynamics[b].release : 0.0f;
+    }
+    limit = p.clamp ? 1.0f : std::numeric_limits<float>::max();
+    if (reset) resetState(p);
+}
+
+void MultibandCompressor::resetState(const Snapshot& p) {
+    for (int k = 0; k < MAX_BANDS - 1; k++) {
+        lowpass[k].reset();
+        highpass[k].reset();
+    }
+    std::fill(intervalPeak, intervalPeak + LANES, 0.0f);
+    std::fill(peak, peak + LANES, 0.0f);
+    std::fill(envelope, envelope + LANES, 0.0f);
+    for (int b = 0; b < MAX_BANDS; b++) {
+        gain[b] = gainTarget[b] = p.dynamics[b].makeup;
+        gainStep[b] = 0.0f;
+        reduction[b].store(0.0f, std::memory_order_relaxed);
+    }
+    intervalPos = 0;
+}
+
+void MultibandCompressor::processInterleaved(float* buffer, int numFrames) {
+    process(buffer, buffer + 1, 2, numFrames);
+}
+
+void MultibandCompressor::processStereo(float* leftChannel, float* rightChannel, int numFrames) {
+    process(leftChannel, rightChannel, 1, numFrames);
+}
+
+void MultibandCompressor::process(float* left, float* right, int stride, int numFrames) {
+    pullParameters();
+    const Snapshot& p = parameters.read();
+    for (int frame = 0; frame < numFrames; frame += CHUNK) {
+        ptrdiff_t at = (ptrdiff_t)frame * stride;
+        processChunk(p, left + at, right + at, stride, std::min(CHUNK, numFrames - frame));
+    }
+}
+
+void MultibandCompressor::processChunk(const Snapshot& p, float* left, float* right, int stride,
+                                       int numFrames) {
+    typedef FloatQuad S;
+    float* band[MAX_BANDS][2];
+    for (int b = 0; b < numBands; b++) {
+        band[b][0] = bands[b][0];
+        band[b][1] = bands[b][1];
+    }
+
+    // First crossover straight from the caller's frames, then each high
+    // half splits again: high into the next band, low in place
+    if (stride == 1) {
+        const float* input[2] = { left, right };
+        lowpass[0].processBlock(input, band[0], 2, numFrames);
+        highpass[0].processBlock(input, band[1], 2, numFrames);
+    } else {
+        lowpass[0].processInterleavedTo(left, stride, band[0], 2, numFrames);
+        highpass[0].processInterleavedTo(left, stride, band[1], 2, numFrames);
+    }
+    for (int k = 1; k < numBands - 1; k++) {
+        highpass[k].processBlock(band[k], band[k + 1], 2, numFrames);
+        lowpass[k].process(band[k], 2, numFrames);
+    }
+
+    // Stereo-linked level per frame; lanes past numFrames read slack
+    for (int b = 0; b < numBands; b++) {
+        for (int i = 0; i < numFrames; i += S::WIDTH) {
+            S::Vec l = S::abs(S::load(bands[b][0] + i));
+            S::Vec r = S::abs(S::load(bands[b][1] + i));
+            S::store(levels[b] + i, S::max(l, r));
+        }
+    }
+
+    // Interval peaks and gain ramps, split at gain computer runs
+    int pos = 0;
+    while (pos < numFrames) {
+        int count = std::min(GAIN_INTERVAL - intervalPos, numFrames - pos);
+        for (int b = 0; b < numBands; b++) {
+            float level = intervalPeak[b];
+            const float* in = levels[b] + pos;
+            float* ramp = gains[b] + pos;
+            for (int i = 0; i < count; i++) {
+                level = std::max(level, in[i]);
+                ramp[i] = gain[b] + gainStep[b] * (i + 1);
+            }
+            intervalPeak[b] = level;
+            gain[b] += gainStep[b] * count;
+        }
+        intervalPos += count;
+        pos += count;
+        if (intervalPos == GAIN_INTERVAL) {
+            updateGains(p);
+            intervalPos = 0;
+        }
+    }
+
+    // Sum the bands at their gains back into the caller's frames
+    S::Vec lo = S::set1(-limit);
+    S::Vec hi = S::set1(limit);
+    for (int c = 0; c < 2; c++) {
+        for (int i = 0; i < numFrames; i += S::WIDTH) {
+            S::Vec sum = S::mul(S::load(bands[0][c] + i), S::load(gains[0] + i));
+            for (int b = 1; b < numBands; b++) {
+                sum = S::add(sum, S::mul(S::load(bands[b][c] + i), S::load(gains[b] + i)));
+            }
+            S::store(bands[0][c] + i, S::clamp(sum, lo, hi));
+        }
+    }
+    for (int i = 0; i < numFrames; i++) {
+        ptrdiff_t at = (ptrdiff_t)i * stride;
+        left[at] = bands[0][0][i];
+        right[at] = bands[0][1][i];
+    }
+}
+
+void MultibandCompressor::updateGains(const Snapshot& p) {
+    typedef FloatQuad S;
+
+    // Envelope, all bands at once: the peak jumps up and releases
+    // exponentially, the envelope follows it at the attack rate
+    for (int b = 0; b < LANES; b += S::WIDTH) {
+        S::Vec held = S::max(S::load(intervalPeak + b), S::mul(S::load(peak + b), S::load(release + b)));
+        S::Vec env = S::load(envelope + b);
+        env = S::add(env, S::mul(S::sub(held, env), S::load(attack + b)));
+        S::store(peak + b, held);
+        S::store(envelope + b, env);
+        S::store(intervalPeak + b, S::set1(0.0f));
+    }
+
+    // Soft-knee gain computer; bands below the knee only get makeup gain
+    for (int b = 0; b < numBands; b++) {
+        const Dynamics& d = p.dynamics[b];
+        float reductionDB = 0.0f;
+        if (envelope[b] > d.kneeStart) {
+            float over = 20.0f * std::log10(envelope[b]) - d.threshold;
+            if (2.0f * over < d.knee) {
+                float x = over + 0.5f * d.knee;
+                reductionDB = d.slope * x * x / (2.0f * d.knee);
+            } else {
+                reductionDB = d.slope * over;
+            }
+        }
+        gain[b] = gainTarget[b];
+        gainTarget[b] = d.makeup * std::pow(10.0f, reductionDB / 20.0f);
+        gainStep[b] = (gainTarget[b] - gain[b]) / GAIN_INTERVAL;
+        reduction[b].store(reductionDB, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,60 @@
+#include "parametric_equalizer.h"
+#include "band_layout.h"
+
+ParametricEqualizer::ParametricEqualizer(double sr)
+    : BandEqualizer<32>(sr) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    for (int i = 0; i < DEFAULT_BANDS; i++) {
+        BiquadFilter::Design design;
+        design.type = bandType<DEFAULT_BANDS>(i);
+        design.frequency = BandLayout<DEFAULT_BANDS>::FREQUENCIES[i];
+        design.sampleRate = sr;
+        design.Q = BandLayout<DEFAULT_BANDS>::Q;
+        design.gainDB = 0.0;
+        assignBand(i, design);
+    }
+    publish();
+}
+
+ParametricEqualizer::~ParametricEqualizer() {}
+
+int ParametricEqualizer::addBand(const BiquadFilter::Design& design) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    
+    // Append after the last band, else reuse the first gap
+    int slot = -1;
+    for (int i = MAX_BANDS - 1; i >= 0 && !isSlotUsed(i); i--) slot = i;
+    for (int i = 0; slot < 0 && i < MAX_BANDS; i++) {
+        if (!isSlotUsed(i)) slot = i;
+    }
+    if (slot < 0) return -1;
+    
+    assignBand(slot, design);
+    publish();
+    
+    int bandIndex = 0;
+    for (int i = 0; i < slot; i++) {
+        if (isSlotUsed(i)) bandIndex++;
+    }
+    return bandIndex;
+}
+
+bool ParametricEqualizer::removeBand(int bandIndex) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    int slot = slotOf(bandIndex);
+    if (slot < 0) return false;
+    
+    releaseBand(slot);
+    publish();
+    return true;
+}
+
+bool ParametricEqualizer::setBand(int bandIndex, const BiquadFilter::Design& design) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    int slot = slotOf(bandIndex);
+    if (slot < 0) return false;
+    
+    assignBand(slot, design);
+    publish();
+    return true;
+}
@@ -0,0 +1,95 @@
+#include "processor_pool.h"
+#include <algorithm>
+
+ProcessorPool::ProcessorPool() : capacity(DEFAULT_CAPACITY) {}
+
+ProcessorPool::~ProcessorPool() {}
+
+bool ProcessorPool::matches(const AudioProcessor& processor, double sampleRate, int maxBlockSize, int numBands) {
+    if (!Equalizer::isSupportedBandCount(numBands)) numBands = Equalizer::DEFAULT_BANDS;
+    return processor.getSampleRate() == sampleRate &&
+           processor.getMaxBlockSize() == std::max(1, maxBlockSize) &&
+           processor.getLayout() == numBands;
+}
+
+std::unique_ptr<AudioProcessor> ProcessorPool::acquire(double sampleRate, int maxBlockSize, int numBands) {
+    std::unique_ptr<AudioProcessor> processor;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!pooled.empty()) {
+            auto match = std::find_if(pooled.begin(), pooled.end(), [&](const std::unique_ptr<AudioProcessor>& p) {
+                return matches(*p, sampleRate, maxBlockSize, numBands);
+            });
+            if (match == pooled.end()) match = pooled.end() - 1;
+            processor = std::move(*match);
+            pooled.erase(match);
+        }
+    }
+
+    // Pooled processors are reset already; one for another configuration
+    // (or a new one) is reset to this one outside the lock
+    if (processor && matches(*processor, sampleRate, maxBlockSize, numBands)) return processor;
+    if (!processor) processor = std::make_unique<AudioProcessor>();
+    processor->reset(sampleRate, maxBlockSize, numBands);
+    return processor;
+}
+
+void ProcessorPool::release(std::unique_ptr<AudioProcessor> processor) {
+    if (!processor) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ((int)pooled.size() >= capacity) return;
+    }
+
+    processor->reset(processor->getSampleRate(), processor->getMaxBlockSize(), processor->getLayout());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if ((int)pooled.size() < capacity) pooled.push_back(std::move(processor));
+}
+
+int ProcessorPool::reserve(int count, double sampleRate, int maxBlockSize, int numBands) {
+    int have = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::unique_ptr<AudioProcessor>& p : pooled) {
+            if (matches(*p, sampleRate, maxBlockSize, numBands)) have++;
+        }
+        count = std::min(count - have, capacity - (int)pooled.size());
+    }
+
+    // Built outside the lock: each one is about a millisecond
+    std::vector<std::unique_ptr<AudioProcessor>> built;
+    for (int i = 0; i < count; i++) {
+        built.push_back(std::make_unique<AudioProcessor>());
+        built.back()->initialize(sampleRate, maxBlockSize, numBands);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::unique_ptr<AudioProcessor>& p : built) {
+        if ((int)pooled.size() < capacity) pooled.push_back(std::move(p));
+    }
+    return (int)pooled.size();
+}
+
+void ProcessorPool::setCapacity(int newCapacity) {
+    std::vector<std::unique_ptr<AudioProcessor>> surplus;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        capacity = std::max(0, newCapacity);
+        while ((int)pooled.size() > capacity) {
+            surplus.push_back(std::move(pooled.back()));
+            pooled.pop_back();
+        }
+    }
+    // Destroyed here, outside the lock
+}
+
+int ProcessorPool::getCapacity() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+int ProcessorPool::getPooledCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int)pooled.size();
+}
@@ -0,0 +1,204 @@
+#include "realtime_check.h"
+
+#if defined(EQ_REALTIME_CHECK)
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#define EQ_INTERCEPT_LIBC 1
+#endif
+
+// Nesting depth of RealtimeScope on this thread; plain TLS, so reading it
+// from inside malloc never allocates
+static thread_local int realtimeDepth = 0;
+static thread_local bool reporting = false;
+
+static std::atomic<long long> violations[RealtimeCheck::NUM_VIOLATIONS];
+static std::atomic<bool> abortOnViolation(false);
+
+static const char* const VIOLATION_NAMES[RealtimeCheck::NUM_VIOLATIONS] = {
+    "allocation", "deallocation", "mutex lock"
+};
+
+RealtimeScope::RealtimeScope() {
+    realtimeDepth++;
+}
+
+RealtimeScope::~RealtimeScope() {
+    realtimeDepth--;
+}
+
+bool RealtimeCheck::isRealtimeThread() {
+    return realtimeDepth > 0;
+}
+
+void RealtimeCheck::setAbortOnViolation(bool enabled) {
+    abortOnViolation.store(enabled);
+}
+
+long long RealtimeCheck::getViolations(Violation kind) {
+    return violations[kind].load();
+}
+
+long long RealtimeCheck::getTotalViolations() {
+    long long total = 0;
+    for (int k = 0; k < NUM_VIOLATIONS; k++) total += violations[k].load();
+    return total;
+}
+
+void RealtimeCheck::resetViolations() {
+    for (int k = 0; k < NUM_VIOLATIONS; k++) violations[k].store(0);
+}
+
+const char* RealtimeCheck::getViolationName(Violation kind) {
+    return kind >= 0 && kind < NUM_VIOLATIONS ? VIOLATION_NAMES[kind] : "unknown";
+}
+
+void RealtimeCheck::report(Violation kind) {
+    // Whatever the report itself does must not count again
+    if (realtimeDepth == 0 || reporting) return;
+    violations[kind].fetch_add(1, std::memory_order_relaxed);
+    if (abortOnViolation.load(std::memory_order_relaxed)) {
+        reporting = true;
+        std::fprintf(stderr, "Real-time violation: %s on an audio thread\n", VIOLATION_NAMES[kind]);
+        std::abort();
+    }
+}
+
+// Allocation underneath the interceptors
+#if defined(EQ_INTERCEPT_LIBC)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+static void* rawAllocate(size_t size) { return __libc_malloc(size); }
+static void* rawAllocateAligned(size_t size, size_t alignment) { return __libc_memalign(alignment, size); }
+static void rawFree(void* pointer) { __libc_free(pointer); }
+static void rawFreeAligned(void* pointer) { __libc_free(pointer); }
+#elif defined(_WIN32)
+#include <malloc.h>
+
+static void* rawAllocate(size_t size) { return std::malloc(size); }
+static void* rawAllocateAligned(size_t size, size_t alignment) { return _aligned_malloc(size, alignment); }
+static void rawFree(void* pointer) { std::free(pointer); }
+static void rawFreeAligned(void* pointer) { _aligned_free(pointer); }
+#else
+static void* rawAllocate(size_t size) { return std::malloc(size); }
+static void* rawAllocateAligned(size_t size, size_t alignment) {
+    void* pointer = nullptr;
+    return posix_memalign(&pointer, alignment, size) == 0 ? pointer : nullptr;
+}
+static void rawFree(void* pointer) { std::free(pointer); }
+static void rawFreeAligned(void* pointer) { std::free(pointer); }
+#endif
+
+static inline void check(RealtimeCheck::Violation kind) {
+    if (realtimeDepth > 0) RealtimeCheck::report(kind);
+}
+
+static void* allocate(size_t size, size_t alignment, bool aligned) {
+    check(RealtimeCheck::ALLOCATION);
+    if (size == 0) size = 1;
+    void* pointer = aligned ? rawAllocateAligned(size, alignment) : rawAllocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+static void release(void* pointer, bool aligned) {
+    if (!pointer) return;
+    check(RealtimeCheck::DEALLOCATION);
+    if (aligned) {
+        rawFreeAligned(pointer);
+    } else {
+        rawFree(pointer);
+    }
+}
+
+// operator new/delete: every replaceable form
+void* operator new(size_t size) { return allocate(size, 0, false); }
+void* operator new[](size_t size) { return allocate(size, 0, false); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocate(size, (size_t)alignment, true); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocate(size, (size_t)alignment, true); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    check(RealtimeCheck::ALLOCATION);
+    return rawAllocate(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    check(RealtimeCheck::ALLOCATION);
+    return rawAllocate(size ? size : 1);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    check(RealtimeCheck::ALLOCATION);
+    return rawAllocateAligned(size ? size : 1, (size_t)alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    check(RealtimeCheck::ALLOCATION);
+    return rawAllocateAligned(size ? size : 1, (size_t)alignment);
+}
+
+void operator delete(void* pointer) noexcept { release(pointer, false); }
+void operator delete[](void* pointer) noexcept { release(pointer, false); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer, false); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer, false); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer, false); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer, false); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release(pointer, true); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release(pointer, true); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { release(pointer, true); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { release(pointer, true); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release(pointer, true); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release(pointer, true); }
+
+#if defined(EQ_INTERCEPT_LIBC)
+// The C allocator and mutex locks, interposed by symbol: definitions in
+// the executable take precedence over libc's
+extern "C" {
+
+void* malloc(size_t size) {
+    check(RealtimeCheck::ALLOCATION);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    check(RealtimeCheck::ALLOCATION);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    check(RealtimeCheck::ALLOCATION);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) {
+    if (pointer) check(RealtimeCheck::DEALLOCATION);
+    __libc_free(pointer);
+}
+
+typedef int (*MutexLock)(pthread_mutex_t*);
+
+// Resolved before main; a lock taken earlier is looked up on the spot
+static MutexLock realMutexLock = (MutexLock)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    check(RealtimeCheck::LOCK);
+    if (!realMutexLock) realMutexLock = (MutexLock)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+    return realMutexLock(mutex);
+}
+
+}
+#endif
+
+#endif // EQ_REALTIME_CHECK
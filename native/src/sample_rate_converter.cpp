@@ -0,0 +1,297 @@
+#include "sample_rate_converter.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef SimdLanes<float>::Quad FloatQuad;
+
+// Per quality tier: taps at a ratio of 1 or more (scaled up by the
+// decimation factor when downsampling), Kaiser beta and the row grid used
+// for ratios without an exact phase table
+struct QualityTier {
+    int taps;
+    double beta;
+    int interpolatedRows;
+    const char* name;
+};
+
+static const QualityTier TIERS[] = {
+    { 16, 6.0, 64, "fast" },
+    { 64, 9.6, 256, "medium" },
+    { 128, 12.3, 512, "best" }
+};
+
+static const int FRAC_BITS = 32;                // Interpolated position resolution
+
+// Zeroth-order modified Bessel function of the first kind (Kaiser window)
+static double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 64 && term > sum * 1e-16; k++) {
+        double half = x / (2.0 * k);
+        term *= half * half;
+        sum += term;
+    }
+    return sum;
+}
+
+static long long greatestCommonDivisor(long long a, long long b) {
+    while (b) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Dot product of numTaps coefficients with one channel's history
+static inline float dot(const float* h, const float* x, int numTaps) {
+    typedef FloatQuad S;
+    S::Vec a0 = S::set1(0.0f), a1 = S::set1(0.0f);
+    for (int k = 0; k < numTaps; k += 2 * S::WIDTH) {
+        a0 = S::add(a0, S::mul(S::load(h + k), S::load(x + k)));
+        a1 = S::add(a1, S::mul(S::load(h + k + S::WIDTH), S::load(x + k + S::WIDTH)));
+    }
+    return S::sum(S::add(a0, a1));
+}
+
+// Both channels of a stereo frame, sharing the coefficient loads
+static inline void dotStereo(const float* h, const float* l, const float* r, int numTaps,
+                             float& left, float& right) {
+    typedef FloatQuad S;
+    S::Vec l0 = S::set1(0.0f), l1 = S::set1(0.0f), r0 = S::set1(0.0f), r1 = S::set1(0.0f);
+    for (int k = 0; k < numTaps; k += 2 * S::WIDTH) {
+        S::Vec h0 = S::load(h + k), h1 = S::load(h + k + S::WIDTH);
+        l0 = S::add(l0, S::mul(h0, S::load(l + k)));
+        l1 = S::add(l1, S::mul(h1, S::load(l + k + S::WIDTH)));
+        r0 = S::add(r0, S::mul(h0, S::load(r + k)));
+        r1 = S::add(r1, S::mul(h1, S::load(r + k + S::WIDTH)));
+    }
+    left = S::sum(S::add(l0, l1));
+    right = S::sum(S::add(r0, r1));
+}
+
+SampleRateConverter::SampleRateConverter()
+    : inputRate(44100.0), outputRate(44100.0), numChannels(2), quality(QUALITY_MEDIUM),
+      numTaps(0), exact(true), denominator(1), stepWhole(1), stepFrac(0), phaseShift(0),
+      phaseScale(0.0f), historyStride(0), held(0), frac(0), clearRequested(false) {
+    prepare(inputRate, outputRate, numChannels, quality);
+}
+
+SampleRateConverter::~SampleRateConverter() {
+}
+
+bool SampleRateConverter::isSupported(double inRate, double outRate) {
+    if (!(inRate > 0.0) || !(outRate > 0.0)) return false;
+    double ratio = outRate / inRate;
+    return ratio <= MAX_RATIO && ratio >= 1.0 / MAX_RATIO;
+}
+
+bool SampleRateConverter::prepare(double inRate, double outRate, int channels, Quality q) {
+    if (!isSupported(inRate, outRate) || channels < 1 || channels > MAX_CHANNELS ||
+        q < QUALITY_FAST || q > QUALITY_BEST) {
+        return false;
+    }
+
+    inputRate = inRate;
+    outputRate = outRate;
+    numChannels = channels;
+    quality = q;
+
+    // Whole rates with a small reduced ratio get one row per output phase
+    long long in = std::llround(inRate), out = std::llround(outRate);
+    long long divisor = greatestCommonDivisor(in, out);
+    exact = in == inRate && out == outRate && out / divisor <= MAX_EXACT_PHASES;
+    if (exact) {
+        denominator = out / divisor;
+        stepWhole = (in / divisor) / denominator;
+        stepFrac = (in / divisor) % denominator;
+    } else {
+        long long step = std::llround(inRate / outRate * (double)(1LL << FRAC_BITS));
+        denominator = 1LL << FRAC_BITS;
+        stepWhole = step >> FRAC_BITS;
+        stepFrac = step & (denominator - 1);
+        int rows = TIERS[quality].interpolatedRows;
+        phaseShift = FRAC_BITS;
+        while ((1 << (FRAC_BITS - phaseShift)) < rows) phaseShift--;
+        phaseScale = 1.0f / (float)(1LL << phaseShift);
+    }
+
+    design();
+
+    historyStride = numTaps + CHUNK;
+    history.assign((size_t)historyStride * numChannels, 0.0f);
+    clearRequested.store(false);
+    reset();
+    return true;
+}
+
+void SampleRateConverter::design() {
+    const QualityTier& tier = TIERS[quality];
+
+    // Cutoff at the lower Nyquist frequency, in units of the input's; the
+    // filter stretches by the decimation factor so the transition keeps
+    // its width relative to the output rate
+    double cutoff = std::min(1.0, outputRate / inputRate);
+    numTaps = (int)std::ceil(tier.taps / cutoff);
+    numTaps = (numTaps + 7) & ~7;
+    int half = numTaps / 2;
+
+    int rows = exact ? (int)denominator : tier.interpolatedRows + 1;
+    int grid = exact ? (int)denominator : tier.interpolatedRows;
+    phases.assign((size_t)rows * numTaps, 0.0f);
+    double windowScale = 1.0 / besselI0(tier.beta);
+    std::vector<double> taps(numTaps);
+    for (int r = 0; r < rows; r++) {
+        // Tap k sits t input frames from the output position (which lies
+        // r / grid past tap half - 1); each row is normalised to unity DC
+        double offset = (double)r / grid;
+        double sum = 0.0;
+        for (int k = 0; k < numTaps; k++) {
+            double t = k - (half - 1) - offset;
+            double x = M_PI * cutoff * t;
+            double sinc = x == 0.0 ? 1.0 : std::sin(x) / x;
+            double u = std::min(1.0, std::fabs(t) / half);
+            taps[k] = cutoff * sinc * besselI0(tier.beta * std::sqrt(1.0 - u * u)) * windowScale;
+            sum += taps[k];
+        }
+        for (int k = 0; k < numTaps; k++) {
+            phases[(size_t)r * numTaps + k] = (float)(taps[k] / sum);
+        }
+    }
+
+    if (exact) {
+        deltas.clear();
+        row.clear();
+    } else {
+        deltas.assign((size_t)(rows - 1) * numTaps, 0.0f);
+        for (size_t i = 0; i < deltas.size(); i++) {
+            deltas[i] = phases[i + numTaps] - phases[i];
+        }
+        row.assign(numTaps, 0.0f);
+    }
+}
+
+void SampleRateConverter::clear() {
+    clearRequested.store(true, std::memory_order_release);
+}
+
+void SampleRateConverter::reset() {
+    // Silence ahead of the first frame: the first window is full at once
+    std::fill(history.begin(), history.end(), 0.0f);
+    held = numTaps - 1;
+    frac = 0;
+}
+
+int SampleRateConverter::getMaxOutputFrames(int inputFrames) const {
+    // One output per step from the current position, plus rounding slack
+    double step = stepWhole + (double)stepFrac / denominator;
+    return (int)(inputFrames / step) + 2;
+}
+
+double SampleRateConverter::getLatency() const {
+    return numTaps / 2 * outputRate / inputRate;
+}
+
+int SampleRateConverter::getNumTaps() const {
+    return numTaps;
+}
+
+int SampleRateConverter::getNumChannels() const {
+    return numChannels;
+}
+
+double SampleRateConverter::getInputRate() const {
+    return inputRate;
+}
+
+double SampleRateConverter::getOutputRate() const {
+    return outputRate;
+}
+
+SampleRateConverter::Quality SampleRateConverter::getQuality() const {
+    return quality;
+}
+
+bool SampleRateConverter::isExact() const {
+    return exact;
+}
+
+const char* SampleRateConverter::getQualityName(Quality q) {
+    return q >= QUALITY_FAST && q <= QUALITY_BEST ? TIERS[q].name : "unknown";
+}
+
+int SampleRateConverter::process(const float* input, int numFrames, float* output) {
+    if (clearRequested.load(std::memory_order_acquire)) {
+        clearRequested.store(false, std::memory_order_relaxed);
+        reset();
+    }
+
+    int written = 0;
+    for (int frame = 0; frame < numFrames; frame += CHUNK) {
+        written += processChunk(input + (ptrdiff_t)frame * numChannels, std::min(CHUNK, numFrames - frame),
+                                output + (ptrdiff_t)written * numChannels);
+    }
+    return written;
+}
+
+int SampleRateConverter::processChunk(const float* input, int numFrames, float* output) {
+    typedef FloatQuad S;
+    const int channels = numChannels;
+
+    // New frames go behind the history, one row per channel
+    for (int ch = 0; ch < channels; ch++) {
+        float* dst = &history[(size_t)ch * historyStride + held];
+        for (int i = 0; i < numFrames; i++) dst[i] = input[i * channels + ch];
+    }
+    int available = held + numFrames;
+
+    // Every output whose window is complete. A step never exceeds the
+    // tap count, so index stays within the history.
+    const float* left = &history[0];
+    const float* right = channels > 1 ? &history[historyStride] : left;
+    int index = 0;
+    int written = 0;
+    while (index + numTaps <= available) {
+        const float* coeffs;
+        if (exact) {
+            coeffs = &phases[(size_t)frac * numTaps];
+        } else {
+            size_t r = (size_t)(frac >> phaseShift) * numTaps;
+            S::Vec t = S::set1((float)(frac & ((1LL << phaseShift) - 1)) * phaseScale);
+            for (int k = 0; k < numTaps; k += S::WIDTH) {
+                S::store(&row[k], S::add(S::load(&phases[r + k]), S::mul(t, S::load(&deltas[r + k]))));
+            }
+            coeffs = row.data();
+        }
+
+        float* out = output + (ptrdiff_t)written * channels;
+        if (channels == 2) {
+            dotStereo(coeffs, left + index, right + index, numTaps, out[0], out[1]);
+        } else {
+            for (int ch = 0; ch < channels; ch++) {
+                out[ch] = dot(coeffs, &history[(size_t)ch * historyStride + index], numTaps);
+            }
+        }
+        written++;
+
+        index += (int)stepWhole;
+        frac += stepFrac;
+        if (frac >= denominator) {
+            frac -= denominator;
+            index++;
+        }
+    }
+
+    // Keep what the next window still needs
+    held = available - index;
+    for (int ch = 0; ch < channels; ch++) {
+        float* h = &history[(size_t)ch * historyStride];
+        std::memmove(h, h + index, held * sizeof(float));
+    }
+    return written;
+}
@@ -1,6 +1,9 @@
 #include "system_audio_hook.h"
+#include "denormals.h"
 #include <iostream>
 #include <comdef.h>
+#include <mmreg.h>
+#include <ksmedia.h>
 
 // WASAPI constants
 const CLSID CLSID_MMDeviceEnumerator = __uuidof(MMDeviceEnumerator);
@@ -9,16 +12,33 @@ const IID IID_IAudioClient = __uuidof(IAudioClient);
 const IID IID_IAudioCaptureClient = __uuidof(IAudioCaptureClient);
 const IID IID_IAudioRenderClient = __uuidof(IAudioRenderClient);
 
+// Packet format of a mix format: 32-bit float, or 16/32-bit PCM (24-bit
+// samples arrive left-justified in 32-bit containers)
+static CapturePipeline::SampleFormat sampleFormatOf(const WAVEFORMATEX* format) {
+    bool isFloat = format->wFormatTag == WAVE_FORMAT_IEEE_FLOAT;
+    bool isPcm = format->wFormatTag == WAVE_FORMAT_PCM;
+    if (format->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
+        const WAVEFORMATEXTENSIBLE* extensible = reinterpret_cast<const WAVEFORMATEXTENSIBLE*>(format);
+        isFloat = IsEqualGUID(extensible->SubFormat, KSDATAFORMAT_SUBTYPE_IEEE_FLOAT);
+        isPcm = IsEqualGUID(extensible->SubFormat, KSDATAFORMAT_SUBTYPE_PCM);
+    }
+    
+    if (isFloat && format->wBitsPerSample == 32) return CapturePipeline::FORMAT_FLOAT32;
+    if (isPcm && format->wBitsPerSample == 16) return CapturePipeline::FORMAT_INT16;
+    if (isPcm && format->wBitsPerSample == 32) return CapturePipeline::FORMAT_INT32;
+    return CapturePipeline::FORMAT_UNSUPPORTED;
+}
+
 SystemAudioHook::SystemAudioHook()
     : deviceEnumerator(nullptr), audioDevice(nullptr), audioClient(nullptr),
       captureClient(nullptr), renderClient(nullptr), waveFormat(nullptr),
-      bufferFrameCount(0), capturing(false), enabled(true) {
+      bufferFrameCount(0), capturing(false) {
     
     // Initialize COM
     CoInitializeEx(nullptr, COINIT_MULTITHREADED);
     
     // Create default equalizer
-    equalizer = std::make_shared<Equalizer>(44100.0);
+    setEqualizer(Equalizer::create(Equalizer::DEFAULT_BANDS, 44100.0));
 }
 
 SystemAudioHook::~SystemAudioHook() {
@@ -116,9 +136,20 @@ bool SystemAudioHook::initializeAudioClient() {
         return false;
     }
     
-    // Update equalizer sample rate
-    if (equalizer && waveFormat) {
-        equalizer = std::make_shared<Equalizer>(waveFormat->nSamplesPerSec);
+    // Packets arrive in the mix format; integer formats are converted
+    // through a scratch buffer sized for the largest packet
+    CapturePipeline::SampleFormat format = sampleFormatOf(waveFormat);
+    if (format == CapturePipeline::FORMAT_UNSUPPORTED) {
+        std::cerr << "Unsupported mix format (" << waveFormat->wBitsPerSample
+                  << "-bit): audio passes through unprocessed" << std::endl;
+    }
+    pipeline.setSampleFormat(format, static_cast<int>(bufferFrameCount), waveFormat->nChannels);
+    
+    // Retune the equalizer to the device rate in place: the user's bands
+    // and gains carry over, and nothing is reallocated under the capture
+    // thread
+    if (pipeline.getEqualizer() && waveFormat) {
+        pipeline.getEqualizer()->setSampleRate(waveFormat->nSamplesPerSec);
     }
     
     std::cout << "Audio client initialized - Sample Rate: " << waveFormat->nSamplesPerSec 
@@ -171,6 +202,9 @@ void SystemAudioHook::audioProcessingLoop() {
     UINT32 numFramesAvailable;
     DWORD flags;
     
+    // Decaying filter tails must not slow the capture thread down
+    DenormalGuard denormals;
+    
     while (capturing.load()) {
         // Wait for audio data
         Sleep(1); // 1ms sleep to prevent busy waiting
@@ -191,9 +225,10 @@ void SystemAudioHook::audioProcessingLoop() {
             
             if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
                 // Silent buffer, skip processing
-            } else if (enabled.load() && equalizer && data && numFramesAvailable > 0) {
-                // Process audio through equalizer
-                processAudioBuffer((float*)data, numFramesAvailable, waveFormat->nChannels);
+            } else {
+                // Process the whole packet through the equalizer
+                pipeline.processPacket(data, static_cast<int>(numFramesAvailable),
+                                       waveFormat->nChannels);
             }
             
             // Release the buffer
@@ -207,50 +242,24 @@ void SystemAudioHook::audioProcessingLoop() {
     }
 }
 
-void SystemAudioHook::processAudioBuffer(float* buffer, UINT32 numFrames, int channels) {
-    if (!equalizer || !enabled.load()) return;
-    
-    if (channels == 2) {
-        // Stereo processing
-        for (UINT32 i = 0; i < numFrames; i++) {
-            float left = buffer[i * 2];
-            float right = buffer[i * 2 + 1];
-            
-            // Process through equalizer
-            equalizer->processStereo(&left, &right, 1);
-            
-            // Write back processed audio
-            buffer[i * 2] = left;
-            buffer[i * 2 + 1] = right;
-        }
-    } else if (channels == 1) {
-        // Mono processing
-        for (UINT32 i = 0; i < numFrames; i++) {
-            float sample = buffer[i];
-            equalizer->processStereo(&sample, &sample, 1);
-            buffer[i] = sample;
-        }
-    }
-}
-
 bool SystemAudioHook::isCapturing() const {
     return capturing.load();
 }
 
 Equalizer* SystemAudioHook::getEqualizer() {
-    return equalizer.get();
+    return pipeline.getEqualizer();
 }
 
 void SystemAudioHook::setEqualizer(std::shared_ptr<Equalizer> eq) {
-    equalizer = eq;
+    pipeline.setEqualizer(eq);
 }
 
 void SystemAudioHook::setEnabled(bool en) {
-    enabled.store(en);
+    pipeline.setEnabled(en);
 }
 
 bool SystemAudioHook::isEnabled() const {
-    return enabled.load();
+    return pipeline.isEnabled();
 }
 
 void SystemAudioHook::cleanup() {
@@ -0,0 +1,270 @@
+#include "true_peak_limiter.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef SimdLanes<float>::Quad FloatQuad;
+
+static const double LOOKAHEAD_MS = 1.5;
+static const double DEFAULT_CEILING_DB = -1.0;
+static const double DEFAULT_RELEASE_MS = 50.0;
+
+TruePeakLimiter::TruePeakLimiter()
+    : sampleRate(44100.0), lookahead(MIN_LOOKAHEAD), attack(0), hold(0), latency(MIN_LOOKAHEAD),
+      requestedRate(44100.0), rateRequested(false), ceiling(1.0f), releaseMs((float)DEFAULT_RELEASE_MS), targetGain(1.0f), clearRequested(false),
+      tapBound(1.0f), holdPrefix(1.0f), holdPos(0), boxSum(0.0), boxPos(0), reduction(0.0f), inputGain(1.0f) {
+    setCeiling(DEFAULT_CEILING_DB);
+
+    // Phase p interpolates at (newest - DETECTOR_DELAY) + p / 4 from the
+    // PHASE_TAPS newest samples: Blackman-windowed sinc, unity DC gain
+    double halfWidth = PHASE_TAPS / 2;
+    for (int p = 1; p < PHASES; p++) {
+        double sum = 0.0;
+        double taps[PHASE_TAPS];
+        for (int k = 0; k < PHASE_TAPS; k++) {
+            double x = (PHASE_TAPS - 1 - DETECTOR_DELAY) - k + (double)p / PHASES;
+            double sinc = std::sin(M_PI * x) / (M_PI * x);
+            double window = std::fabs(x) < halfWidth
+                ? 0.42 + 0.5 * std::cos(M_PI * x / halfWidth) + 0.08 * std::cos(2.0 * M_PI * x / halfWidth)
+                : 0.0;
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+        double bound = 0.0;
+        for (int k = 0; k < PHASE_TAPS; k++) {
+            phaseTaps[p - 1][k] = (float)(taps[k] / sum);
+            bound += std::fabs(taps[k] / sum);
+        }
+        tapBound = std::max(tapBound, (float)(bound * 1.0001));
+    }
+
+    prepare(sampleRate);
+}
+
+void TruePeakLimiter::prepare(double sr) {
+    rateRequested.store(false);
+    clearRequested.store(false);
+    configure(sr);
+    reset();
+}
+
+void TruePeakLimiter::setSampleRate(double sr) {
+    if (!(sr > 0.0)) return;
+    latency.store(lookaheadFor(sr), std::memory_order_relaxed);
+    requestedRate.store(sr, std::memory_order_relaxed);
+    rateRequested.store(true, std::memory_order_release);
+}
+
+int TruePeakLimiter::lookaheadFor(double sr) {
+    int frames = (int)std::lround(LOOKAHEAD_MS * 0.001 * sr);
+    return std::max(MIN_LOOKAHEAD, std::min(MAX_LOOKAHEAD, frames));
+}
+
+void TruePeakLimiter::configure(double sr) {
+    sampleRate = sr;
+    lookahead = lookaheadFor(sampleRate);
+    latency.store(lookahead, std::memory_order_relaxed);
+
+    // The gain averages attack frames whose hold windows all cover the
+    // sample leaving the delay line, and the interval before it
+    attack = lookahead - DETECTOR_DELAY + 1;
+    hold = attack + 1;
+}
+
+void TruePeakLimiter::clear() {
+    clearRequested.store(true, std::memory_order_release);
+}
+
+void TruePeakLimiter::restoreDefaults() {
+    setCeiling(DEFAULT_CEILING_DB);
+    setRelease(DEFAULT_RELEASE_MS);
+    setInputGain(1.0);
+    clear();
+}
+
+void TruePeakLimiter::reset() {
+    std::memset(delayLine, 0, sizeof(delayLine));
+    std::memset(required, 0, sizeof(required));
+    std::fill(holdValues, holdValues + MAX_LOOKAHEAD, 1.0f);
+    std::fill(holdSuffix, holdSuffix + MAX_LOOKAHEAD + 1, 1.0f);
+    holdPrefix = 1.0f;
+    holdPos = 0;
+    std::fill(boxValues, boxValues + MAX_LOOKAHEAD, 1.0f);
+    boxSum = attack;
+    boxPos = 0;
+    reduction = 0.0f;
+    inputGain = targetGain.load(std::memory_order_relaxed);
+}
+
+void TruePeakLimiter::setCeiling(double dBTP) {
+    dBTP = std::max(-24.0, std::min(0.0, dBTP));
+    ceiling.store((float)std::pow(10.0, dBTP / 20.0), std::memory_order_relaxed);
+}
+
+void TruePeakLimiter::setRelease(double milliseconds) {
+    releaseMs.store((float)std::max(1.0, std::min(1000.0, milliseconds)), std::memory_order_relaxed);
+}
+
+void TruePeakLimiter::setInputGain(double gain) {
+    targetGain.store((float)std::max(0.0, gain), std::memory_order_relaxed);
+}
+
+double TruePeakLimiter::getCeiling() const {
+    return 20.0 * std::log10(ceiling.load(std::memory_order_relaxed));
+}
+
+double TruePeakLimiter::getInputGain() const {
+    return targetGain.load(std::memory_order_relaxed);
+}
+
+int TruePeakLimiter::getLatency() const {
+    return latency.load(std::memory_order_relaxed);
+}
+
+void TruePeakLimiter::processInterleaved(float* buffer, int numFrames) {
+    process(buffer, buffer + 1, 2, numFrames);
+}
+
+void TruePeakLimiter::processStereo(float* leftChannel, float* rightChannel, int numFrames) {
+    process(leftChannel, rightChannel, 1, numFrames);
+}
+
+void TruePeakLimiter::process(float* left, float* right, int stride, int numFrames) {
+    if (rateRequested.load(std::memory_order_acquire)) {
+        rateRequested.store(false, std::memory_order_relaxed);
+        configure(requestedRate.load(std::memory_order_relaxed));
+        reset();
+    }
+    if (clearRequested.load(std::memory_order_acquire)) {
+        clearRequested.store(false, std::memory_order_relaxed);
+        reset();
+    }
+
+    float decay = (float)std::exp(-1000.0 / (releaseMs.load(std::memory_order_relaxed) * sampleRate));
+    for (int frame = 0; frame < numFrames; frame += CHUNK) {
+        ptrdiff_t at = (ptrdiff_t)frame * stride;
+        processChunk(left + at, right + at, stride, std::min(CHUNK, numFrames - frame), decay);
+    }
+}
+
+void TruePeakLimiter::processChunk(float* left, float* right, int stride, int numFrames, float decay) {
+    float* delayLeft = delayLine[0];
+    float* delayRight = delayLine[1];
+
+    // New frames go behind the lookahead history, with the input gain
+    // ramped across the chunk (exactly 1.0f when there is none)
+    float target = targetGain.load(std::memory_order_relaxed);
+    float step = (target - inputGain) / numFrames;
+    for (int i = 0; i < numFrames; i++) {
+        ptrdiff_t at = (ptrdiff_t)i * stride;
+        float gain = inputGain + step * (i + 1);
+        delayLeft[lookahead + i] = left[at] * gain;
+        delayRight[lookahead + i] = right[at] * gain;
+    }
+    inputGain = target;
+
+    // Nothing to do while the gain is at rest and stays there: an exact
+    // delayed copy (holding and smoothing only ever saw 1.0f)
+    bool atRest = reduction == 0.0f && holdPrefix == 1.0f && holdSuffix[0] == 1.0f && boxSum == attack;
+    if (!detect(numFrames) && atRest) {
+        holdPos = 0;
+        for (int i = 0; i < numFrames; i++) {
+            ptrdiff_t at = (ptrdiff_t)i * stride;
+            left[at] = delayLeft[i];
+            right[at] = delayRight[i];
+        }
+    } else {
+        applyGain(left, right, stride, numFrames, decay);
+    }
+
+    std::memmove(delayLeft, delayLeft + numFrames, lookahead * sizeof(float));
+    std::memmove(delayRight, delayRight + numFrames, lookahead * sizeof(float));
+}
+
+bool TruePeakLimiter::detect(int numFrames) {
+    typedef FloatQuad S;
+    const float* delayLeft = delayLine[0];
+    const float* delayRight = delayLine[1];
+    S::Vec limit = S::set1(ceiling.load(std::memory_order_relaxed));
+
+    // No interpolated value can exceed tapBound times the largest sample
+    // under the taps; below the ceiling every required gain is 1
+    S::Vec loudest = S::set1(0.0f);
+    for (int i = lookahead + 1 - PHASE_TAPS; i < lookahead + numFrames; i += S::WIDTH) {
+        loudest = S::max(loudest, S::max(S::abs(S::load(delayLeft + i)), S::abs(S::load(delayRight + i))));
+    }
+    float lanes[S::WIDTH];
+    S::store(lanes, loudest);
+    float samplePeak = *std::max_element(lanes, lanes + S::WIDTH);
+    if (samplePeak * tapBound <= ceiling.load(std::memory_order_relaxed)) {
+        std::fill(required, required + numFrames, 1.0f);
+        return false;
+    }
+
+    // Required gain per new frame: ceiling / max(true peak, ceiling) for
+    // the sample DETECTOR_DELAY frames back and the interval after it.
+    // Lanes past numFrames read slack and are never used.
+    const int first = 1 - PHASE_TAPS;
+    for (int i = 0; i < numFrames; i += S::WIDTH) {
+        const float* l = delayLeft + lookahead + i;
+        const float* r = delayRight + lookahead + i;
+        S::Vec peak = S::max(S::abs(S::load(l - DETECTOR_DELAY)), S::abs(S::load(r - DETECTOR_DELAY)));
+        for (int p = 0; p < PHASES - 1; p++) {
+            S::Vec yl = S::set1(0.0f), yr = S::set1(0.0f);
+            for (int k = 0; k < PHASE_TAPS; k++) {
+                S::Vec h = S::set1(phaseTaps[p][k]);
+                yl = S::add(yl, S::mul(h, S::load(l + first + k)));
+                yr = S::add(yr, S::mul(h, S::load(r + first + k)));
+            }
+            peak = S::max(peak, S::max(S::abs(yl), S::abs(yr)));
+        }
+        S::store(required + i, S::div(limit, S::max(peak, limit)));
+    }
+    return true;
+}
+
+void TruePeakLimiter::applyGain(float* left, float* right, int stride, int numFrames, float decay) {
+    const float* delayLeft = delayLine[0];
+    const float* delayRight = delayLine[1];
+    double boxScale = 1.0 / attack;
+
+    for (int i = 0; i < numFrames; i++) {
+        // Minimum over the last hold frames: this block's prefix and the
+        // previous block's suffix
+        float needed = required[i];
+        holdValues[holdPos] = needed;
+        holdPrefix = std::min(holdPrefix, needed);
+        float held = std::min(holdPrefix, holdSuffix[holdPos + 1]);
+        if (++holdPos == hold) {
+            for (int k = hold - 1; k >= 0; k--) {
+                holdSuffix[k] = std::min(holdSuffix[k + 1], holdValues[k]);
+            }
+            holdPrefix = 1.0f;
+            holdPos = 0;
+
+            // Re-add the box so rounding never accumulates (and a gain at
+            // rest sums to exactly attack)
+            boxSum = 0.0;
+            for (int k = 0; k < attack; k++) boxSum += boxValues[k];
+        }
+
+        // Instant attack to the held gain, exponential release, then the
+        // box average ramps it in over attack frames (a full box rounds
+        // to exactly 1.0f)
+        reduction = std::max(1.0f - held, reduction * decay);
+        float released = 1.0f - reduction;
+        boxSum += (double)released - boxValues[boxPos];
+        boxValues[boxPos] = released;
+        if (++boxPos == attack) boxPos = 0;
+        float gain = (float)(boxSum * boxScale);
+
+        ptrdiff_t at = (ptrdiff_t)i * stride;
+        left[at] = delayLeft[i] * gain;
+        right[at] = delayRight[i] * gain;
+    }
+}
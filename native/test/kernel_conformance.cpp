@@ -0,0 +1,436 @@
+/**
+ * Kernel conformance check
+ * Runs every DSP kernel variant this CPU supports against the scalar
+ * reference on the same signals - noise, overloaded tones, denormals,
+ * infinities and NaN - and fails if any output, or the cascade history
+ * left behind, is further from the reference than the kernel's error
+ * bound. The bounds are all zero: variants are built without FMA
+ * contraction and must match the reference bit for bit.
+ * Build: node-gyp rebuild (target kernel_conformance), run:
+ * build/Release/kernel_conformance
+ */
+
+#include "dsp_kernels.h"
+#include "biquad_filter.h"
+#include "equalizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef DspKernels DK;
+
+// Allowed distance from the reference, per kernel family
+static const double CASCADE_BOUND = 0.0;
+static const double CONVERT_BOUND = 0.0;
+static const double CLAMP_BOUND = 0.0;
+
+// Block lengths that leave every vector tail length behind, and one
+// long enough for the unrolled loops
+static const int BLOCK_LENGTHS[] = { 1, 2, 3, 7, 16, 37, 333, 1024 };
+static const int NUM_BLOCK_LENGTHS = sizeof(BLOCK_LENGTHS) / sizeof(BLOCK_LENGTHS[0]);
+
+class Random {
+public:
+    explicit Random(uint32_t seed) : state(seed) {}
+
+    uint32_t next() {
+        state = state * 1103515245u + 12345u;
+        return state;
+    }
+
+    // Uniform in [lo, hi)
+    double uniform(double lo, double hi) {
+        return lo + (hi - lo) * (next() >> 8) / 16777216.0;
+    }
+
+private:
+    uint32_t state;
+};
+
+// 0 for identical bits, the difference for finite values, infinity when
+// only one side is NaN or infinite
+static double distance(double a, double b) {
+    if (std::memcmp(&a, &b, sizeof(double)) == 0) return 0.0;
+    if (std::isnan(a) && std::isnan(b)) return 0.0;
+    if (!std::isfinite(a) || !std::isfinite(b)) return INFINITY;
+    return std::fabs(a - b);
+}
+
+static double distance(float a, float b) {
+    if (std::memcmp(&a, &b, sizeof(float)) == 0) return 0.0;
+    return distance((double)a, (double)b);
+}
+
+template <typename T>
+static double maxDistance(const std::vector<T>& a, const std::vector<T>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        worst = std::max(worst, distance(a[i], b[i]));
+    }
+    return worst;
+}
+
+static double maxDistance(const std::vector<int32_t>& a, const std::vector<int32_t>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        worst = std::max(worst, std::fabs((double)a[i] - (double)b[i]));
+    }
+    return worst;
+}
+
+static double maxDistance(const std::vector<int16_t>& a, const std::vector<int16_t>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        worst = std::max(worst, std::fabs((double)a[i] - (double)b[i]));
+    }
+    return worst;
+}
+
+// Test signal: noise with a loud tone that overloads the boosted designs,
+// a run of denormals, and silence at the end
+static std::vector<float> makeSignal(int length, int channel, uint32_t seed) {
+    Random random(seed + channel * 7919u);
+    std::vector<float> signal(length);
+    for (int i = 0; i < length; i++) {
+        double tone = 1.5 * std::sin(2.0 * M_PI * (110.0 + 40.0 * channel) * i / 48000.0);
+        double noise = random.uniform(-0.5, 0.5);
+        signal[i] = (float)(i % 512 < 256 ? noise : tone + noise);
+        if (i % 1000 >= 900) signal[i] = (float)(random.uniform(-1.0, 1.0) * 1e-39);
+    }
+    for (int i = std::max(0, length - 64); i < length; i++) signal[i] = 0.0f;
+    return signal;
+}
+
+// Stable random designs - peaking, shelves, passes and notches across
+// the band, some with large boosts
+template <typename T>
+static std::vector<T> makeCoefficients(int numSections, Random& random) {
+    static const BiquadFilter::FilterType types[] = {
+        BiquadFilter::PEAKING, BiquadFilter::LOWSHELF, BiquadFilter::HIGHSHELF,
+        BiquadFilter::LOWPASS, BiquadFilter::HIGHPASS, BiquadFilter::NOTCH
+    };
+
+    std::vector<T> coefficients(numSections * 5);
+    for (int s = 0; s < numSections; s++) {
+        BiquadFilter::Design design;
+        design.type = types[random.next() % 6];
+        design.sampleRate = 48000.0;
+        design.frequency = 20.0 * std::pow(1000.0, random.uniform(0.0, 1.0));
+        design.gainDB = random.uniform(-18.0, 18.0);
+        design.Q = random.uniform(0.3, 8.0);
+        BiquadFilter::Coefficients c = BiquadFilter::calculateCoefficients(design);
+        T* out = &coefficients[s * 5];
+        out[0] = (T)c.b0;
+        out[1] = (T)c.b1;
+        out[2] = (T)c.b2;
+        out[3] = (T)c.a1;
+        out[4] = (T)c.a2;
+    }
+    return coefficients;
+}
+
+/**
+ * One cascade run through a variant
+ * Holds the history and output buffers for one table; run() feeds the
+ * signal block by block in the given layout, carrying history across
+ * blocks as the equalizers do.
+ */
+template <typename T>
+class CascadeRun {
+public:
+    std::vector<float> output;      // Channel-major, numChannels * length
+    std::vector<T> history;
+
+    CascadeRun(const DK::Table& table, DK::Layout layout, int fixed, int numSections,
+               int numChannels, T limit)
+        : history((DK::MAX_SECTIONS + 1) * 2 * DK::MAX_CHANNELS, (T)0),
+          table(table), layout(layout), fixed(fixed), numSections(numSections),
+          numChannels(numChannels), limit(limit) {}
+
+    void run(const std::vector<T>& coefficients, const std::vector<std::vector<float> >& signal) {
+        int length = (int)signal[0].size();
+        int stride = layout == DK::SPLIT ? numChannels + 1 : numChannels;
+        output.assign(numChannels * length, 0.0f);
+
+        std::vector<float> frames;
+        std::vector<float*> outputs(numChannels);
+        std::vector<const float*> inputs(numChannels);
+
+        int offset = 0;
+        for (int b = 0; offset < length; b++) {
+            int count = std::min(BLOCK_LENGTHS[b % NUM_BLOCK_LENGTHS], length - offset);
+
+            DK::CascadeArgs<T> args;
+            args.coefficients = coefficients.data();
+            args.numSections = numSections;
+            args.history = history.data();
+            args.limit = limit;
+            args.numChannels = numChannels;
+            args.numSamples = count;
+            args.input = nullptr;
+            args.output = nullptr;
+            args.frames = nullptr;
+            args.frameStride = stride;
+
+            if (layout == DK::PLANAR) {
+                for (int ch = 0; ch < numChannels; ch++) {
+                    inputs[ch] = &signal[ch][offset];
+                    outputs[ch] = &output[ch * length + offset];
+                }
+                args.input = inputs.data();
+                args.output = outputs.data();
+            } else {
+                // SPLIT reads one channel more than it filters
+                frames.assign(count * stride, 0.0f);
+                for (int i = 0; i < count; i++) {
+                    for (int ch = 0; ch < stride; ch++) {
+                        frames[i * stride + ch] = signal[ch % numChannels][offset + i] * (ch < numChannels ? 1.0f : -1.0f);
+                    }
+                }
+                args.frames = frames.data();
+                if (layout == DK::SPLIT) {
+                    for (int ch = 0; ch < numChannels; ch++) outputs[ch] = &output[ch * length + offset];
+                    args.output = outputs.data();
+                }
+            }
+
+            kernels(T())->run[layout][fixed](args);
+
+            if (layout == DK::INTERLEAVED) {
+                for (int i = 0; i < count; i++) {
+                    for (int ch = 0; ch < numChannels; ch++) {
+                        output[ch * length + offset + i] = frames[i * stride + ch];
+                    }
+                }
+            }
+            offset += count;
+        }
+    }
+
+private:
+    const DK::Table& table;
+    DK::Layout layout;
+    int fixed;
+    int numSections;
+    int numChannels;
+    T limit;
+
+    const DK::CascadeKernels<float>* kernels(float) const { return &table.cascadeFloat; }
+    const DK::CascadeKernels<double>* kernels(double) const { return &table.cascadeDouble; }
+};
+
+// Every layout, unrolled section count and channel count, with and
+// without the clamp engaged
+template <typename T>
+static double checkCascade(const DK::Table& variant, const DK::Table& reference) {
+    static const DK::Layout layouts[] = { DK::PLANAR, DK::INTERLEAVED, DK::SPLIT };
+    static const int RUNTIME_SECTIONS[] = { 1, 7, 13 };
+    static const T limits[] = { (T)1, std::numeric_limits<T>::max() };
+
+    const int length = 2400;
+    double worst = 0.0;
+    Random random(12345);
+
+    for (int fixed = 0; fixed < DK::NUM_FIXED; fixed++) {
+        int numSections = fixed ? DK::FIXED_SECTIONS[fixed] : RUNTIME_SECTIONS[random.next() % 3];
+        std::vector<T> coefficients = makeCoefficients<T>(numSections, random);
+
+        for (int numChannels = 1; numChannels <= DK::MAX_CHANNELS; numChannels++) {
+            std::vector<std::vector<float> > signal(numChannels);
+            for (int ch = 0; ch < numChannels; ch++) signal[ch] = makeSignal(length, ch, numSections);
+
+            for (DK::Layout layout : layouts) {
+                for (T limit : limits) {
+                    CascadeRun<T> expected(reference, layout, fixed, numSections, numChannels, limit);
+                    CascadeRun<T> actual(variant, layout, fixed, numSections, numChannels, limit);
+                    expected.run(coefficients, signal);
+                    actual.run(coefficients, signal);
+                    worst = std::max(worst, maxDistance(actual.output, expected.output));
+                    worst = std::max(worst, maxDistance(actual.history, expected.history));
+                }
+            }
+        }
+    }
+    return worst;
+}
+
+// Values where conversions go wrong: full scale and just past it,
+// rounding ties, denormals, infinities and NaN, then noise
+static std::vector<float> makeConversionInput() {
+    std::vector<float> input = {
+        0.0f, -0.0f, 1.0f, -1.0f, 0.99999994f, -0.99999994f, 1.0000001f, -1.0000001f,
+        1.5f, -1.5f, 2.0f, -2.0f, 1e10f, -1e10f, FLT_MAX, -FLT_MAX, FLT_MIN, -FLT_MIN,
+        1e-40f, -1e-40f, INFINITY, -INFINITY, NAN, -NAN,
+        0.5f / 32768.0f, 1.5f / 32768.0f, -0.5f / 32768.0f, -2.5f / 32768.0f,
+        32766.5f / 32768.0f, -32767.5f / 32768.0f, 0.5f / 2147483648.0f, 65.5f / 2147483648.0f
+    };
+    Random random(99);
+    while (input.size() < 4099) input.push_back((float)random.uniform(-1.25, 1.25));
+    return input;
+}
+
+// Every length up to two of the widest vector plus a tail, then the lot
+static std::vector<int> conversionLengths(int total) {
+    std::vector<int> lengths;
+    for (int n = 0; n <= 40; n++) lengths.push_back(n);
+    lengths.push_back(total);
+    return lengths;
+}
+
+static double checkConversions(const DK::Table& variant, const DK::Table& reference) {
+    std::vector<float> input = makeConversionInput();
+    int total = (int)input.size();
+
+    std::vector<int16_t> pcm16(total);
+    std::vector<int32_t> pcm32(total);
+    Random random(7);
+    for (int i = 0; i < total; i++) {
+        uint32_t bits = random.next();
+        pcm16[i] = (int16_t)(i < 4 ? (i % 2 ? -32768 : 32767) : (int16_t)(bits >> 16));
+        pcm32[i] = i < 4 ? (i % 2 ? INT32_MIN : INT32_MAX) : (int32_t)bits;
+    }
+
+    double worst = 0.0;
+    for (int n : conversionLengths(total)) {
+        // Offset by one so the aligned and unaligned paths both run
+        int start = n < total ? 1 : 0;
+        n = std::min(n, total - start);
+
+        std::vector<int16_t> expected16(n), actual16(n);
+        reference.floatToInt16(&input[start], expected16.data(), n);
+        variant.floatToInt16(&input[start], actual16.data(), n);
+        worst = std::max(worst, maxDistance(actual16, expected16));
+
+        std::vector<int32_t> expected32(n), actual32(n);
+        reference.floatToInt32(&input[start], expected32.data(), n);
+        variant.floatToInt32(&input[start], actual32.data(), n);
+        worst = std::max(worst, maxDistance(actual32, expected32));
+
+        std::vector<float> expected(n), actual(n);
+        reference.int16ToFloat(&pcm16[start], expected.data(), n);
+        variant.int16ToFloat(&pcm16[start], actual.data(), n);
+        worst = std::max(worst, maxDistance(actual, expected));
+
+        reference.int32ToFloat(&pcm32[start], expected.data(), n);
+        variant.int32ToFloat(&pcm32[start], actual.data(), n);
+        worst = std::max(worst, maxDistance(actual, expected));
+    }
+    return worst;
+}
+
+static double checkInterleaveClamp(const DK::Table& variant, const DK::Table& reference) {
+    std::vector<float> left = makeConversionInput();
+    std::vector<float> right(left.rbegin(), left.rend());
+    int total = (int)left.size();
+    static const float limits[] = { 1.0f, 0.5f, FLT_MAX };
+
+    double worst = 0.0;
+    for (float limit : limits) {
+        for (int n : conversionLengths(total)) {
+            int start = n < total ? 3 : 0;
+            n = std::min(n, total - start);
+            std::vector<float> expected(n * 2), actual(n * 2);
+            reference.interleaveClamp(&left[start], &right[start], expected.data(), n, limit);
+            variant.interleaveClamp(&left[start], &right[start], actual.data(), n, limit);
+            worst = std::max(worst, maxDistance(actual, expected));
+        }
+    }
+    return worst;
+}
+
+// A 31-band equalizer on 7.1 through the dispatch, against the same
+// equalizer with the scalar variant active
+static double checkEqualizer(DK::Isa isa) {
+    const int frames = 4096, channels = 8;
+    std::vector<float> source(frames * channels);
+    for (int ch = 0; ch < channels; ch++) {
+        std::vector<float> signal = makeSignal(frames, ch, 31);
+        for (int i = 0; i < frames; i++) source[i * channels + ch] = signal[i];
+    }
+
+    std::vector<float> results[2];
+    DK::Isa isas[2] = { DK::SCALAR, isa };
+    for (int r = 0; r < 2; r++) {
+        DK::setActiveIsa(isas[r]);
+        std::unique_ptr<Equalizer> eq = Equalizer::create(31, 48000.0);
+        eq->applyPreset(3);
+        results[r] = source;
+        for (int offset = 0, b = 0; offset < frames; b++) {
+            int count = std::min(BLOCK_LENGTHS[b % NUM_BLOCK_LENGTHS], frames - offset);
+            eq->processInterleaved(&results[r][offset * channels], channels, count);
+            offset += count;
+        }
+    }
+    return maxDistance(results[1], results[0]);
+}
+
+static bool report(const char* kernel, double error, double bound) {
+    bool ok = error <= bound;
+    std::printf("    %-26s max error %-10g bound %-6g %s\n", kernel, error, bound, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// The load-time choice: the widest supported variant, or EQ_KERNEL_ISA
+// when it names a supported one
+static bool checkDispatch(DK::Isa chosen) {
+    const char* requested = std::getenv("EQ_KERNEL_ISA");
+    DK::Isa expected = DK::detectIsa();
+    DK::Isa parsed;
+    if (requested && DK::parseIsa(requested, parsed) && DK::isSupported(parsed)) expected = parsed;
+
+    bool ok = chosen == expected;
+    std::printf("  detected %s, EQ_KERNEL_ISA=%s, chosen at load %s  %s\n",
+                DK::getIsaName(DK::detectIsa()), requested ? requested : "(unset)",
+                DK::getIsaName(chosen), ok ? "ok" : "FAILED");
+
+    for (int isa = 0; isa < DK::NUM_ISAS; isa++) {
+        bool roundTrip = DK::parseIsa(DK::getIsaName((DK::Isa)isa), parsed) && parsed == isa;
+        bool switched = DK::setActiveIsa((DK::Isa)isa) == DK::isSupported((DK::Isa)isa);
+        if (!roundTrip || !switched) {
+            std::printf("  %s: name or switch FAILED\n", DK::getIsaName((DK::Isa)isa));
+            ok = false;
+        }
+    }
+    DK::setActiveIsa(chosen);
+    return ok;
+}
+
+int main() {
+    DK::Isa chosen = DK::getActiveIsa();
+    const DK::Table& reference = DK::getReference();
+
+    std::printf("DSP kernel conformance\n\nDispatch:\n");
+    bool ok = checkDispatch(chosen);
+
+    std::printf("\nVariants against the scalar reference:\n");
+    for (int i = 0; i < DK::NUM_ISAS; i++) {
+        DK::Isa isa = (DK::Isa)i;
+        const DK::Table* variant = DK::getVariant(isa);
+        if (!variant) {
+            std::printf("  %s: skipped (not built or not supported here)\n", DK::getIsaName(isa));
+            continue;
+        }
+
+        std::printf("  %s:\n", DK::getIsaName(isa));
+        ok = report("cascade float", checkCascade<float>(*variant, reference), CASCADE_BOUND) && ok;
+        ok = report("cascade double", checkCascade<double>(*variant, reference), CASCADE_BOUND) && ok;
+        ok = report("format conversion", checkConversions(*variant, reference), CONVERT_BOUND) && ok;
+        ok = report("interleave and clamp", checkInterleaveClamp(*variant, reference), CLAMP_BOUND) && ok;
+        ok = report("31-band equalizer, 7.1", checkEqualizer(isa), CASCADE_BOUND) && ok;
+    }
+    DK::setActiveIsa(chosen);
+
+    std::printf("\n%s\n", ok ? "All variants conform" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+/**
+ * Real-time safety check for the audio paths
+ * Runs AudioProcessor, the equalizers and the capture pipeline on a
+ * simulated device thread inside a RealtimeScope while a control thread
+ * changes every parameter it can, and fails if the device thread
+ * allocated, freed or took a mutex.
+ * Build: node-gyp rebuild (target realtime_check, compiled with
+ * EQ_REALTIME_CHECK), run: build/Release/realtime_check [--abort]
+ */
+
+#include "realtime_check.h"
+#include "audio_processor.h"
+#include "capture_pipeline.h"
+#include "equalizer.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const int RUN_PACKETS = 3000;
+
+/**
+ * Simulated capture/render device
+ * A thread that hands interleaved packets of irregular size (as WASAPI
+ * does) to a callback, with the buffers allocated before it starts. The
+ * control thread runs its own loop until the device has delivered
+ * RUN_PACKETS packets.
+ */
+class SimulatedDevice {
+public:
+    typedef std::function<void(float* buffer, int numFrames)> Callback;
+
+    SimulatedDevice(double sampleRate, int numChannels, int maxFrames)
+        : sampleRate(sampleRate), numChannels(numChannels), maxFrames(maxFrames),
+          buffer((size_t)maxFrames * numChannels), packets(0), phase(0.0) {}
+
+    int getNumChannels() const { return numChannels; }
+    int getPackets() const { return packets.load(); }
+
+    // Run callback on the device thread while control runs here
+    void run(Callback callback, std::function<void(int step)> control) {
+        std::thread device([&] {
+            for (int p = 0; p < RUN_PACKETS; p++) {
+                // 10 ms packets with jitter, and the odd tiny one
+                int frames = (int)(sampleRate / 100) + (p * 37) % 97 - 48;
+                if (p % 50 == 7) frames = 1 + p % 5;
+                frames = std::max(1, std::min(maxFrames, frames));
+                fill(frames);
+                callback(buffer.data(), frames);
+                packets.store(p + 1);
+            }
+        });
+        for (int step = 0; packets.load() < RUN_PACKETS; step++) {
+            control(step);
+            std::this_thread::yield();
+        }
+        device.join();
+    }
+
+private:
+    double sampleRate;
+    int numChannels;
+    int maxFrames;
+    std::vector<float> buffer;
+    std::atomic<int> packets;
+    double phase;
+
+    // Two tones loud enough to drive the limiter and compressor
+    void fill(int frames) {
+        for (int i = 0; i < frames; i++) {
+            float x = (float)(0.6 * std::sin(phase) + 0.4 * std::sin(7.3 * phase));
+            for (int ch = 0; ch < numChannels; ch++) buffer[(size_t)i * numChannels + ch] = x;
+            phase += 2.0 * M_PI * 220.0 / sampleRate;
+        }
+    }
+};
+
+static bool report(const char* scenario, int packets) {
+    long long total = RealtimeCheck::getTotalViolations();
+    std::printf("  %-36s %6d packets  %4lld alloc  %4lld free  %4lld lock  %s\n", scenario, packets,
+                RealtimeCheck::getViolations(RealtimeCheck::ALLOCATION),
+                RealtimeCheck::getViolations(RealtimeCheck::DEALLOCATION),
+                RealtimeCheck::getViolations(RealtimeCheck::LOCK), total ? "VIOLATION" : "ok");
+    RealtimeCheck::resetViolations();
+    return total == 0;
+}
+
+// The checker itself: a scope must catch each kind
+static bool checkInterceptors() {
+    bool ok = true;
+    std::mutex mutex;
+    {
+        RealtimeScope realtime;
+        int* volatile value = new int(1);
+        delete value;
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    const RealtimeCheck::Violation kinds[3] = { RealtimeCheck::ALLOCATION, RealtimeCheck::DEALLOCATION,
+                                                RealtimeCheck::LOCK };
+    for (RealtimeCheck::Violation kind : kinds) {
+        bool caught = RealtimeCheck::getViolations(kind) > 0;
+        std::printf("  interceptor: %-23s %s\n", RealtimeCheck::getViolationName(kind),
+                    caught ? "caught" : "NOT CAUGHT");
+        ok = ok && caught;
+    }
+
+    // Outside a scope nothing counts
+    RealtimeCheck::resetViolations();
+    std::vector<float> scratch(1024);
+    std::lock_guard<std::mutex> lock(mutex);
+    bool quiet = RealtimeCheck::getTotalViolations() == 0;
+    std::printf("  interceptor: %-23s %s\n", "outside a scope", quiet ? "ignored" : "COUNTED");
+    return ok && quiet;
+}
+
+// Every AudioProcessor stage on, with the control thread editing the EQ,
+// scheduling automation, switching stages and moving the rate under it
+static bool checkProcessor() {
+    const int MAX_FRAMES = 2048;
+    AudioProcessor processor;
+    processor.initialize(48000.0, 512);
+    processor.applyEQPreset("rock");
+    processor.setEQSmoothingTime(20.0);
+    processor.useLinearPhaseEQ(2048);
+    processor.setStage(AudioProcessor::STAGE_EQ);
+    processor.setCompressorEnabled(true);
+    processor.setLimiterEnabled(true);
+
+    bool ok = true;
+    const char* names[3] = { "AudioProcessor interleaved", "AudioProcessor separate channels",
+                             "AudioProcessor stream 44.1k -> 96k" };
+    for (int mode = 0; mode < 3; mode++) {
+        if (mode == 2) processor.setStreamRates(44100.0, 96000.0);
+        SimulatedDevice device(48000.0, 2, MAX_FRAMES / 2);
+        std::vector<float> left(MAX_FRAMES), right(MAX_FRAMES), output(MAX_FRAMES * 8);
+
+        device.run([&](float* buffer, int frames) {
+            if (mode == 0) {
+                processor.processInterleavedStereo(buffer, frames * 2);
+            } else if (mode == 1) {
+                for (int i = 0; i < frames; i++) {
+                    left[i] = buffer[i * 2];
+                    right[i] = buffer[i * 2 + 1];
+                }
+                processor.processSeparateChannels(left.data(), right.data(), frames);
+            } else {
+                processor.processStream(buffer, frames, output.data());
+            }
+        }, [&](int step) {
+            switch (step % 12) {
+                case 0: processor.setEQBandGain(step % 10, (step % 25) - 12.0); break;
+                case 1: processor.applyEQPreset(step % 5); break;
+                case 2: processor.morphEQPresets(1, 3, (step % 10) / 10.0, 50.0); break;
+                case 3: {
+                    AutomationEvent event = { processor.getFramePosition() + 300, AutomationEvent::BAND_GAIN,
+                                              step % 10, 6.0 };
+                    processor.scheduleAutomation(event);
+                    event.type = AutomationEvent::PRESET;
+                    event.value = step % 12;
+                    event.frame += 200;
+                    processor.scheduleAutomation(event);
+                    break;
+                }
+                case 4: processor.setStage((AudioProcessor::Stage)(step / 12 % 3)); break;
+                case 5: processor.setCompressorEnabled(step / 12 % 2 == 0); break;
+                case 6: processor.setLimiterEnabled(step / 12 % 3 != 0); break;
+                case 7: processor.setLimiterCeiling(-(step % 6)); break;
+                case 8: processor.setEQEnabled(step / 12 % 4 != 0); break;
+                case 9: if (step % 120 == 9) processor.reconfigure(step / 120 % 2 ? 44100.0 : 48000.0); break;
+                case 10: processor.setCompressorBands(3 + step / 12 % 3); break;
+                case 11:
+                    if (step % 240 == 11) processor.useLinearPhaseEQ(2048);
+                    else if (step % 120 == 11) processor.setConvolutionLatency(step / 240 % 2 ? 128 : 512);
+                    break;
+            }
+        });
+        ok = report(names[mode], device.getPackets()) && ok;
+    }
+    return ok;
+}
+
+// Graphic and parametric equalizers on their own, multichannel
+static bool checkEqualizers() {
+    bool ok = true;
+    const int LAYOUTS[3] = { 10, 31, Equalizer::PARAMETRIC };
+    const char* names[3] = { "Equalizer 10-band, 5.1", "Equalizer 31-band, 5.1", "Equalizer parametric, 5.1" };
+    for (int l = 0; l < 3; l++) {
+        std::unique_ptr<Equalizer> eq = Equalizer::create(LAYOUTS[l], 48000.0);
+        SimulatedDevice device(48000.0, 6, 1024);
+        device.run([&](float* buffer, int frames) {
+            RealtimeScope realtime;
+            eq->processInterleaved(buffer, device.getNumChannels(), frames);
+        }, [&](int step) {
+            switch (step % 6) {
+                case 0: eq->setBandGain(step % eq->getNumBands(), (step % 25) - 12.0); break;
+                case 1: eq->morphToPreset(step % 12, 30.0); break;
+                case 2: {
+                    BiquadFilter::Design design;
+                    design.type = BiquadFilter::PEAKING;
+                    design.frequency = 100.0 + (step % 50) * 200.0;
+                    design.gainDB = 6.0;
+                    if (eq->addBand(design) < 0) eq->removeBand(0);
+                    break;
+                }
+                case 3: eq->setEnabled(step / 6 % 5 != 0); break;
+                case 4: if (step % 60 == 4) eq->setSampleRate(step / 60 % 2 ? 44100.0 : 48000.0); break;
+                case 5: eq->setSmoothingTime(step % 40); break;
+            }
+        });
+        ok = report(names[l], device.getPackets()) && ok;
+    }
+    return ok;
+}
+
+// The system hook's packet path: equalizers swapped and retuned under it
+static bool checkCapture() {
+    CapturePipeline pipeline;
+    pipeline.setEqualizer(Equalizer::create(Equalizer::DEFAULT_BANDS, 48000.0));
+    SimulatedDevice device(48000.0, 8, 1024);
+    device.run([&](float* buffer, int frames) {
+        pipeline.processPacket(buffer, frames, device.getNumChannels());
+    }, [&](int step) {
+        switch (step % 4) {
+            case 0: pipeline.getEqualizer()->applyPreset(step % 12); break;
+            case 1: pipeline.setEnabled(step / 4 % 5 != 0); break;
+            case 2: if (step % 80 == 2) pipeline.setEqualizer(Equalizer::create(step / 80 % 2 ? 31 : 10, 48000.0)); break;
+            case 3: if (step % 40 == 3) pipeline.getEqualizer()->setSampleRate(step / 40 % 2 ? 44100.0 : 48000.0); break;
+        }
+    });
+    return report("CapturePipeline 7.1", device.getPackets());
+}
+
+// 16-bit PCM mix format: the conversion runs through preallocated scratch
+static bool checkCapturePcm() {
+    const int maxFrames = 1024, channels = 2;
+    CapturePipeline pipeline;
+    pipeline.setEqualizer(Equalizer::create(Equalizer::DEFAULT_BANDS, 48000.0));
+    pipeline.setSampleFormat(CapturePipeline::FORMAT_INT16, maxFrames, channels);
+    std::vector<int16_t> packet(maxFrames * channels);
+    SimulatedDevice device(48000.0, channels, maxFrames);
+    device.run([&](float* buffer, int frames) {
+        for (int i = 0; i < frames * channels; i++) packet[i] = (int16_t)(buffer[i] * 32767.0f);
+        pipeline.processPacket(packet.data(), frames, channels);
+    }, [&](int step) {
+        switch (step % 2) {
+            case 0: pipeline.getEqualizer()->applyPreset(step % 12); break;
+            case 1: pipeline.setEnabled(step / 2 % 5 != 0); break;
+        }
+    });
+    return report("CapturePipeline 16-bit PCM", device.getPackets());
+}
+
+int main(int argc, char** argv) {
+    bool abortMode = argc > 1 && std::strcmp(argv[1], "--abort") == 0;
+
+    std::printf("Real-time safety check (%s on violation)\n\n", abortMode ? "abort" : "count");
+    std::printf("Checker:\n");
+    bool ok = checkInterceptors();
+    RealtimeCheck::resetViolations();
+    RealtimeCheck::setAbortOnViolation(abortMode);
+
+    std::printf("\nAudio threads:\n");
+    ok = checkProcessor() && ok;
+    ok = checkEqualizers() && ok;
+    ok = checkCapture() && ok;
+    ok = checkCapturePcm() && ok;
+
+    std::printf("\n%s\n", ok ? "No real-time violations" : "FAILED");
+    return ok ? 0 : 1;
+}
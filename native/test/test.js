@@ -7,6 +7,7 @@ const path = require('path');
 
 console.log('🧪 Testing Native Equalizer Module\n');
 
+(async () => {
 try {
   // Load the native module
   const modulePath = path.join(__dirname, '..', 'build', 'Release', 'audio_equalizer.node');
@@ -82,6 +83,437 @@ try {
   console.log(`Input samples: ${bufferSize * 2}`);
   console.log(`Result: ✅ PASS\n`);
 
+  // Test 8: Buffers longer than the configured max block size
+  console.log('Test 8: Process buffer larger than max block size');
+  eq.initialize(44100, 256);
+  eq.setBandGain(0, 6.0);
+  const longFrames = 4096;
+  const longBuffer = new Float32Array(longFrames * 2);
+  for (let i = 0; i < longFrames; i++) {
+    const sample = 0.5 * Math.sin(2 * Math.PI * 100 * i / 44100);
+    longBuffer[i * 2] = sample;
+    longBuffer[i * 2 + 1] = sample;
+  }
+  eq.processBuffer(longBuffer);
+  const allFinite = longBuffer.every(s => Number.isFinite(s) && Math.abs(s) <= 1.0);
+  // Both channels carry the same signal, so they must stay identical
+  let channelsMatch = true;
+  for (let i = 0; i < longFrames; i++) {
+    if (longBuffer[i * 2] !== longBuffer[i * 2 + 1]) channelsMatch = false;
+  }
+  console.log(`Frames: ${longFrames}, max block: 256`);
+  console.log(`Result: ${allFinite && channelsMatch ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 9: Gain changes ramp instead of jumping
+  console.log('Test 9: Smoothed gain change');
+  eq.initialize(44100);
+  eq.setSmoothingTime(20);
+  const rampFrames = 4096;
+  const rampBuffer = new Float32Array(rampFrames * 2);
+  for (let i = 0; i < rampFrames; i++) {
+    // Nyquist tone, fully inside the 16k high shelf
+    const sample = (i % 2) ? -0.2 : 0.2;
+    rampBuffer[i * 2] = sample;
+    rampBuffer[i * 2 + 1] = sample;
+  }
+  eq.processBuffer(rampBuffer.subarray(0, 2048));
+  eq.setBandGain(9, 12.0);
+  eq.processBuffer(rampBuffer.subarray(2048));
+  // Without smoothing the envelope jumps by ~0.22 in one sample
+  let maxStep = 0;
+  for (let i = 1; i < rampFrames; i++) {
+    const step = Math.abs(Math.abs(rampBuffer[i * 2]) - Math.abs(rampBuffer[(i - 1) * 2]));
+    maxStep = Math.max(maxStep, step);
+  }
+  console.log(`Largest envelope step: ${maxStep.toFixed(4)}`);
+  console.log(`Result: ${maxStep < 0.05 ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 10: Band layout chosen at initialize
+  console.log('Test 10: 5 and 31 band layouts');
+  eq.initialize(44100, 4096, 31);
+  const isoBands = eq.getBandFrequencies();
+  eq.applyPreset('rock');
+  const layoutBuffer = new Float32Array(1024).map((_, i) => 0.5 * Math.sin(i / 10));
+  eq.processBuffer(layoutBuffer);
+  const layoutFinite = layoutBuffer.every(s => Number.isFinite(s));
+  eq.initialize(44100, 4096, 5);
+  const fiveBands = eq.getBandFrequencies();
+  let rejected = false;
+  try {
+    eq.initialize(44100, 4096, 7);
+  } catch (e) {
+    rejected = true;
+  }
+  eq.initialize(44100);
+  console.log(`Bands: ${isoBands.length} and ${fiveBands.length}, 7 rejected: ${rejected}`);
+  const layoutsOk = isoBands.length === 31 && fiveBands.length === 5 && rejected && layoutFinite;
+  console.log(`Result: ${layoutsOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 11: Parametric EQ band editing
+  console.log('Test 11: Parametric add/remove bands');
+  eq.initialize(44100, 4096, 'parametric');
+  eq.setSmoothingTime(0);
+  const lowpass = eq.addBand({ type: 'lowpass', frequency: 2000, q: 0.707 });
+  const toneBuffer = new Float32Array(4096).map((_, i) => 0.5 * Math.sin(Math.PI * 10000 / 44100 * (i >> 1)));
+  eq.processBuffer(toneBuffer);
+  const tonePeak = toneBuffer.subarray(2048).reduce((m, s) => Math.max(m, Math.abs(s)), 0);
+  const bandCount = eq.getBands().length;
+  eq.setBand(lowpass, { frequency: 4000 });
+  const movedBand = eq.getBands()[lowpass];
+  eq.removeBand(lowpass);
+  const bandsAfter = eq.getBands().length;
+  eq.initialize(44100);
+  const graphicAdd = eq.addBand({ type: 'peaking', frequency: 1000, gain: 3 });
+  console.log(`Bands: ${bandCount} -> ${bandsAfter}, 10 kHz peak through 2 kHz low-pass: ${tonePeak.toFixed(4)}`);
+  const parametricOk = lowpass === 10 && bandCount === 11 && bandsAfter === 10 && tonePeak < 0.05 &&
+                       movedBand.type === 'lowpass' && movedBand.frequency === 4000 && graphicAdd === -1;
+  console.log(`Result: ${parametricOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 12: A flat EQ passes audio through untouched
+  console.log('Test 12: Flat bypass');
+  eq.applyPreset('rock');
+  eq.processBuffer(new Float32Array(4096));
+  eq.applyPreset('flat');
+  eq.processBuffer(new Float32Array(8192));  // Let the bands ramp back to 0 dB
+  const dryBuffer = new Float32Array(2048).map((_, i) => 0.8 * Math.sin(i / 7));
+  const bypassBuffer = Float32Array.from(dryBuffer);
+  eq.processBuffer(bypassBuffer);
+  const untouched = bypassBuffer.every((s, i) => s === dryBuffer[i]);
+  console.log(`Output identical to input: ${untouched}`);
+  console.log(`Result: ${untouched ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 13: Filter tails are flushed once a track ends in silence
+  console.log('Test 13: Silence after a track');
+  eq.applyPreset('bass_boost');
+  const trackBuffer = new Float32Array(8192).map((_, i) => 0.5 * Math.sin(i / 40));
+  eq.processBuffer(trackBuffer);
+  const silenceBuffer = new Float32Array(2 * 88200);  // 2 s of digital silence
+  eq.processBuffer(silenceBuffer);
+  const tailEnd = silenceBuffer.subarray(silenceBuffer.length - 4096);
+  const flushed = tailEnd.every(s => s === 0);
+  console.log(`Last 2048 frames exactly zero: ${flushed}`);
+  console.log(`Result: ${flushed ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 14: Automation lands on its exact frame
+  console.log('Test 14: Sample-accurate automation');
+  eq.initialize(44100);
+  eq.setSmoothingTime(0);
+  const start = eq.getFramePosition();
+  const queued = eq.scheduleAutomation([
+    { frame: start + 1000, type: 'gain', band: 5, gain: 12 },
+    { frame: start + 3000, type: 'preset', preset: 'flat' }
+  ]);
+  const automationDry = new Float32Array(8192).map((_, i) => 0.5 * Math.sin(i / 5));
+  const automationBuffer = Float32Array.from(automationDry);
+  eq.processBuffer(automationBuffer);
+  let firstChanged = -1;
+  let lastChanged = -1;
+  for (let i = 0; i < automationBuffer.length; i++) {
+    if (automationBuffer[i] !== automationDry[i]) {
+      if (firstChanged < 0) firstChanged = i >> 1;
+      lastChanged = i >> 1;
+    }
+  }
+  console.log(`Queued ${queued}, filtered frames ${firstChanged}-${lastChanged}, position: ${eq.getFramePosition()}`);
+  const automationOk = queued === 2 && firstChanged === 1000 && lastChanged === 2999 &&
+                       eq.getFramePosition() === start + 4096;
+  console.log(`Result: ${automationOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 15: Preset morphing by ID
+  console.log('Test 15: Preset morph and crossfade');
+  const rockId = eq.getPresetId('rock');
+  const popId = eq.getPresetId('pop');
+  eq.applyPreset(eq.getPresetId('flat'));
+  eq.processBuffer(new Float32Array(1024));
+  eq.morphToPreset(eq.getPresetId('bass_boost'), 200);
+  const morphFrames = 13230;  // 300 ms
+  const morphBuffer = new Float32Array(morphFrames * 2).map((_, i) => 0.25 * Math.sin(2 * Math.PI * 60 * (i >> 1) / 44100));
+  eq.processBuffer(morphBuffer);
+  const morphPeaks = [0, 1, 2, 3, 5].map(k => {
+    let peak = 0;
+    for (let i = k * 2205; i < (k + 1) * 2205; i++) peak = Math.max(peak, Math.abs(morphBuffer[i * 2]));
+    return peak;
+  });
+  const rising = morphPeaks.every((p, k) => k === 0 || p > morphPeaks[k - 1] - 1e-4);
+  eq.morphPresets(rockId, popId, 0.5, 100);
+  const blendGain = eq.getBandGain(0);
+  console.log(`Peak per 50 ms: ${morphPeaks.map(p => p.toFixed(3)).join(', ')}; rock/pop blend band 0: ${blendGain} dB`);
+  const morphOk = rising && morphPeaks[0] < 0.35 && morphPeaks[4] > 0.5 && blendGain === 2 &&
+                  rockId >= 0 && eq.getPresetId('nope') === -1;
+  console.log(`Result: ${morphOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 16: Convolution stage and linear-phase EQ
+  console.log('Test 16: Convolution and linear-phase EQ');
+  eq.initialize(44100);
+  eq.setConvolutionLatency(64);
+  const irLeft = new Float32Array(10000);
+  const irRight = new Float32Array(10000);
+  irLeft[100] = 0.5;
+  irRight[9000] = 0.25;   // Lands in a later partition tier
+  eq.loadImpulseResponse(irLeft, irRight);
+  eq.setProcessingStage('convolution');
+  const convBuffer = new Float32Array(2 * 12000);
+  convBuffer[0] = convBuffer[1] = 1;
+  eq.processBuffer(convBuffer);
+  const leftEcho = convBuffer[2 * (64 + 100)];
+  const rightEcho = convBuffer[2 * (64 + 9000) + 1];
+  const convLatency = eq.getLatency();
+  eq.setProcessingStage('eq');
+  eq.applyPreset('rock');
+  const linearLatency = eq.useLinearPhaseEQ(4096);
+  console.log(`Echoes: left ${leftEcho.toFixed(3)}, right ${rightEcho.toFixed(3)}; latency ${convLatency}, linear-phase ${linearLatency}`);
+  const convOk = Math.abs(leftEcho - 0.5) < 1e-5 && Math.abs(rightEcho - 0.25) < 1e-5 &&
+                 convLatency === 64 && linearLatency === 64 + 2048 && eq.getLatency() === linearLatency;
+  console.log(`Result: ${convOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 17: True-peak limiter instead of the hard clamp
+  console.log('Test 17: True-peak limiter');
+  eq.initialize(44100);
+  eq.applyPreset('bass_boost');
+  const preGain = eq.getPreGain();
+  eq.setAutoPreGain(false);
+  eq.setLimiterEnabled(true);
+  const limiterLatency = eq.getLatency();
+  const loudBuffer = new Float32Array(2 * 44100).map((_, i) => 0.7 * Math.sin(2 * Math.PI * 40 * (i >> 1) / 44100));
+  eq.processBuffer(loudBuffer);
+  const limitedPeak = loudBuffer.reduce((peak, v) => Math.max(peak, Math.abs(v)), 0);
+  eq.setLimiterEnabled(false);
+  console.log(`Peak ${limitedPeak.toFixed(4)} (ceiling 0.8913); lookahead ${limiterLatency} frames; auto pre-gain ${preGain.toFixed(2)} dB`);
+  const limiterOk = limitedPeak <= 0.8913 && limitedPeak > 0.8 && limiterLatency > 0 &&
+                    eq.getLatency() === 0 && preGain < -7;
+  console.log(`Result: ${limiterOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 18: Multiband compressor
+  console.log('Test 18: Multiband compressor');
+  eq.initialize(44100);
+  eq.setCompressorBands(4, [120, 1000, 6000]);
+  for (let band = 0; band < 4; band++) {
+    eq.setCompressorBand(band, { threshold: -24, ratio: 4, attack: 5, release: 100 });
+  }
+  eq.setCompressorEnabled(true);
+  const compressedBuffer = new Float32Array(2 * 44100).map((_, i) => 0.5 * Math.sin(2 * Math.PI * 700 * (i >> 1) / 44100));
+  eq.processBuffer(compressedBuffer);
+  const compressedPeak = compressedBuffer.subarray(44100).reduce((peak, v) => Math.max(peak, Math.abs(v)), 0);
+  const reductions = eq.getCompressorGainReduction();
+  eq.setCompressorEnabled(false);
+  console.log(`Peak ${compressedPeak.toFixed(4)} (input 0.5000); gain reduction ${reductions.map(r => r.toFixed(1)).join(' / ')} dB`);
+  const compressorOk = reductions.length === 4 && reductions[1] < -6 && compressedPeak < 0.25;
+  console.log(`Result: ${compressorOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 19: Sample-rate conversion around the chain
+  console.log('Test 19: Sample-rate conversion');
+  eq.initialize(44100);
+  const ratesOk = eq.setStreamRates(48000, 96000, 'best');
+  const source = new Float32Array(2 * 48000).map((_, i) => 0.5 * Math.sin(2 * Math.PI * 1000 * (i >> 1) / 48000));
+  const converted = new Float32Array(2 * 96100);
+  let convertedFrames = 0;
+  for (let frame = 0; frame < 48000; frame += 480) {
+    convertedFrames += eq.processStream(source.subarray(frame * 2, (frame + 480) * 2),
+                                        converted.subarray(convertedFrames * 2));
+  }
+  const convertedPeak = converted.subarray(2 * 48000, 2 * 96000).reduce((peak, v) => Math.max(peak, Math.abs(v)), 0);
+  console.log(`48 kHz -> 44.1 kHz processing -> 96 kHz: ${convertedFrames} frames, peak ${convertedPeak.toFixed(4)}`);
+  let byteOutputThrows = false;
+  try { eq.processStream(source.subarray(0, 960), new Uint8Array(8192)); } catch (e) { byteOutputThrows = e instanceof TypeError; }
+  const resampleOk = ratesOk && Math.abs(convertedFrames - 96000) <= 1 && Math.abs(convertedPeak - 0.5) < 0.01 &&
+                     byteOutputThrows;
+  console.log(`Result: ${resampleOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 20: Reconfigure keeps the settings
+  console.log('Test 20: Reconfigure to a new sample rate');
+  eq.initialize(44100);
+  eq.applyPreset('rock');
+  eq.setBandGain(0, 7);
+  const gainsBefore = [...Array(10).keys()].map(band => eq.getBandGain(band));
+  const reconfigured = eq.reconfigure(48000, 1024);
+  const gainsAfter = [...Array(10).keys()].map(band => eq.getBandGain(band));
+  const retuned = new Float32Array(2 * 4800).map((_, i) => 0.25 * Math.sin(2 * Math.PI * 1000 * (i >> 1) / 48000));
+  eq.processBuffer(retuned);
+  const retunedFinite = retuned.every(v => Number.isFinite(v) && Math.abs(v) <= 1);
+  console.log(`Gains before: ${gainsBefore.join(', ')}`);
+  console.log(`Gains after:  ${gainsAfter.join(', ')}`);
+  const reconfigureOk = reconfigured && gainsAfter.every((gain, band) => gain === gainsBefore[band]) && retunedFinite;
+  console.log(`Result: ${reconfigureOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 21: DSP kernel variant chosen at load
+  console.log('Test 21: DSP kernel variants');
+  const kernels = eq.getDspKernels();
+  console.log(`Active: ${kernels.active} (detected ${kernels.detected}), available: ${kernels.available.join(', ')}`);
+  const requestedIsa = process.env.EQ_KERNEL_ISA;
+  const expectedIsa = kernels.available.includes(requestedIsa) ? requestedIsa : kernels.detected;
+  const kernelsOk = kernels.available.includes('scalar') && kernels.available.includes(kernels.active) &&
+                    kernels.active === expectedIsa;
+  console.log(`Result: ${kernelsOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 22: Independent Processor instances from the pool
+  console.log('Test 22: Processor instances');
+  eq.initialize(44100);
+  eq.applyPreset('flat');
+  const moduleGainBefore = eq.getBandGain(0);
+  const boosted = new eq.Processor(48000);
+  const thirds = new eq.Processor(44100, 1024, 31);
+  boosted.applyPreset('bass_boost');
+  const boostedBuffer = new Float32Array(2 * 4800).map((_, i) => 0.1 * Math.sin(2 * Math.PI * 60 * (i >> 1) / 48000));
+  const thirdsBuffer = new Float32Array(2 * 4410).map((_, i) => 0.1 * Math.sin(2 * Math.PI * 60 * (i >> 1) / 44100));
+  boosted.processBuffer(boostedBuffer);
+  thirds.processBuffer(thirdsBuffer);
+  const boostedPeak = boostedBuffer.subarray(4800).reduce((peak, v) => Math.max(peak, Math.abs(v)), 0);
+  const thirdsPeak = thirdsBuffer.subarray(4410).reduce((peak, v) => Math.max(peak, Math.abs(v)), 0);
+  console.log(`bass_boost instance peak ${boostedPeak.toFixed(4)}, flat 31-band instance peak ${thirdsPeak.toFixed(4)}`);
+  const instancesIndependent = boostedPeak > 0.15 && Math.abs(thirdsPeak - 0.1) < 0.005 &&
+                               thirds.getBandFrequencies().length === 31 && eq.getBandGain(0) === moduleGainBefore;
+  boosted.destroy();
+  thirds.destroy();
+  let destroyedThrows = false;
+  try { boosted.getBandGain(0); } catch (e) { destroyedThrows = true; }
+  const reserved = eq.Processor.reserve(2, 48000);
+  const createStart = process.hrtime.bigint();
+  for (let i = 0; i < 100; i++) {
+    const preview = new eq.Processor(48000);
+    preview.applyPreset('rock');
+    preview.destroy();
+  }
+  const createMicros = Number(process.hrtime.bigint() - createStart) / 1000 / 100;
+  console.log(`Reserved ${reserved}, create + destroy: ${createMicros.toFixed(1)} µs`);
+  const processorOk = instancesIndependent && destroyedThrows && reserved >= 2;
+  console.log(`Result: ${processorOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 23: Workers each get their own processors
+  console.log('Test 23: 8 worker threads in parallel');
+  const { Worker } = require('worker_threads');
+  const workerPresets = ['rock', 'pop', 'jazz', 'classical', 'electronic', 'hiphop', 'bass_boost', 'dance'];
+  const workerSource = `
+    const { workerData } = require('worker_threads');
+    const results = new Float64Array(workerData.results);
+    const done = new Int32Array(workerData.done);
+    try {
+      const eq = require(workerData.modulePath);
+      eq.initialize(48000, 4800);
+      eq.applyPreset(workerData.preset);
+      const start = Date.now();
+      const block = new Float32Array(2 * 4800);
+      for (let pass = 0; pass < 200; pass++) {
+        block.set(workerData.input);
+        eq.processBuffer(block);
+      }
+      results[workerData.index * 2] = block.reduce((sum, v) => sum + v * v, 0);
+      results[workerData.index * 2 + 1] = Date.now() - start;
+    } catch (e) {
+      results[workerData.index * 2] = NaN;
+    }
+    Atomics.add(done, 0, 1);
+    Atomics.notify(done, 0);
+  `;
+  const workerInput = new Float32Array(2 * 4800).map((_, i) => 0.2 * Math.sin(2 * Math.PI * (100 + 50 * (i & 1)) * (i >> 1) / 48000));
+  const workerResults = new SharedArrayBuffer(8 * 2 * workerPresets.length);
+  const workersDone = new SharedArrayBuffer(4);
+  eq.initialize(44100);
+  eq.applyPreset('vocal_boost');
+  const mainGains = [...Array(10).keys()].map(band => eq.getBandGain(band));
+  const workerStart = Date.now();
+  const workers = workerPresets.map((preset, index) => new Worker(workerSource, {
+    eval: true,
+    workerData: { modulePath, preset, index, input: workerInput, results: workerResults, done: workersDone }
+  }));
+  const doneCount = new Int32Array(workersDone);
+  for (let finished = 0; finished < workers.length && Date.now() - workerStart < 60000; ) {
+    Atomics.wait(doneCount, 0, finished, 1000);
+    finished = Atomics.load(doneCount, 0);
+  }
+  const workerWall = Date.now() - workerStart;
+  workers.forEach(worker => worker.terminate());
+  // Each worker must match the same preset run alone on this thread
+  const workerEnergy = new Float64Array(workerResults);
+  const workersMatch = workerPresets.every((preset, index) => {
+    const reference = new eq.Processor(48000, 4800);
+    reference.applyPreset(preset);
+    const block = new Float32Array(2 * 4800);
+    for (let pass = 0; pass < 200; pass++) {
+      block.set(workerInput);
+      reference.processBuffer(block);
+    }
+    reference.destroy();
+    return block.reduce((sum, v) => sum + v * v, 0) === workerEnergy[index * 2];
+  });
+  const workerBusy = workerPresets.reduce((sum, _, index) => sum + workerEnergy[index * 2 + 1], 0);
+  console.log(`${doneCount[0]} workers finished: ${workerWall} ms wall, ${workerBusy} ms processing in total`);
+  const workersOk = doneCount[0] === workers.length && workersMatch &&
+                    mainGains.every((gain, band) => eq.getBandGain(band) === gain);
+  console.log(`Result: ${workersOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 24: Processing off the JS thread
+  console.log('Test 24: processBufferAsync');
+  const syncProcessor = new eq.Processor(48000);
+  const asyncProcessor = new eq.Processor(48000);
+  syncProcessor.applyPreset('rock');
+  asyncProcessor.applyPreset('rock');
+  const render = new Float32Array(2 * 480000).map((_, i) => 0.3 * Math.sin(2 * Math.PI * 440 * (i >> 1) / 48000));
+  const renderExpected = render.slice();
+  syncProcessor.processBuffer(renderExpected);
+  const renderPromise = asyncProcessor.processBufferAsync(render);
+  let byteBufferThrows = false;
+  try { await asyncProcessor.processBufferAsync(new Uint8Array(4096)); } catch (e) { byteBufferThrows = e instanceof TypeError; }
+  try { syncProcessor.processBuffer(new Uint8Array(4096)); byteBufferThrows = false; } catch (e) {
+    byteBufferThrows = byteBufferThrows && e instanceof TypeError;
+  }
+  let busyThrows = false;
+  try { asyncProcessor.processBuffer(new Float32Array(2)); } catch (e) { busyThrows = true; }
+  const rendered = await renderPromise;
+  const asyncMatches = rendered === render && render.every((v, i) => v === renderExpected[i]);
+  const relayoutRender = asyncProcessor.processBufferAsync(render);
+  const longImpulse = new Float32Array(16384);
+  longImpulse[0] = 1;
+  let relayoutOk = false;
+  try {
+    relayoutOk = asyncProcessor.setConvolutionLatency(128) !== false &&
+                 asyncProcessor.loadImpulseResponse(longImpulse) !== false &&
+                 asyncProcessor.useLinearPhaseEQ(4096) > 0;
+    relayoutOk = (await relayoutRender) === render && relayoutOk;
+  } catch (e) { relayoutOk = false; }
+  const longRender = asyncProcessor.processBufferAsync(new Float32Array(2 * 4800000));
+  const cancelRequested = asyncProcessor.cancelProcessing();
+  let cancelRejected = false;
+  try { await longRender; } catch (e) { cancelRejected = /cancelled/.test(e.message); }
+  syncProcessor.destroy();
+  asyncProcessor.destroy();
+  console.log(`10 s render matches processBuffer: ${asyncMatches}, busy while pending: ${busyThrows}, ` +
+              `byte buffer rejected: ${byteBufferThrows}, ` +
+              `convolution re-laid out while pending: ${relayoutOk}, cancel rejects: ${cancelRequested && cancelRejected}`);
+  const asyncOk = asyncMatches && byteBufferThrows && busyThrows && relayoutOk && cancelRequested && cancelRejected;
+  console.log(`Result: ${asyncOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
+  // Test 25: Batch of clips across cores
+  console.log('Test 25: processBatch');
+  const batchPresets = ['rock', 'pop', 'jazz', 'dance'].map(name => eq.getPresetId(name));
+  const batchClips = [...Array(32).keys()].map(clip =>
+    new Float32Array(2 * (22050 + 1000 * clip)).map((_, i) => 0.25 * Math.sin(2 * Math.PI * (80 + 40 * clip) * (i >> 1) / 44100)));
+  const batchJobs = batchClips.map((clip, index) => index % 4 === 3
+    ? { buffer: clip.slice(), gains: [6, 4, 2, 0, -2, -2, 0, 2, 4, 6] }
+    : { buffer: clip.slice(), presetId: batchPresets[index % 4] });
+  const batchStart = process.hrtime.bigint();
+  // Two batches at once share the pool; each resolves with its own jobs
+  const batchHalves = [batchJobs.slice(0, 16), batchJobs.slice(16)];
+  const batchResults = await Promise.all(batchHalves.map(half => eq.processBatch(half, { sampleRate: 44100 })));
+  const batchMs = Number(process.hrtime.bigint() - batchStart) / 1e6;
+  // Each clip must match a new processor with the same setting
+  const batchMatches = batchJobs.every((job, index) => {
+    const single = new eq.Processor(44100);
+    single.setSmoothingTime(0);
+    if (job.gains) single.morphToCurve(job.gains, 0); else single.applyPreset(job.presetId);
+    const expected = batchClips[index].slice();
+    single.processBuffer(expected);
+    single.destroy();
+    return job.buffer.every((v, i) => v === expected[i]);
+  });
+  let overlapThrows = false;
+  try { eq.processBatch([{ buffer: batchClips[0], presetId: 0 }, { buffer: batchClips[0].subarray(2), presetId: 1 }]); } catch (e) { overlapThrows = true; }
+  let byteJobThrows = false;
+  try { eq.processBatch([{ buffer: new Uint8Array(4096), presetId: 0 }]); } catch (e) { byteJobThrows = e instanceof TypeError; }
+  console.log(`${batchJobs.length} clips in two batches in ${batchMs.toFixed(1)} ms, matching single processors: ${batchMatches}`);
+  const batchOk = batchResults.every((result, half) => result === batchHalves[half]) && batchMatches && overlapThrows &&
+                  byteJobThrows;
+  console.log(`Result: ${batchOk ? '✅ PASS' : '❌ FAIL'}\n`);
+
   // Summary
   console.log('═══════════════════════════════════');
   console.log('🎉 All tests completed successfully!');
@@ -99,3 +531,4 @@ try {
   console.error('  npm run build');
   process.exit(1);
 }
+})();